@@ -0,0 +1,133 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// AppIdMgr over a synthetic vrserver.txt in the scratch Steam tree. Arg: log
+// size in MB. FullScan is the first GetSteamAppIDs() of a session; the Poll
+// runs are the per-tick tail read once caught up.
+
+#include "bench_support.h"
+#include "vrto3dlib/app_id_mgr.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace {
+
+using vrto3d::bench::ScratchRoot;
+
+std::string LogPath()
+{
+    return (ScratchRoot() / "logs" / "vrserver.txt").string();
+}
+
+// One vrserver-style line; every 64th an app launch (a few of them
+// excluded system apps), the rest settings/driver chatter.
+std::string LogLine(vrto3d::bench::XorShift& rng, uint64_t n)
+{
+    std::string line = "Tue Oct 14 2026 12:";
+    line += std::to_string(10 + (n / 60000) % 50) + ":" + std::to_string(10 + (n / 1000) % 50) +
+            "." + std::to_string(100 + n % 900) + " - ";
+    if (n % 64 == 0) {
+        const uint32_t app = rng.Below(40);
+        line += "[Info] - SetApplicationPid: appkey=";
+        line += app == 0 ? "system.systemui" : "steam.app." + std::to_string(200000 + app * 1379);
+        line += "   pid=" + std::to_string(1000 + rng.Below(30000));
+    } else {
+        static const char* const kChatter[] = {
+            "[Info] - [Settings] Setting steamvr/motionSmoothing to false",
+            "[Info] - driver_vrto3d: HMD pose update dropped (no compositor)",
+            "[Info] - Controller 1 battery 87%, tracking result Running_OK",
+            "[Warning] - Unable to read property Prop_DisplayFrequency_Float; using 90",
+            "[Info] - [Compositor] Frame timing: app 4.31ms, compositor 1.12ms",
+        };
+        line += kChatter[rng.Below(5)];
+    }
+    line += '\n';
+    return line;
+}
+
+// Rewrite vrserver.txt to `mb` megabytes unless it already is that file.
+int64_t g_log_mb = -1;
+
+void EnsureLog(int64_t mb)
+{
+    if (g_log_mb == mb) return;
+    vrto3d::bench::XorShift rng;
+    std::ofstream out(LogPath(), std::ios::binary | std::ios::trunc);
+    const uint64_t target = static_cast<uint64_t>(mb) << 20;
+    uint64_t written = 0;
+    for (uint64_t n = 0; written < target; ++n) {
+        const std::string line = LogLine(rng, n);
+        out.write(line.data(), static_cast<std::streamsize>(line.size()));
+        written += line.size();
+    }
+    g_log_mb = mb;
+}
+
+void BM_AppIdFullScan(benchmark::State& state)
+{
+    EnsureLog(state.range(0));
+    size_t keys = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto mgr = std::make_unique<AppIdMgr>();
+        state.ResumeTiming();
+        keys = mgr->GetSteamAppIDs().size();
+    }
+    state.SetBytesProcessed(state.iterations() * (state.range(0) << 20));
+    state.counters["keys"] = static_cast<double>(keys);
+}
+BENCHMARK(BM_AppIdFullScan)->ArgName("mb")->Arg(1)->Arg(4)->Arg(16)->Unit(benchmark::kMillisecond);
+
+// Caught up, nothing new: the steady-state cost of polling.
+void BM_AppIdPollIdle(benchmark::State& state)
+{
+    EnsureLog(state.range(0));
+    AppIdMgr mgr;
+    mgr.GetSteamAppIDs();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(mgr.GetNewSteamAppIDs());
+    }
+}
+BENCHMARK(BM_AppIdPollIdle)->ArgName("mb")->Arg(1)->Arg(16)->Unit(benchmark::kMicrosecond);
+
+// One line appended per poll, an app launch every 64th.
+void BM_AppIdPollAppend(benchmark::State& state)
+{
+    EnsureLog(state.range(0));
+    AppIdMgr mgr;
+    mgr.GetSteamAppIDs();
+    vrto3d::bench::XorShift rng;
+    std::ofstream out(LogPath(), std::ios::binary | std::ios::app);
+    g_log_mb = -1;  // grown below; the next EnsureLog rewrites it
+    uint64_t n = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        const std::string line = LogLine(rng, n++);
+        out.write(line.data(), static_cast<std::streamsize>(line.size()));
+        out.flush();
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(mgr.GetNewSteamAppIDs());
+    }
+}
+BENCHMARK(BM_AppIdPollAppend)->ArgName("mb")->Arg(1)->Unit(benchmark::kMicrosecond);
+
+}  // namespace
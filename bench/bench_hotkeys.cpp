@@ -0,0 +1,186 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ApplyUserSettingsHotkeysImpl over 1-64 user_settings rows. Args: rows,
+// active (0 = every frame idle, 1 = row 0's key pressed/released on
+// alternate frames), and for the InputFrame overload whether the rows were
+// compiled into cfg.hotkey_table.
+
+#include "vrto3dlib/hotkey_eval.hpp"
+#include "vrto3dlib/input_state.h"
+#include "vrto3dlib/key_codes.h"
+#include "vrto3dlib/stereo_config.h"
+
+#include <benchmark/benchmark.h>
+
+#include <bitset>
+#include <cstdint>
+
+namespace {
+
+struct Display {
+    float depth = 0.4f;
+    float convergence = 4.0f;
+    float fov = 90.0f;
+    uint32_t applied = 0;
+
+    float getDepth() const { return depth; }
+    float getConv() const { return convergence; }
+    float getFov() const { return fov; }
+    void setDepth(float v) { depth = v; }
+    void setConv(float v) { convergence = v; }
+    void setFov(float v) { fov = v; }
+    void onApplied() { ++applied; }
+};
+
+vrto3d::DepthConvBackend FnPtrBackend(Display& d)
+{
+    vrto3d::DepthConvBackend b;
+    b.getDepth = [](void* c) { return static_cast<Display*>(c)->getDepth(); };
+    b.getConv = [](void* c) { return static_cast<Display*>(c)->getConv(); };
+    b.setDepth = [](void* c, float v) { static_cast<Display*>(c)->setDepth(v); };
+    b.setConv = [](void* c, float v) { static_cast<Display*>(c)->setConv(v); };
+    b.getFov = [](void* c) { return static_cast<Display*>(c)->getFov(); };
+    b.setFov = [](void* c, float v) { static_cast<Display*>(c)->setFov(v); };
+    b.onApplied = [](void* c) { static_cast<Display*>(c)->onApplied(); };
+    b.ctx = &d;
+    return b;
+}
+
+// Distinct binds for up to 64 rows: letters, digits, F1-F24, numpad. Every
+// eighth row is a pad button instead; types cycle HOLD / TOGGLE / SWITCH.
+int32_t RowKey(size_t i)
+{
+    if (i < 26) return 'A' + static_cast<int32_t>(i);
+    if (i < 36) return '0' + static_cast<int32_t>(i - 26);
+    if (i < 60) return VK_F1 + static_cast<int32_t>(i - 36);
+    return VK_NUMPAD0 + static_cast<int32_t>(i - 60);
+}
+
+StereoDisplayDriverConfiguration MakeRows(size_t rows)
+{
+    StereoDisplayDriverConfiguration cfg;
+    cfg.sleep_count_max = 0;  // no debounce: every press frame acts
+    cfg.num_user_settings = rows;
+    cfg.user_load_key.resize(rows);
+    cfg.user_load_str.resize(rows);
+    cfg.user_key_type.resize(rows);
+    cfg.user_type_str.resize(rows);
+    cfg.user_depth.resize(rows);
+    cfg.user_convergence.resize(rows);
+    cfg.user_fov.resize(rows);
+    cfg.user_preset_index.assign(rows, 0);
+    cfg.prev_depth.resize(rows);
+    cfg.prev_convergence.resize(rows);
+    cfg.prev_fov.resize(rows);
+    cfg.was_held.resize(rows);
+    cfg.load_xinput.resize(rows);
+    cfg.sleep_count.assign(rows, 0);
+    for (size_t i = 0; i < rows; ++i) {
+        const bool pad = i % 8 == 7;
+        cfg.load_xinput[i] = pad;
+        cfg.user_load_key[i] = pad ? (XINPUT_GAMEPAD_DPAD_UP << ((i / 8) % 4)) : RowKey(i);
+        cfg.user_key_type[i] = i % 3 == 0 ? HOLD : (i % 3 == 1 ? TOGGLE : SWITCH);
+        const float d = 0.1f + 0.01f * static_cast<float>(i);
+        if (cfg.user_key_type[i] == TOGGLE) {
+            cfg.user_depth[i] = { d, d + 0.05f };
+            cfg.user_convergence[i] = { 3.0f, 5.0f };
+            cfg.user_fov[i] = { 0.0f, 0.0f };
+        } else {
+            cfg.user_depth[i] = { d };
+            cfg.user_convergence[i] = { 3.0f };
+            cfg.user_fov[i] = { 0.0f };
+        }
+    }
+    return cfg;
+}
+
+// Frame for iteration `n`: idle, or row 0's key down on odd frames.
+void StepFrame(vrto3d::input::InputFrame& frame, bool active, uint64_t n)
+{
+    if (active) {
+        frame.keys.set(static_cast<size_t>(RowKey(0)), (n & 1) != 0);
+        frame.edge_time_ns = n;
+    }
+}
+
+void SetRowArgs(benchmark::internal::Benchmark* b)
+{
+    b->ArgsProduct({ { 1, 4, 16, 64 }, { 0, 1 } });
+}
+
+// Live-query overload (the Windows polling fallback): is_down per row.
+void BM_HotkeysLive(benchmark::State& state)
+{
+    StereoDisplayDriverConfiguration cfg = MakeRows(static_cast<size_t>(state.range(0)));
+    const bool active = state.range(1) != 0;
+    Display display;
+    const vrto3d::DepthConvBackend b = FnPtrBackend(display);
+    std::bitset<256> keys;
+    uint64_t n = 0;
+    for (auto _ : state) {
+        if (active) keys.set(static_cast<size_t>(RowKey(0)), (++n & 1) != 0);
+        auto msg = vrto3d::ApplyUserSettingsHotkeysImpl(
+            cfg, true, 0, b, [&keys](int vk) { return vk >= 0 && vk < 256 && keys[vk]; });
+        benchmark::DoNotOptimize(msg);
+    }
+    state.counters["applied"] = benchmark::Counter(display.applied, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_HotkeysLive)->ArgNames({ "rows", "active" })->Apply(SetRowArgs);
+
+// InputFrame overload with the function-pointer backend the helpers pass.
+void BM_HotkeysFrame(benchmark::State& state)
+{
+    StereoDisplayDriverConfiguration cfg = MakeRows(static_cast<size_t>(state.range(0)));
+    const bool active = state.range(1) != 0;
+    if (state.range(2) != 0) vrto3d::CompileHotkeyTable(cfg);
+    Display display;
+    const vrto3d::DepthConvBackend b = FnPtrBackend(display);
+    vrto3d::input::InputFrame frame;
+    frame.pad.connected = true;
+    uint64_t n = 0;
+    for (auto _ : state) {
+        StepFrame(frame, active, ++n);
+        auto msg = vrto3d::ApplyUserSettingsHotkeysImpl(cfg, frame, b);
+        benchmark::DoNotOptimize(msg);
+    }
+    state.counters["applied"] = benchmark::Counter(display.applied, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_HotkeysFrame)
+    ->ArgNames({ "rows", "active", "table" })
+    ->ArgsProduct({ { 1, 4, 16, 64 }, { 0, 1 }, { 0, 1 } });
+
+// Compiled table with a concrete backend: direct, inlinable calls.
+void BM_HotkeysFrameDirect(benchmark::State& state)
+{
+    StereoDisplayDriverConfiguration cfg = MakeRows(static_cast<size_t>(state.range(0)));
+    const bool active = state.range(1) != 0;
+    vrto3d::CompileHotkeyTable(cfg);
+    Display display;
+    vrto3d::input::InputFrame frame;
+    frame.pad.connected = true;
+    uint64_t n = 0;
+    for (auto _ : state) {
+        StepFrame(frame, active, ++n);
+        auto msg = vrto3d::ApplyUserSettingsHotkeysImpl(cfg, frame, display);
+        benchmark::DoNotOptimize(msg);
+    }
+    state.counters["applied"] = benchmark::Counter(display.applied, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_HotkeysFrameDirect)->ArgNames({ "rows", "active" })->Apply(SetRowArgs);
+
+}  // namespace
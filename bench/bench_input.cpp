@@ -0,0 +1,309 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Contended reads of the input backend's published state (input_state.h)
+// from 1-4 threads while the reader thread publishes. Arg load=1 feeds it on
+// Linux from two uinput devices — a keyboard/mouse and a pad — at 8 kHz, the
+// rate of a high-polling mouse. They are real devices to the desktop too:
+// the mouse only jitters in place and the only key pressed is F24. Needs
+// write access to /dev/uinput and read access to the /dev/input nodes it
+// creates (the `input` group), else load=1 runs are skipped.
+
+#include "vrto3dlib/input_latency.hpp"
+#include "vrto3dlib/input_state.h"
+#include "vrto3dlib/key_codes.h"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#ifdef __linux__
+#include <cstring>
+#include <fcntl.h>
+#include <linux/uinput.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+namespace input = vrto3d::input;
+
+#ifdef __linux__
+// Two uinput devices and the thread driving them.
+class UinputLoad {
+public:
+    ~UinputLoad()
+    {
+        running_.store(false, std::memory_order_relaxed);
+        if (thread_.joinable()) thread_.join();
+        for (int fd : { keyboard_fd_, pad_fd_ }) {
+            if (fd >= 0) {
+                ioctl(fd, UI_DEV_DESTROY);
+                close(fd);
+            }
+        }
+    }
+
+    bool Create()
+    {
+        keyboard_fd_ = CreateKeyboardMouse();
+        pad_fd_ = CreatePad();
+        if (keyboard_fd_ < 0 || pad_fd_ < 0) return false;
+        thread_ = std::thread([this] { Run(); });
+        return true;
+    }
+
+    uint64_t Events() const { return events_.load(std::memory_order_relaxed); }
+
+private:
+    static int Open()
+    {
+        return open("/dev/uinput", O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+    }
+
+    static bool Finish(int fd, const char* name, uint16_t product)
+    {
+        uinput_setup setup{};
+        setup.id.bustype = BUS_VIRTUAL;
+        setup.id.vendor = 0x1209;  // pid.codes test VID
+        setup.id.product = product;
+        std::strncpy(setup.name, name, UINPUT_MAX_NAME_SIZE - 1);
+        return ioctl(fd, UI_DEV_SETUP, &setup) == 0 && ioctl(fd, UI_DEV_CREATE) == 0;
+    }
+
+    // Advertises A-Z so the backend classifies it as a keyboard, and
+    // BTN_LEFT + REL_X/Y for a mouse.
+    static int CreateKeyboardMouse()
+    {
+        const int fd = Open();
+        if (fd < 0) return -1;
+        bool ok = ioctl(fd, UI_SET_EVBIT, EV_KEY) == 0 && ioctl(fd, UI_SET_EVBIT, EV_REL) == 0;
+        static const int kLetters[] = {
+            KEY_A, KEY_B, KEY_C, KEY_D, KEY_E, KEY_F, KEY_G, KEY_H, KEY_I, KEY_J, KEY_K, KEY_L, KEY_M,
+            KEY_N, KEY_O, KEY_P, KEY_Q, KEY_R, KEY_S, KEY_T, KEY_U, KEY_V, KEY_W, KEY_X, KEY_Y, KEY_Z,
+        };
+        for (int key : kLetters) ok = ok && ioctl(fd, UI_SET_KEYBIT, key) == 0;
+        ok = ok && ioctl(fd, UI_SET_KEYBIT, KEY_F24) == 0 && ioctl(fd, UI_SET_KEYBIT, BTN_LEFT) == 0 &&
+             ioctl(fd, UI_SET_RELBIT, REL_X) == 0 && ioctl(fd, UI_SET_RELBIT, REL_Y) == 0;
+        if (!ok || !Finish(fd, "VRto3D bench keyboard", 0x0001)) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    static int CreatePad()
+    {
+        const int fd = Open();
+        if (fd < 0) return -1;
+        bool ok = ioctl(fd, UI_SET_EVBIT, EV_KEY) == 0 && ioctl(fd, UI_SET_EVBIT, EV_ABS) == 0;
+        for (int key : { BTN_SOUTH, BTN_EAST, BTN_NORTH, BTN_WEST, BTN_TL, BTN_TR }) {
+            ok = ok && ioctl(fd, UI_SET_KEYBIT, key) == 0;
+        }
+        auto axis = [&](int code, int32_t lo, int32_t hi) {
+            uinput_abs_setup abs{};
+            abs.code = static_cast<uint16_t>(code);
+            abs.absinfo.minimum = lo;
+            abs.absinfo.maximum = hi;
+            ok = ok && ioctl(fd, UI_SET_ABSBIT, code) == 0 && ioctl(fd, UI_ABS_SETUP, &abs) == 0;
+        };
+        for (int code : { ABS_X, ABS_Y, ABS_RX, ABS_RY }) axis(code, -32768, 32767);
+        for (int code : { ABS_Z, ABS_RZ }) axis(code, 0, 255);
+        if (!ok || !Finish(fd, "VRto3D bench pad", 0x0002)) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    void Emit(int fd, const input_event* events, size_t n)
+    {
+        if (write(fd, events, n * sizeof(input_event)) > 0) {
+            events_.fetch_add(n, std::memory_order_relaxed);
+        }
+    }
+
+    void Run()
+    {
+        using clock = std::chrono::steady_clock;
+        constexpr auto kPeriod = std::chrono::microseconds(125);
+        auto next = clock::now();
+        for (uint32_t n = 0; running_.load(std::memory_order_relaxed); ++n) {
+            const int step = (n & 1) ? 1 : -1;
+            const input_event mouse[] = {
+                { {}, EV_REL, REL_X, step },
+                { {}, EV_REL, REL_Y, -step },
+                { {}, EV_SYN, SYN_REPORT, 0 },
+            };
+            Emit(keyboard_fd_, mouse, 3);
+            if (n % 64 == 0) {
+                const input_event key[] = {
+                    { {}, EV_KEY, KEY_F24, static_cast<int32_t>((n / 64) & 1) },
+                    { {}, EV_SYN, SYN_REPORT, 0 },
+                };
+                Emit(keyboard_fd_, key, 2);
+            }
+            const int32_t sweep = static_cast<int32_t>(n % 512) * 128 - 32768;
+            const input_event pad[] = {
+                { {}, EV_ABS, ABS_X, sweep },
+                { {}, EV_ABS, ABS_RY, -sweep - 1 },
+                { {}, EV_ABS, ABS_RZ, static_cast<int32_t>(n % 256) },
+                { {}, EV_KEY, BTN_SOUTH, static_cast<int32_t>((n / 128) & 1) },
+                { {}, EV_SYN, SYN_REPORT, 0 },
+            };
+            Emit(pad_fd_, pad, 5);
+            next += kPeriod;
+            std::this_thread::sleep_until(next);
+        }
+    }
+
+    int keyboard_fd_ = -1;
+    int pad_fd_ = -1;
+    std::atomic<bool> running_{ true };
+    std::atomic<uint64_t> events_{ 0 };
+    std::thread thread_;
+};
+
+std::unique_ptr<UinputLoad> g_load;
+#endif
+
+const char* g_load_error = nullptr;
+
+// The backend runs from the first input bench until exit: Setup/Teardown
+// fire for every run, including the iteration-count probes.
+void StartBackend()
+{
+    struct Backend {
+        Backend() { input::Start(); }
+        ~Backend() { input::Stop(); }
+    };
+    static Backend backend;
+}
+
+// With load=1 also the uinput devices, waiting until the backend has picked
+// the pad up through hotplug.
+void StartInput(const benchmark::State& state)
+{
+    StartBackend();
+    g_load_error = nullptr;
+    const bool load = state.range(0) != 0;
+#ifdef __linux__
+    if (load) {
+        g_load = std::make_unique<UinputLoad>();
+        if (!g_load->Create()) {
+            g_load.reset();
+            g_load_error = "synthetic load needs write access to /dev/uinput";
+        }
+    }
+#else
+    if (load) g_load_error = "synthetic load needs Linux uinput";
+#endif
+#ifdef __linux__
+    if (g_load) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (input::GetConnectedPads() == 0 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        if (input::GetConnectedPads() == 0) {
+            g_load.reset();
+            g_load_error = "backend did not open the uinput pad (input group?)";
+        }
+    }
+#endif
+}
+
+void StopInput(const benchmark::State&)
+{
+#ifdef __linux__
+    g_load.reset();
+#endif
+}
+
+bool Skipped(benchmark::State& state)
+{
+    if (g_load_error) {
+        state.SkipWithError(g_load_error);
+        return true;
+    }
+    return false;
+}
+
+template <typename Read>
+void RunReads(benchmark::State& state, Read read)
+{
+    if (Skipped(state)) return;
+#ifdef __linux__
+    const uint64_t events_before = g_load ? g_load->Events() : 0;
+#endif
+    for (auto _ : state) {
+        read();
+    }
+#ifdef __linux__
+    if (g_load && state.thread_index() == 0) {
+        state.counters["load_events"] = benchmark::Counter(
+            static_cast<double>(g_load->Events() - events_before), benchmark::Counter::kIsRate);
+    }
+#endif
+}
+
+void BM_InputIsKeyDown(benchmark::State& state)
+{
+    RunReads(state, [] { benchmark::DoNotOptimize(input::IsKeyDown(VK_F24)); });
+}
+
+void BM_InputGamepadState(benchmark::State& state)
+{
+    RunReads(state, [] {
+        const input::GamepadState pad = input::GetGamepadState();
+        benchmark::DoNotOptimize(pad.sThumbLX);
+    });
+}
+
+void BM_InputSnapshot(benchmark::State& state)
+{
+    input::InputFrame frame;
+    RunReads(state, [&frame] {
+        input::Snapshot(frame);
+        benchmark::DoNotOptimize(frame.pad.sThumbLX);
+    });
+}
+
+void BM_InputSamplePad(benchmark::State& state)
+{
+    RunReads(state, [] {
+        const input::GamepadState pad = input::SamplePad(0, input::InputClockNs());
+        benchmark::DoNotOptimize(pad.sThumbLX);
+    });
+}
+
+void SetInputArgs(benchmark::internal::Benchmark* b)
+{
+    b->ArgName("load")->Arg(0)->Arg(1)->Setup(StartInput)->Teardown(StopInput)
+        ->Threads(1)->Threads(2)->Threads(4);
+}
+
+BENCHMARK(BM_InputIsKeyDown)->Apply(SetInputArgs);
+BENCHMARK(BM_InputGamepadState)->Apply(SetInputArgs);
+BENCHMARK(BM_InputSnapshot)->Apply(SetInputArgs);
+BENCHMARK(BM_InputSamplePad)->Apply(SetInputArgs);
+
+}  // namespace
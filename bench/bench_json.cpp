@@ -0,0 +1,123 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// JsonManager::LoadProfileFromJson through each of its tiers:
+//   Cold       the profile's stamp changed: parse, then rewrite the cache
+//   DiskCache  a fresh manager (empty index): decode the .profile.cache file
+//   Warm       same manager again: decode the payload held in the index;
+//              arg watch=1 runs with StartProfileWatch() (trusted index, no stat)
+
+#include "bench_support.h"
+#include "vrto3dlib/json_manager.h"
+#include "vrto3dlib/stereo_config.h"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <system_error>
+
+namespace {
+
+using vrto3d::bench::ScratchRoot;
+
+const std::string kProfile = "VRto3DBench.exe_config.json";
+
+std::filesystem::path ProfilePath()
+{
+    return ScratchRoot() / "config" / "vrto3d" / kProfile;
+}
+
+// default_config.json plus one game profile saved from it, written once.
+bool PrepareProfile()
+{
+    static const bool ok = [] {
+        JsonManager json;
+        json.EnsureDefaultConfigExists();
+        StereoDisplayDriverConfiguration cfg;
+        json.LoadParamsFromJson(cfg);
+        if (!json.LoadProfileFromJson(DEF_CFG, cfg)) return false;
+        cfg.depth = 0.35f;
+        cfg.convergence = 3.5f;
+        return json.SaveProfileToJson(kProfile, cfg).get();
+    }();
+    return ok;
+}
+
+bool PrepareOrSkip(benchmark::State& state)
+{
+    if (!PrepareProfile()) {
+        state.SkipWithError("could not write the bench profile");
+        return false;
+    }
+    return true;
+}
+
+void BM_JsonLoadProfileCold(benchmark::State& state)
+{
+    if (!PrepareOrSkip(state)) return;
+    JsonManager json;
+    StereoDisplayDriverConfiguration cfg;
+    json.LoadParamsFromJson(cfg);
+    const auto base = std::filesystem::last_write_time(ProfilePath());
+    int64_t n = 0;
+    std::error_code ec;
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::filesystem::last_write_time(ProfilePath(), base + std::chrono::seconds(++n), ec);
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(json.LoadProfileFromJson(kProfile, cfg));
+    }
+}
+BENCHMARK(BM_JsonLoadProfileCold)->Unit(benchmark::kMicrosecond);
+
+void BM_JsonLoadProfileDiskCache(benchmark::State& state)
+{
+    if (!PrepareOrSkip(state)) return;
+    StereoDisplayDriverConfiguration cfg;
+    auto json = std::make_unique<JsonManager>();
+    json->LoadParamsFromJson(cfg);
+    json->LoadProfileFromJson(kProfile, cfg);  // current .profile.cache on disk
+    for (auto _ : state) {
+        state.PauseTiming();
+        json = std::make_unique<JsonManager>();
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(json->LoadProfileFromJson(kProfile, cfg));
+    }
+}
+BENCHMARK(BM_JsonLoadProfileDiskCache)->Unit(benchmark::kMicrosecond);
+
+void BM_JsonLoadProfileWarm(benchmark::State& state)
+{
+    if (!PrepareOrSkip(state)) return;
+    JsonManager json;
+    StereoDisplayDriverConfiguration cfg;
+    json.LoadParamsFromJson(cfg);
+    if (state.range(0) != 0 && !json.StartProfileWatch()) {
+        state.SkipWithError("profile watch unavailable");
+        return;
+    }
+    json.LoadProfileFromJson(kProfile, cfg);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(json.LoadProfileFromJson(kProfile, cfg));
+    }
+}
+BENCHMARK(BM_JsonLoadProfileWarm)->ArgName("watch")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+}  // namespace
@@ -0,0 +1,86 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Key-name vocabulary lookups (key_names.h): what a profile load pays per
+// user_settings row and the OSD per live re-parse.
+
+#include "vrto3dlib/key_names.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Portable, legacy and unknown spellings, in roughly profile proportions.
+const std::vector<std::string>& KeyNames()
+{
+    static const std::vector<std::string> names = {
+        "Key_F", "Key_Ctrl", "Key_F11", "Numpad5", "Key_PageDown", "Mouse_4",
+        "Key_Z", "Key_RightBracket", "VK_F7", "VK_NUMPAD1", "VK_CONTROL",
+        "VK_OEM_MINUS", "Key_Bogus", "",
+    };
+    return names;
+}
+
+// Keyboard and pad binds, single and '+'-joined, portable and legacy.
+const std::vector<std::string>& BindNames()
+{
+    static const std::vector<std::string> names = {
+        "Key_F3", "Key_Alt", "VK_F9", "Numpad0", "Pad_A", "Pad_LB+Pad_RB",
+        "Pad_Back+Pad_DPadUp", "XINPUT_GAMEPAD_LEFT_SHOULDER",
+        "XINPUT_GAMEPAD_START+XINPUT_GAMEPAD_Y", "Mouse_Middle", "Key_Bogus",
+        "Pad_A+Nope",
+    };
+    return names;
+}
+
+void BM_KeyCodeFromName(benchmark::State& state)
+{
+    const auto& names = KeyNames();
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(vrto3d::keys::KeyCodeFromName(names[i]));
+        i = i + 1 == names.size() ? 0 : i + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_KeyCodeFromName);
+
+// Arg: migrate (1 rewrites legacy names in place, as the profile loader
+// does). The name is re-copied every iteration either way.
+void BM_ParseBind(benchmark::State& state)
+{
+    const auto& names = BindNames();
+    const bool migrate = state.range(0) != 0;
+    std::string name;
+    size_t i = 0;
+    for (auto _ : state) {
+        name = names[i];
+        int32_t code = 0;
+        bool xinput = false;
+        benchmark::DoNotOptimize(vrto3d::keys::ParseBind(name, code, xinput, migrate));
+        benchmark::DoNotOptimize(code);
+        i = i + 1 == names.size() ? 0 : i + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParseBind)->ArgName("migrate")->Arg(0)->Arg(1);
+
+}  // namespace
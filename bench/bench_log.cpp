@@ -0,0 +1,120 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// DebugLog throughput into the scratch tree's logs/ folder: the synchronous
+// sink, the async ring (StartAsync) and a statement filtered out at runtime.
+// Multi-threaded runs report the per-thread cost under contention. The Linux
+// stderr echo goes to the null device meanwhile, as vrserver's is a pipe
+// rather than a terminal.
+
+#include "vrto3dlib/debug_log.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fcntl.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define BENCH_DUP _dup
+#define BENCH_DUP2 _dup2
+#define BENCH_CLOSE _close
+#define BENCH_OPEN _open
+#define BENCH_NULL "NUL"
+#else
+#include <unistd.h>
+#define BENCH_DUP dup
+#define BENCH_DUP2 dup2
+#define BENCH_CLOSE close
+#define BENCH_OPEN open
+#define BENCH_NULL "/dev/null"
+#endif
+
+namespace {
+
+int g_saved_stderr = -1;
+
+void QuietStderr(const benchmark::State&)
+{
+    DebugLog::SetLevel(LogLevel::Info);
+    std::fflush(stderr);
+    const int null_fd = BENCH_OPEN(BENCH_NULL, O_WRONLY);
+    if (null_fd < 0) return;
+    g_saved_stderr = BENCH_DUP(2);
+    BENCH_DUP2(null_fd, 2);
+    BENCH_CLOSE(null_fd);
+}
+
+void RestoreStderr(const benchmark::State&)
+{
+    if (g_saved_stderr < 0) return;
+    std::fflush(stderr);
+    BENCH_DUP2(g_saved_stderr, 2);
+    BENCH_CLOSE(g_saved_stderr);
+    g_saved_stderr = -1;
+}
+
+void StartAsync(const benchmark::State& state)
+{
+    QuietStderr(state);
+    DebugLog::StartAsync();
+}
+
+void StopAsync(const benchmark::State& state)
+{
+    DebugLog::StopAsync();  // drains the ring into the file first
+    RestoreStderr(state);
+}
+
+void WriteLines(benchmark::State& state)
+{
+    int64_t i = 0;
+    for (auto _ : state) {
+        LOG() << "bench line " << ++i << " depth " << 0.25f << " conv " << 4.0f;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_DebugLogSync(benchmark::State& state)
+{
+    WriteLines(state);
+}
+BENCHMARK(BM_DebugLogSync)->Setup(QuietStderr)->Teardown(RestoreStderr)
+    ->Threads(1)->Threads(4)->UseRealTime();
+
+void BM_DebugLogAsync(benchmark::State& state)
+{
+    WriteLines(state);
+}
+BENCHMARK(BM_DebugLogAsync)->Setup(StartAsync)->Teardown(StopAsync)
+    ->Threads(1)->Threads(4)->UseRealTime();
+
+// LOG_DEBUG() at the default Info level: the level check alone.
+void BM_DebugLogFiltered(benchmark::State& state)
+{
+    DebugLog::SetLevel(LogLevel::Info);
+    int64_t i = 0;
+    for (auto _ : state) {
+        LOG_DEBUG() << "filtered " << ++i;
+    }
+    benchmark::DoNotOptimize(i);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DebugLogFiltered);
+
+}  // namespace
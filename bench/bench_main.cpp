@@ -0,0 +1,174 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Benchmark executable for VRto3DLib (see CMakeLists.txt / VRto3DLibBench
+// vcxproj in this folder). Google Benchmark flags apply as usual; unless
+// --benchmark_out is given, results are also written as JSON to
+// vrto3d_bench.json in the working directory, ready for
+//     compare.py benchmarks baseline.json vrto3d_bench.json
+// from Google Benchmark's tools/. Run with no UEVR instance open: the
+// Receiver benches create the UE3D mappings themselves.
+
+#include "bench_support.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <process.h>
+#define BENCH_GETPID _getpid
+#else
+#include <unistd.h>
+#define BENCH_GETPID getpid
+#endif
+
+namespace vrto3d::bench {
+
+namespace {
+std::filesystem::path g_scratch;
+}
+
+const std::filesystem::path& ScratchRoot()
+{
+    return g_scratch;
+}
+
+bool WriteTextFile(const std::filesystem::path& path, const std::string& text)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    return static_cast<bool>(out.flush());
+}
+
+void SetEnv(const char* name, const std::string& value)
+{
+#ifdef _WIN32
+    _putenv_s(name, value.c_str());
+#else
+    setenv(name, value.c_str(), 1);
+#endif
+}
+
+#ifdef _WIN32
+namespace {
+std::string g_hkcu_name;
+HKEY g_hkcu = nullptr;
+
+// GetSteamInstallPath() reads HKCU\Software\Valve\Steam\SteamPath. Give this
+// process a volatile stand-in HKCU whose SteamPath is the scratch root, so the
+// driver code runs unmodified against it.
+bool OverrideSteamPath(const std::filesystem::path& root)
+{
+    g_hkcu_name = "Software\\VRto3DBench_" + std::to_string(BENCH_GETPID());
+    if (RegCreateKeyExA(HKEY_CURRENT_USER, g_hkcu_name.c_str(), 0, nullptr, REG_OPTION_VOLATILE,
+                        KEY_ALL_ACCESS, nullptr, &g_hkcu, nullptr) != ERROR_SUCCESS) {
+        return false;
+    }
+    HKEY steam = nullptr;
+    if (RegCreateKeyExA(g_hkcu, "Software\\Valve\\Steam", 0, nullptr, REG_OPTION_VOLATILE,
+                        KEY_SET_VALUE, nullptr, &steam, nullptr) != ERROR_SUCCESS) {
+        return false;
+    }
+    const std::string path = root.string();
+    const LSTATUS set = RegSetValueExA(steam, "SteamPath", 0, REG_SZ,
+                                       reinterpret_cast<const BYTE*>(path.c_str()),
+                                       static_cast<DWORD>(path.size() + 1));
+    RegCloseKey(steam);
+    return set == ERROR_SUCCESS && RegOverridePredefKey(HKEY_CURRENT_USER, g_hkcu) == ERROR_SUCCESS;
+}
+
+void RestoreSteamPath()
+{
+    RegOverridePredefKey(HKEY_CURRENT_USER, nullptr);
+    if (g_hkcu) {
+        RegCloseKey(g_hkcu);
+        RegDeleteTreeA(HKEY_CURRENT_USER, g_hkcu_name.c_str());
+        g_hkcu = nullptr;
+    }
+}
+}  // namespace
+#endif
+
+}  // namespace vrto3d::bench
+
+
+int main(int argc, char** argv)
+{
+    namespace fs = std::filesystem;
+    using namespace vrto3d::bench;
+
+    // Scratch Steam tree first: on Linux GetSteamInstallPath() only accepts
+    // STEAM_DIR when it has a config/ folder, and DebugLog resolves the path
+    // on first use.
+    std::error_code ec;
+    g_scratch = fs::temp_directory_path(ec) / ("vrto3d_bench_" + std::to_string(BENCH_GETPID()));
+    fs::create_directories(g_scratch / "config" / "vrto3d", ec);
+    fs::create_directories(g_scratch / "logs", ec);
+    if (ec) {
+        std::fprintf(stderr, "cannot create scratch tree %s: %s\n",
+                     g_scratch.string().c_str(), ec.message().c_str());
+        return 1;
+    }
+#ifdef _WIN32
+    if (!OverrideSteamPath(g_scratch)) {
+        std::fprintf(stderr, "cannot redirect the Steam registry key to the scratch tree\n");
+        RestoreSteamPath();
+        fs::remove_all(g_scratch, ec);
+        return 1;
+    }
+#else
+    SetEnv("STEAM_DIR", g_scratch.string());
+    SetEnv("UE3D_SHM_PATH", (g_scratch / "UE3D_SharedData").string());
+#endif
+
+    std::vector<char*> args(argv, argv + argc);
+    bool has_out = false;
+    for (int i = 1; i < argc; ++i) {
+        has_out = has_out || std::strncmp(argv[i], "--benchmark_out=", 16) == 0;
+    }
+    std::string out_flag = "--benchmark_out=vrto3d_bench.json";
+    std::string format_flag = "--benchmark_out_format=json";
+    if (!has_out) {
+        args.push_back(out_flag.data());
+        args.push_back(format_flag.data());
+    }
+    int n = static_cast<int>(args.size());
+    benchmark::Initialize(&n, args.data());
+    if (benchmark::ReportUnrecognizedArguments(n, args.data())) {
+#ifdef _WIN32
+        RestoreSteamPath();
+#endif
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+#ifdef _WIN32
+    RestoreSteamPath();
+#endif
+    fs::remove_all(g_scratch, ec);  // the open DebugLog file may keep it on Windows
+    return 0;
+}
@@ -0,0 +1,54 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+// Shared pieces of the benchmark executable (bench_main.cpp). Every bench
+// runs against a scratch Steam tree that main() creates and points the Steam
+// path at (STEAM_DIR on Linux, a process-local HKCU override on Windows)
+// before anything resolves it, so profiles, vrserver.txt and the DebugLog
+// file never touch a real install.
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace vrto3d::bench {
+
+// Root of the scratch Steam tree: config/vrto3d/ and logs/ exist.
+const std::filesystem::path& ScratchRoot();
+
+// Replace `path` with `text`. Returns false on any I/O error.
+bool WriteTextFile(const std::filesystem::path& path, const std::string& text);
+
+// Portable setenv (the Windows CRT getenv sees _putenv_s values).
+void SetEnv(const char* name, const std::string& value);
+
+// Deterministic xorshift, so synthetic inputs are identical run to run and
+// result files diff cleanly.
+struct XorShift {
+    uint64_t s = 0x9E3779B97F4A7C15ull;
+    uint64_t Next()
+    {
+        s ^= s << 13;
+        s ^= s >> 7;
+        s ^= s << 17;
+        return s;
+    }
+    uint32_t Below(uint32_t n) { return static_cast<uint32_t>(Next() % n); }
+};
+
+}  // namespace vrto3d::bench
@@ -0,0 +1,277 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// uevr::Receiver per-frame paths against in-process UE3D blocks. A writer
+// thread plays UEVR: it rewrites the UEVR section under the seqlock at the
+// game's frame rate, or back to back for the contended snapshot run.
+// Benchmark arg = layout (4 or 5).
+
+#include "bench_support.h"
+#include "vrto3dlib/uevr_receiver.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr std::chrono::nanoseconds kUevrFramePeriod{ 1000000000 / 120 };
+
+// Writer side of one named UE3D block, created the way UEVR creates it: a
+// pagefile-backed mapping on Windows, the file behind UE3D_SHM_PATH (set by
+// main) on Linux.
+class FakeBlock {
+public:
+    FakeBlock(const char* name, size_t size) : size_(size)
+    {
+#ifdef _WIN32
+        mapping_ = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0,
+                                      static_cast<DWORD>(size), name);
+        if (mapping_) {
+            view_ = MapViewOfFile(mapping_, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        }
+#else
+        path_ = uevr::detail::ShmOverridePath(name);
+        const int fd = open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+        if (fd >= 0) {
+            if (ftruncate(fd, static_cast<off_t>(size)) == 0) {
+                void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                view_ = view == MAP_FAILED ? nullptr : view;
+            }
+            close(fd);
+        }
+#endif
+        if (view_) {
+            std::memset(view_, 0, size_);
+        }
+    }
+
+    ~FakeBlock()
+    {
+#ifdef _WIN32
+        if (view_) UnmapViewOfFile(view_);
+        if (mapping_) CloseHandle(mapping_);
+#else
+        if (view_) munmap(view_, size_);
+        unlink(path_.c_str());
+#endif
+    }
+
+    FakeBlock(const FakeBlock&) = delete;
+    FakeBlock& operator=(const FakeBlock&) = delete;
+
+    template <typename T>
+    T* As() const { return static_cast<T*>(view_); }
+
+private:
+    void* view_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    HANDLE mapping_ = nullptr;
+#else
+    std::string path_;
+#endif
+};
+
+// Both layouts plus the UEVR writer. Built on first use, before the Receiver
+// singleton, so it unmaps after the Receiver is gone.
+class UevrFixture {
+public:
+    UevrFixture()
+        : v4_(UE3D_SHMEM_NAME, sizeof(UE3D_SharedData)),
+          v5_(UE3D_V5_SHMEM_NAME, sizeof(UE3D_SharedDataV5))
+    {
+        if (auto* d = v4_.As<UE3D_SharedData>()) {
+            d->magic = UE3D_MAGIC;
+            d->version = UE3D_VERSION;
+            d->struct_size = UE3D_STRUCT_SIZE;
+            d->flags = UE3D_FLAG_MULTIPLIER_MODE | UE3D_FLAG_SEQLOCK | UE3D_FLAG_TIMESTAMP_NS;
+            d->is_valid = 1;
+            d->fov_scale = 1.0f;
+            d->zoom_factor = 1.0f;
+            d->world_scale = 1.0f;
+            d->monitor_mode = 1;
+            d->stereo_depth_hint = 0.064f;
+        }
+        if (auto* d = v5_.As<UE3D_SharedDataV5>()) {
+            d->header.magic = UE3D_MAGIC;
+            d->header.version = UE3D_V5_VERSION;
+            d->header.struct_size = UE3D_V5_STRUCT_SIZE;
+            d->header.flags = UE3D_FLAG_MULTIPLIER_MODE | UE3D_FLAG_SEQLOCK |
+                              UE3D_FLAG_TIMESTAMP_NS | UE3D_FLAG_LAYOUT_V5;
+            d->uevr.is_valid = 1;
+            d->uevr.fov_scale = 1.0f;
+            d->uevr.zoom_factor = 1.0f;
+            d->uevr.world_scale = 1.0f;
+            d->uevr.monitor_mode = 1;
+            d->uevr.stereo_depth_hint = 0.064f;
+        }
+        WriteFrame();
+        writer_ = std::thread([this] { WriterLoop(); });
+    }
+
+    ~UevrFixture()
+    {
+        running_.store(false, std::memory_order_relaxed);
+        writer_.join();
+    }
+
+    bool Ok() const { return v4_.As<void>() && v5_.As<void>(); }
+
+    // Writer period; 0 = rewrite back to back.
+    void SetWriterPeriod(std::chrono::nanoseconds period) { period_ns_.store(period.count()); }
+
+    // (Re)attach the Receiver to one layout. Returns false if it picked another.
+    bool Attach(int layout)
+    {
+        auto& rx = uevr::Receiver::instance();
+        rx.set_telemetry_log_interval(0);
+        rx.shutdown();
+        rx.set_allow_v5(layout == 5);
+        return rx.init() && rx.layout() == (layout == 5 ? uevr::Layout::V5 : uevr::Layout::V4);
+    }
+
+private:
+    void WriteFrame()
+    {
+        ++frame_;
+        const float depth = 0.5f + static_cast<float>(frame_ % 50) * 0.01f;
+        if (auto* d = v4_.As<UE3D_SharedData>()) {
+            ue3d_seq_write_begin(d);
+            d->uevr_frame_count = frame_;
+            d->uevr_timestamp = GetTickCount64();
+            d->uevr_timestamp_ns = uevr::detail::TickNs();
+            d->depth_multiplier = depth;
+            ue3d_seq_write_end(d);
+        }
+        if (auto* d = v5_.As<UE3D_SharedDataV5>()) {
+            ue3d_seq_write_begin(d);
+            d->uevr.uevr_frame_count = frame_;
+            d->uevr.uevr_timestamp = GetTickCount64();
+            d->uevr.uevr_timestamp_ns = uevr::detail::TickNs();
+            d->uevr.depth_multiplier = depth;
+            ue3d_seq_write_end(d);
+        }
+    }
+
+    void WriterLoop()
+    {
+        while (running_.load(std::memory_order_relaxed)) {
+            WriteFrame();
+            const int64_t period = period_ns_.load(std::memory_order_relaxed);
+            if (period > 0) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(period));
+            }
+        }
+    }
+
+    FakeBlock v4_;
+    FakeBlock v5_;
+    uint32_t frame_ = 0;
+    std::atomic<bool> running_{ true };
+    std::atomic<int64_t> period_ns_{ kUevrFramePeriod.count() };
+    std::thread writer_;
+};
+
+UevrFixture& Fixture()
+{
+    static UevrFixture fixture;
+    return fixture;
+}
+
+bool AttachOrSkip(benchmark::State& state)
+{
+    if (!Fixture().Ok()) {
+        state.SkipWithError("could not create the UE3D mappings");
+        return false;
+    }
+    if (!Fixture().Attach(static_cast<int>(state.range(0)))) {
+        state.SkipWithError("Receiver did not attach to the requested layout");
+        return false;
+    }
+    return true;
+}
+
+void BM_UevrUpdate(benchmark::State& state)
+{
+    if (!AttachOrSkip(state)) return;
+    auto& rx = uevr::Receiver::instance();
+    float depth = 0.1f;
+    for (auto _ : state) {
+        rx.update(depth, 3.0f, 90.0f, 0.0f, 1, true);
+        depth = depth < 0.5f ? depth + 0.001f : 0.1f;
+    }
+}
+BENCHMARK(BM_UevrUpdate)->ArgName("layout")->Arg(4)->Arg(5);
+
+void BM_UevrSnapshot(benchmark::State& state)
+{
+    if (!AttachOrSkip(state)) return;
+    auto& rx = uevr::Receiver::instance();
+    for (auto _ : state) {
+        const uevr::Snapshot& s = rx.snapshot();
+        benchmark::DoNotOptimize(s.data.depth_multiplier);
+    }
+}
+BENCHMARK(BM_UevrSnapshot)->ArgName("layout")->Arg(4)->Arg(5);
+
+// UEVR rewriting its section continuously: retries and torn gives show up.
+void BM_UevrSnapshotContended(benchmark::State& state)
+{
+    if (!AttachOrSkip(state)) return;
+    auto& rx = uevr::Receiver::instance();
+    const uint32_t torn_before = rx.get_torn_snapshot_count();
+    Fixture().SetWriterPeriod(std::chrono::nanoseconds(0));
+    for (auto _ : state) {
+        const uevr::Snapshot& s = rx.snapshot();
+        benchmark::DoNotOptimize(s.data.depth_multiplier);
+    }
+    Fixture().SetWriterPeriod(kUevrFramePeriod);
+    state.counters["torn"] = static_cast<double>(rx.get_torn_snapshot_count() - torn_before);
+}
+BENCHMARK(BM_UevrSnapshotContended)->ArgName("layout")->Arg(4)->Arg(5);
+
+// The live getters the driver reads per frame besides the snapshot.
+void BM_UevrGetters(benchmark::State& state)
+{
+    if (!AttachOrSkip(state)) return;
+    auto& rx = uevr::Receiver::instance();
+    for (auto _ : state) {
+        float depth = 0.0f, convergence = 0.0f;
+        benchmark::DoNotOptimize(rx.has_valid_data());
+        benchmark::DoNotOptimize(rx.get_monitor_mode());
+        benchmark::DoNotOptimize(rx.get_stereo_depth_hint());
+        benchmark::DoNotOptimize(rx.get_depth_request());
+        benchmark::DoNotOptimize(rx.get_world_scale());
+        benchmark::DoNotOptimize(rx.calculate_auto_stereo(depth, convergence));
+        benchmark::DoNotOptimize(depth);
+    }
+}
+BENCHMARK(BM_UevrGetters)->ArgName("layout")->Arg(4)->Arg(5);
+
+}  // namespace
@@ -0,0 +1,76 @@
+# Static vrto3dlib target for the CMake builds under bench/ and tests/.
+#
+# The library itself is built by the VRto3DLib vcxproj; this compiles the
+# same sources so those executables build on Linux too. Dependencies are
+# found as installed packages: nlohmann_json (or the ../json checkout next to
+# this repo, as the vcxproj expects) and, on Linux, xkbcommon.
+
+if(TARGET vrto3dlib)
+  return()
+endif()
+
+get_filename_component(VRTO3D_ROOT ${CMAKE_CURRENT_LIST_DIR}/.. ABSOLUTE)
+
+find_package(Threads REQUIRED)
+
+find_package(nlohmann_json 3 QUIET)
+if(NOT nlohmann_json_FOUND)
+  find_path(NLOHMANN_JSON_INCLUDE_DIR nlohmann/json.hpp
+            HINTS ${VRTO3D_ROOT}/../json/include)
+  if(NOT NLOHMANN_JSON_INCLUDE_DIR)
+    message(FATAL_ERROR "nlohmann/json.hpp not found; set NLOHMANN_JSON_INCLUDE_DIR")
+  endif()
+endif()
+
+set(VRTO3D_SOURCES
+  ${VRTO3D_ROOT}/src/app_id_mgr.cpp
+  ${VRTO3D_ROOT}/src/async_json_writer.cpp
+  ${VRTO3D_ROOT}/src/json_manager.cpp
+  ${VRTO3D_ROOT}/src/key_names.cpp
+  ${VRTO3D_ROOT}/src/process_watch.cpp
+  ${VRTO3D_ROOT}/src/profile_watcher.cpp
+  ${VRTO3D_ROOT}/src/trace.cpp
+)
+if(WIN32)
+  list(APPEND VRTO3D_SOURCES
+    ${VRTO3D_ROOT}/src/overlay_mgr.cpp
+    ${VRTO3D_ROOT}/src/win32_input.cpp
+  )
+else()
+  list(APPEND VRTO3D_SOURCES ${VRTO3D_ROOT}/src/linux_input.cpp)
+endif()
+
+add_library(vrto3dlib STATIC ${VRTO3D_SOURCES})
+target_include_directories(vrto3dlib
+  PUBLIC ${VRTO3D_ROOT}/include
+  PRIVATE ${VRTO3D_ROOT}/src)
+target_link_libraries(vrto3dlib PUBLIC Threads::Threads)
+if(nlohmann_json_FOUND)
+  target_link_libraries(vrto3dlib PUBLIC nlohmann_json::nlohmann_json)
+else()
+  target_include_directories(vrto3dlib PUBLIC ${NLOHMANN_JSON_INCLUDE_DIR})
+endif()
+
+if(NOT WIN32)
+  find_package(PkgConfig QUIET)
+  if(PkgConfig_FOUND)
+    pkg_check_modules(XKBCOMMON QUIET IMPORTED_TARGET xkbcommon)
+  endif()
+  if(TARGET PkgConfig::XKBCOMMON)
+    target_link_libraries(vrto3dlib PUBLIC PkgConfig::XKBCOMMON)
+  else()
+    find_path(XKBCOMMON_INCLUDE_DIR xkbcommon/xkbcommon.h)
+    find_library(XKBCOMMON_LIBRARY NAMES xkbcommon libxkbcommon.so.0)
+    if(NOT XKBCOMMON_INCLUDE_DIR OR NOT XKBCOMMON_LIBRARY)
+      message(FATAL_ERROR "xkbcommon not found; set XKBCOMMON_INCLUDE_DIR and XKBCOMMON_LIBRARY")
+    endif()
+    target_include_directories(vrto3dlib PUBLIC ${XKBCOMMON_INCLUDE_DIR})
+    target_link_libraries(vrto3dlib PUBLIC ${XKBCOMMON_LIBRARY})
+  endif()
+endif()
+
+if(MSVC)
+  target_compile_options(vrto3dlib PRIVATE /W3 /permissive-)
+else()
+  target_compile_options(vrto3dlib PRIVATE -Wall -Wextra)
+endif()
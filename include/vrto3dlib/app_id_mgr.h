@@ -16,6 +16,7 @@
  */
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -23,9 +24,24 @@
 class AppIdMgr {
 public:
     AppIdMgr();
+    // Every app key SteamVR has logged this session, oldest first.
     std::vector<std::string> GetSteamAppIDs();
+    // Only the app keys logged since the previous GetSteamAppIDs() /
+    // GetNewSteamAppIDs() call.
+    std::vector<std::string> GetNewSteamAppIDs();
 
 private:
+    // Identity of the log file, to tell a rotated (replaced) log from one
+    // that just grew.
+    struct LogIdentity {
+        uint64_t volume = 0;
+        uint64_t file = 0;
+        bool operator==(const LogIdentity& o) const { return volume == o.volume && file == o.file; }
+        bool operator!=(const LogIdentity& o) const { return !(*this == o); }
+    };
+
+    bool ReadLogTail();
+    void ScanLogText(const char* begin, const char* end);
 
     std::unordered_set<std::string> excluded_app_keys_ = {
         "system.systemui",
@@ -38,4 +54,12 @@ private:
     };
 
     std::string steam_path_;
+
+    // vrserver.txt tail state: bytes consumed so far, the trailing partial
+    // line, and every key found (keys_reported_ of them already handed out).
+    LogIdentity log_id_;
+    uint64_t log_offset_ = 0;
+    std::string log_partial_;
+    std::vector<std::string> app_keys_;
+    size_t keys_reported_ = 0;
 };
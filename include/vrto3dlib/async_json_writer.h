@@ -0,0 +1,73 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+// Background writer for JsonManager's saves. Write() hands over the JSON and
+// returns at once; a single worker thread serializes it and replaces the file
+// atomically (temp file + rename) once the debounce window since the first
+// pending save of that path has passed. Saves of the same path inside the
+// window coalesce: only the newest JSON is written, and every caller gets the
+// same future, which resolves true once that write landed.
+
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <nlohmann/json.hpp>
+
+class AsyncJsonWriter {
+public:
+    explicit AsyncJsonWriter(std::chrono::milliseconds debounce = std::chrono::milliseconds(250));
+    // Writes everything still pending, then joins the worker.
+    ~AsyncJsonWriter();
+
+    AsyncJsonWriter(const AsyncJsonWriter&) = delete;
+    AsyncJsonWriter& operator=(const AsyncJsonWriter&) = delete;
+
+    std::shared_future<bool> Write(const std::string& path, nlohmann::ordered_json json);
+
+    // Write `path` now if it has a pending save and wait for it (or for the
+    // write already in flight). Returns that write's result; true if idle.
+    bool Flush(const std::string& path);
+
+    // Replace `path` with `text`: temp file in the same folder, then rename.
+    static bool WriteFileAtomic(const std::string& path, const std::string& text);
+
+private:
+    struct Pending {
+        nlohmann::ordered_json json;
+        std::chrono::steady_clock::time_point due;
+        std::shared_ptr<std::promise<bool>> done;
+        std::shared_future<bool> future;
+    };
+
+    void Run();
+
+    const std::chrono::milliseconds debounce_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::map<std::string, Pending> pending_;
+    std::string in_flight_path_;
+    std::shared_future<bool> in_flight_;
+    bool stop_ = false;
+    std::thread worker_;  // started by the first Write()
+};
@@ -16,21 +16,386 @@
  */
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 
 #ifdef _WIN32
 #include <windows.h>
+#include <io.h>
 #else
+#include <csignal>
 #include <sys/file.h>
 #include <sys/stat.h>
 #include <unistd.h>
-#include <cstdio>
 #endif
 
 std::string GetSteamInstallPath();
 
+//-----------------------------------------------------------------------------
+// Log levels. LOG() is Info. Statements above VRTO3D_LOG_COMPILED_LEVEL are
+// compiled out; the rest are checked against the runtime level (default
+// Info, or VRTO3D_LOG_LEVEL=error|warn|info|debug|trace from the
+// environment, or DebugLog::SetLevel()) before any formatting happens.
+//-----------------------------------------------------------------------------
+enum class LogLevel : int { Error = 0, Warn = 1, Info = 2, Debug = 3, Trace = 4 };
+
+#ifndef VRTO3D_LOG_COMPILED_LEVEL
+#define VRTO3D_LOG_COMPILED_LEVEL 3  // Debug: LOG_TRACE() compiles to nothing
+#endif
+
+namespace vrto3d::log_detail {
+
+inline int LevelFromEnv() {
+    const char* env = std::getenv("VRTO3D_LOG_LEVEL");
+    if (!env) return static_cast<int>(LogLevel::Info);
+    const char* names[] = { "error", "warn", "info", "debug", "trace" };
+    for (int i = 0; i < 5; ++i) {
+        if (std::strcmp(env, names[i]) == 0) return i;
+    }
+    return static_cast<int>(LogLevel::Info);
+}
+
+inline std::atomic<int>& RuntimeLevel() {
+    static std::atomic<int> level{ LevelFromEnv() };
+    return level;
+}
+
+inline const char* LevelTag(LogLevel level) {
+    switch (level) {
+    case LogLevel::Error: return "[error] ";
+    case LogLevel::Warn:  return "[warn] ";
+    case LogLevel::Debug: return "[debug] ";
+    case LogLevel::Trace: return "[trace] ";
+    default:              return "";
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Async sink for DebugLog: producers push preformatted UTF-8 lines into a
+// bounded lock-free MPSC ring (per-slot sequence numbers); a full ring
+// yields briefly to the writer, then drops the line and counts it. A ring
+// half full wakes the writer early. One writer thread keeps the log file
+// open, drains in batches, and fflush()es every kFlushMs and on Stop().
+// The crash hooks (SIGSEGV & co. / the unhandled-exception filter) are
+// opt-in via InstallCrashHooks(); they drain on the crashing thread with
+// raw writes and chain to the previous handler.
+//
+// Like XInputPoller, Stop() must come from driver shutdown; the destructor
+// only detaches, because joining from a static destructor would run under
+// the Windows loader lock.
+//-----------------------------------------------------------------------------
+class AsyncLogWriter {
+public:
+    static constexpr size_t kSlots = 4096;  // power of two
+    static constexpr int kFlushMs = 200;
+    static constexpr int kFullSpins = 2000;  // yields before a full ring drops
+    using EchoFn = void (*)(const std::string& line);
+
+    static AsyncLogWriter& Get() {
+        static AsyncLogWriter writer;
+        return writer;
+    }
+
+    ~AsyncLogWriter() {
+        if (thread_.joinable()) thread_.detach();
+    }
+
+    bool Running() const { return running_.load(std::memory_order_acquire); }
+
+    bool Start(const std::string& path, EchoFn echo) {
+        std::lock_guard<std::mutex> lock(lifecycle_);
+        if (thread_.joinable()) return true;
+        file_ = std::fopen(path.c_str(), "ab");
+        if (!file_) return false;
+        if (!slots_) {
+            slots_.reset(new Slot[kSlots]);
+        }
+        for (size_t i = 0; i < kSlots; ++i) slots_[i].seq.store(i, std::memory_order_relaxed);
+        head_.store(0, std::memory_order_relaxed);
+        tail_ = 0;
+        echo_ = echo;
+        stop_ = false;
+#ifdef _WIN32
+        raw_file_.store(_get_osfhandle(_fileno(file_)), std::memory_order_release);
+#else
+        raw_file_.store(fileno(file_), std::memory_order_release);
+#endif
+        running_.store(true, std::memory_order_release);
+        thread_ = std::thread([this] { Run(); });
+        return true;
+    }
+
+    void Stop() {
+        std::lock_guard<std::mutex> lock(lifecycle_);
+        if (!thread_.joinable()) return;
+        {
+            std::lock_guard<std::mutex> wake(wake_mutex_);
+            stop_ = true;
+        }
+        wake_cv_.notify_one();
+        thread_.join();  // the last drain happens with running_ still set
+        running_.store(false, std::memory_order_release);
+        Drain();  // lines pushed between the final drain and running_ = false
+        raw_file_.store(-1, std::memory_order_release);
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+
+    // False when the ring is full (the line is dropped).
+    bool Push(std::string&& line) {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+        int full_spins = 0;
+        for (;;) {
+            slot = &slots_[pos & (kSlots - 1)];
+            const size_t seq = slot->seq.load(std::memory_order_acquire);
+            const intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (dif == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (dif < 0) {
+                // Full: give the writer a moment before dropping the line.
+                if (++full_spins > kFullSpins) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                Wake();
+                std::this_thread::yield();
+                pos = head_.load(std::memory_order_relaxed);
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+        slot->text = std::move(line);
+        slot->seq.store(pos + 1, std::memory_order_release);
+        if ((pos & (kSlots / 2 - 1)) == 0) Wake();  // filling up: drain early
+        return true;
+    }
+
+    // Best effort from a crash handler: drain on this thread unless the
+    // writer holds the consumer side. Async-signal-safe.
+    void CrashFlush() {
+        if (!Running()) return;
+        for (int spin = 0; spin < 100000; ++spin) {
+            if (!consuming_.test_and_set(std::memory_order_acquire)) {
+                CrashDrainLocked();
+                consuming_.clear(std::memory_order_release);
+                return;
+            }
+        }
+    }
+
+    // Opt-in: flush the ring when the process crashes, then hand the crash
+    // to whatever handler was installed before (vrserver's, Breakpad's).
+    // Install after the host's own handlers. Idempotent.
+    static void InstallCrashHooks() { InstallHooksOnce(); }
+
+private:
+    struct Slot {
+        std::atomic<size_t> seq{0};
+        std::string text;
+    };
+
+    // Early drain request; Run() also wakes every kFlushMs without one.
+    void Wake() {
+        wake_requested_.store(true, std::memory_order_release);
+        wake_cv_.notify_one();
+    }
+
+    void Drain() {
+        while (consuming_.test_and_set(std::memory_order_acquire)) std::this_thread::yield();
+        DrainLocked();
+        consuming_.clear(std::memory_order_release);
+    }
+
+    void DrainLocked() {
+        if (!file_) return;
+        std::string batch;
+        for (;;) {
+            Slot& slot = slots_[tail_ & (kSlots - 1)];
+            if (slot.seq.load(std::memory_order_acquire) != tail_ + 1) break;
+            if (echo_) echo_(slot.text);
+            batch += slot.text;
+            slot.text.clear();
+            slot.seq.store(tail_ + kSlots, std::memory_order_release);
+            ++tail_;
+        }
+        const uint64_t dropped = dropped_.exchange(0, std::memory_order_relaxed);
+        if (dropped) {
+            batch += "DebugLog: " + std::to_string(dropped) + " line(s) dropped (ring full)\n";
+        }
+        if (!batch.empty()) {
+            std::fwrite(batch.data(), 1, batch.size(), file_);
+            std::fflush(file_);
+        }
+    }
+
+    // DrainLocked() for a crash handler: no allocation, no stdio and no
+    // echo, only one raw write per preformatted slot on the file's
+    // descriptor. The writer fflush()es after every batch and holds
+    // consuming_ while it writes, so the FILE buffer is empty here.
+    void CrashDrainLocked() {
+        const intptr_t out = raw_file_.load(std::memory_order_acquire);
+        if (out == -1) return;
+        for (;;) {
+            Slot& slot = slots_[tail_ & (kSlots - 1)];
+            if (slot.seq.load(std::memory_order_acquire) != tail_ + 1) break;
+            RawWrite(out, slot.text.data(), slot.text.size());
+            // Recycled with its text in place; the next Push() replaces it.
+            slot.seq.store(tail_ + kSlots, std::memory_order_release);
+            ++tail_;
+        }
+        uint64_t dropped = dropped_.exchange(0, std::memory_order_relaxed);
+        if (dropped) {
+            char digits[20];
+            size_t n = sizeof(digits);
+            do {
+                digits[--n] = static_cast<char>('0' + dropped % 10);
+                dropped /= 10;
+            } while (dropped && n);
+            static const char prefix[] = "DebugLog: ";
+            static const char suffix[] = " line(s) dropped (ring full)\n";
+            RawWrite(out, prefix, sizeof(prefix) - 1);
+            RawWrite(out, digits + n, sizeof(digits) - n);
+            RawWrite(out, suffix, sizeof(suffix) - 1);
+        }
+    }
+
+    static void RawWrite(intptr_t out, const char* data, size_t size) {
+#ifdef _WIN32
+        DWORD written = 0;
+        WriteFile(reinterpret_cast<HANDLE>(out), data, static_cast<DWORD>(size), &written, nullptr);
+#else
+        while (size > 0) {
+            const ssize_t n = ::write(static_cast<int>(out), data, size);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return;
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+#endif
+    }
+
+    void Run() {
+        std::unique_lock<std::mutex> wake(wake_mutex_);
+        for (;;) {
+            const bool stopping = stop_;
+            wake.unlock();
+            Drain();
+            if (stopping) return;
+            wake.lock();
+            wake_cv_.wait_for(wake, std::chrono::milliseconds(kFlushMs), [this] {
+                return stop_ || wake_requested_.exchange(false, std::memory_order_acquire);
+            });
+        }
+    }
+
+#ifndef _WIN32
+    static constexpr int kCrashSignals[] = { SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT };
+
+    static struct sigaction* PreviousActions() {
+        static struct sigaction previous[sizeof(kCrashSignals) / sizeof(kCrashSignals[0])];
+        return previous;
+    }
+
+    // Only async-signal-safe calls: CrashFlush(), the previous handler,
+    // sigaction() and raise().
+    static void OnCrashSignal(int sig, siginfo_t* info, void* context) {
+        Get().CrashFlush();
+        for (size_t i = 0; i < sizeof(kCrashSignals) / sizeof(kCrashSignals[0]); ++i) {
+            if (kCrashSignals[i] != sig) continue;
+            const struct sigaction& previous = PreviousActions()[i];
+            if (previous.sa_flags & SA_SIGINFO) {
+                if (previous.sa_sigaction) previous.sa_sigaction(sig, info, context);
+            } else if (previous.sa_handler == SIG_IGN) {
+                sigaction(sig, &previous, nullptr);
+                return;
+            } else if (previous.sa_handler != SIG_DFL) {
+                previous.sa_handler(sig);
+            }
+        }
+        // The chained handler returned (or there was none): end the process
+        // with the default action. The signal stays blocked until we return,
+        // so an asynchronous one (kill -ABRT) is not lost either.
+        struct sigaction dfl {};
+        dfl.sa_handler = SIG_DFL;
+        sigemptyset(&dfl.sa_mask);
+        sigaction(sig, &dfl, nullptr);
+        raise(sig);
+    }
+
+    // SA_ONSTACK only helps threads with an alternate signal stack, so the
+    // installing thread gets one if it has none; other threads that should
+    // survive a stack overflow set up their own with sigaltstack().
+    static void InstallHooksOnce() {
+        static std::once_flag once;
+        std::call_once(once, [] {
+            static char alt_stack[64 * 1024];
+            stack_t current {};
+            if (sigaltstack(nullptr, &current) == 0 && (current.ss_flags & SS_DISABLE)) {
+                stack_t ss {};
+                ss.ss_sp = alt_stack;
+                ss.ss_size = sizeof(alt_stack);
+                sigaltstack(&ss, nullptr);
+            }
+
+            struct sigaction sa {};
+            sa.sa_sigaction = &OnCrashSignal;
+            sa.sa_flags = SA_SIGINFO | SA_ONSTACK;
+            sigemptyset(&sa.sa_mask);
+            for (size_t i = 0; i < sizeof(kCrashSignals) / sizeof(kCrashSignals[0]); ++i) {
+                sigaction(kCrashSignals[i], &sa, &PreviousActions()[i]);
+            }
+        });
+    }
+#else
+    static LPTOP_LEVEL_EXCEPTION_FILTER& PreviousFilter() {
+        static LPTOP_LEVEL_EXCEPTION_FILTER previous = nullptr;
+        return previous;
+    }
+
+    static LONG WINAPI OnUnhandledException(EXCEPTION_POINTERS* info) {
+        Get().CrashFlush();
+        return PreviousFilter() ? PreviousFilter()(info) : EXCEPTION_CONTINUE_SEARCH;
+    }
+
+    static void InstallHooksOnce() {
+        static std::once_flag once;
+        std::call_once(once, [] { PreviousFilter() = SetUnhandledExceptionFilter(&OnUnhandledException); });
+    }
+#endif
+
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<size_t> head_{0};  // producers
+    alignas(64) size_t tail_ = 0;              // consumer (holds consuming_)
+    std::atomic_flag consuming_ = ATOMIC_FLAG_INIT;
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<bool> running_{false};
+
+    FILE* file_ = nullptr;
+    std::atomic<intptr_t> raw_file_{-1};  // file_'s fd / HANDLE, for crash drains
+    EchoFn echo_ = nullptr;
+    std::mutex lifecycle_;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    std::atomic<bool> wake_requested_{false};
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+}  // namespace vrto3d::log_detail
+
 #ifndef _WIN32
 
 // Linux DebugLog: same LOG() interface as the Windows version below, minus
@@ -38,13 +403,39 @@ std::string GetSteamInstallPath();
 // in one process uses a pid-stamped marker file instead of a named mutex.
 class DebugLog {
 public:
-    DebugLog() = default;
+    explicit DebugLog(LogLevel level = LogLevel::Info) : level_(level) {}
 
     static void SetLogName(const std::string& stem) {
+        const bool async = vrto3d::log_detail::AsyncLogWriter::Get().Running();
+        if (async) StopAsync();
         ConfiguredStem() = stem;
         GetFileState(true);
+        if (async) StartAsync();
+    }
+
+    static void SetLevel(LogLevel level) {
+        vrto3d::log_detail::RuntimeLevel().store(static_cast<int>(level), std::memory_order_relaxed);
+    }
+    static bool Enabled(LogLevel level) {
+        return static_cast<int>(level) <=
+               vrto3d::log_detail::RuntimeLevel().load(std::memory_order_relaxed);
     }
 
+    // Hand lines to the background writer instead of open/append/close per
+    // line (see AsyncLogWriter). StopAsync() drains it; call it from
+    // driver shutdown.
+    static bool StartAsync() {
+        const FileState& state = GetFileState();
+        if (!state.enabled || state.current_log_path.empty()) return false;
+        return vrto3d::log_detail::AsyncLogWriter::Get().Start(
+            state.current_log_path, [](const std::string& line) { fputs(line.c_str(), stderr); });
+    }
+    static void StopAsync() { vrto3d::log_detail::AsyncLogWriter::Get().Stop(); }
+
+    // Opt-in: flush the async ring on a crash and chain to the previous
+    // handler (see AsyncLogWriter::InstallCrashHooks()).
+    static void InstallCrashHooks() { vrto3d::log_detail::AsyncLogWriter::InstallCrashHooks(); }
+
     ~DebugLog() { flush(); }
 
     template<typename T>
@@ -137,7 +528,12 @@ private:
         if (stream_.tellp() == 0)
             return;
         stream_ << '\n';
-        const std::string message = stream_.str();
+        std::string message = vrto3d::log_detail::LevelTag(level_) + stream_.str();
+        auto& async = vrto3d::log_detail::AsyncLogWriter::Get();
+        if (async.Running() && !FileInitScope::InProgress()) {
+            async.Push(std::move(message));
+            return;
+        }
         fputs(message.c_str(), stderr);
         if (FileInitScope::InProgress())
             return;
@@ -150,23 +546,50 @@ private:
             log_file << message;
     }
 
+    LogLevel level_;
     std::stringstream stream_;
 };
 
-#define LOG() DebugLog()
-
 #else  // _WIN32
 
 class DebugLog {
 public:
-    DebugLog() = default;
+    explicit DebugLog(LogLevel level = LogLevel::Info) : level_(level) {}
 
     // Change the log filename stem (e.g. "myplugin" -> myplugin.txt / myplugin_previous.txt).
     // Safe to call at any time; takes effect on the next LOG() call.
     static void SetLogName(const std::string& stem) {
+        const bool async = vrto3d::log_detail::AsyncLogWriter::Get().Running();
+        if (async) StopAsync();
         ConfiguredStem() = stem;
         GetFileState(true); // re-initialize with new name
+        if (async) StartAsync();
+    }
+
+    static void SetLevel(LogLevel level) {
+        vrto3d::log_detail::RuntimeLevel().store(static_cast<int>(level), std::memory_order_relaxed);
+    }
+    static bool Enabled(LogLevel level) {
+        return static_cast<int>(level) <=
+               vrto3d::log_detail::RuntimeLevel().load(std::memory_order_relaxed);
+    }
+
+    // Hand lines to the background writer instead of open/append/close per
+    // line (see AsyncLogWriter). StopAsync() drains it; call it from
+    // driver shutdown.
+    static bool StartAsync() {
+        const FileState& state = GetFileState();
+        if (!state.enabled || state.current_log_path.empty()) return false;
+        return vrto3d::log_detail::AsyncLogWriter::Get().Start(
+            state.current_log_path, [](const std::string& line) {
+                OutputDebugStringW(ToWide(line).c_str());
+            });
     }
+    static void StopAsync() { vrto3d::log_detail::AsyncLogWriter::Get().Stop(); }
+
+    // Opt-in: flush the async ring on a crash and chain to the previous
+    // handler (see AsyncLogWriter::InstallCrashHooks()).
+    static void InstallCrashHooks() { vrto3d::log_detail::AsyncLogWriter::InstallCrashHooks(); }
 
     ~DebugLog() {
         flush();
@@ -211,6 +634,35 @@ private:
         }
     };
 
+    // Inverse of ToUtf8() for the async writer's OutputDebugStringW echo.
+    static std::wstring ToWide(const std::string& utf8) {
+        if (utf8.empty()) {
+            return {};
+        }
+
+        const int required_size = MultiByteToWideChar(
+            CP_UTF8,
+            0,
+            utf8.c_str(),
+            static_cast<int>(utf8.size()),
+            nullptr,
+            0);
+
+        if (required_size <= 0) {
+            return {};
+        }
+
+        std::wstring wide(static_cast<size_t>(required_size), L'\0');
+        MultiByteToWideChar(
+            CP_UTF8,
+            0,
+            utf8.c_str(),
+            static_cast<int>(utf8.size()),
+            wide.data(),
+            required_size);
+        return wide;
+    }
+
     static std::string ToUtf8(const std::wstring& message) {
         if (message.empty()) {
             return {};
@@ -332,7 +784,15 @@ private:
             return;
 
         stream_ << L'\n';
-        const std::wstring message = stream_.str();
+        std::wstring message = stream_.str();
+        if (const char* tag = vrto3d::log_detail::LevelTag(level_); *tag) {
+            message.insert(0, std::wstring(tag, tag + std::strlen(tag)));
+        }
+        auto& async = vrto3d::log_detail::AsyncLogWriter::Get();
+        if (async.Running() && !FileInitScope::InProgress()) {
+            async.Push(ToUtf8(message));
+            return;
+        }
         OutputDebugStringW(message.c_str());
         AppendToFile(message);
     }
@@ -343,9 +803,22 @@ private:
             stream_ << static_cast<wchar_t>(*s++);
     }
 
+    LogLevel level_;
     std::wstringstream stream_;
 };
 
-#define LOG() DebugLog()
-
 #endif  // _WIN32
+
+// Statement macros: when the level is compiled out or disabled the stream
+// expression after them is never evaluated.
+#define LOG_AT(level)                                                          \
+    if (static_cast<int>(level) > VRTO3D_LOG_COMPILED_LEVEL ||                 \
+        !DebugLog::Enabled(level)) {                                           \
+    } else                                                                     \
+        DebugLog(level)
+
+#define LOG()       LOG_AT(LogLevel::Info)
+#define LOG_ERROR() LOG_AT(LogLevel::Error)
+#define LOG_WARN()  LOG_AT(LogLevel::Warn)
+#define LOG_DEBUG() LOG_AT(LogLevel::Debug)
+#define LOG_TRACE() LOG_AT(LogLevel::Trace)
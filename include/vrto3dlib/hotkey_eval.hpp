@@ -20,15 +20,29 @@
 // and linux_helper.hpp (previously an identical ~120-line copy in each). The
 // only per-platform difference was the "is this key down?" query, so it's a
 // template parameter (`is_down(int vk) -> bool`); the gamepad button state is
-// passed in as `xstate`.
+// passed in as `xstate`. The InputFrame overload evaluates against one
+// per-frame input snapshot instead of live queries, and feeds the opt-in
+// input::HotkeyLatency() histogram from the frame's edge timestamp. Once
+// CompileHotkeyTable() has run it evaluates cfg.hotkey_table instead of the
+// user_* rows (rebuilt when cfg.user_settings_generation changes), and only
+// on frames where a referenced key/button changed or a
+// held TOGGLE/SWITCH row is due to repeat. The per-frame evaluator is
+// templated on the depth/convergence backend too: DepthConvBackend (function
+// pointers) is adapted, and a concrete backend type gets direct calls.
 
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <string>
+#include <type_traits>
+#include <utility>
 
+#include "vrto3dlib/hotkey_table.h"
+#include "vrto3dlib/input_latency.hpp" // HotkeyLatency
+#include "vrto3dlib/input_state.h"   // InputFrame
 #include "vrto3dlib/key_codes.h"     // HOLD / TOGGLE / SWITCH key-type constants
 #include "vrto3dlib/stereo_config.h"
+#include "vrto3dlib/trace.hpp"
 
 namespace vrto3d {
 
@@ -49,18 +63,57 @@ inline bool HotkeyNearlyEqual(float a, float b, float maxDelta = 0.001f)
     return std::fabs(a - b) <= maxDelta;
 }
 
-// Evaluate the user_settings[] preset hotkeys. `is_down(vk)` reports keyboard
-// key state; `got_xinput`/`xstate` carry the merged gamepad button mask.
-// Line-for-line the former per-platform body — keep behavior identical.
-template <typename IsDownFn>
-inline std::string ApplyUserSettingsHotkeysImpl(
+namespace detail {
+// Backend concept (duck-typed): getDepth/getConv/getFov() -> float,
+// setDepth/setConv/setFov(float), and optionally onApplied().
+template <typename B, typename = void>
+struct IsHotkeyBackend : std::false_type {};
+template <typename B>
+struct IsHotkeyBackend<B, std::void_t<
+    decltype(static_cast<float>(std::declval<B&>().getDepth())),
+    decltype(static_cast<float>(std::declval<B&>().getConv())),
+    decltype(static_cast<float>(std::declval<B&>().getFov())),
+    decltype(std::declval<B&>().setDepth(0.0f)),
+    decltype(std::declval<B&>().setConv(0.0f)),
+    decltype(std::declval<B&>().setFov(0.0f))>> : std::true_type {};
+
+template <typename B, typename = void>
+struct HasOnApplied : std::false_type {};
+template <typename B>
+struct HasOnApplied<B, std::void_t<decltype(std::declval<B&>().onApplied())>> : std::true_type {};
+
+template <typename B>
+inline void NotifyApplied(B& b)
+{
+    if constexpr (HasOnApplied<B>::value) b.onApplied();
+}
+
+// DepthConvBackend seen through the backend concept; every call is still
+// an indirect call through the struct's function pointers.
+struct FnPtrBackend {
+    const DepthConvBackend& fn;
+    float getDepth() const { return fn.getDepth(fn.ctx); }
+    float getConv() const { return fn.getConv(fn.ctx); }
+    float getFov() const { return fn.getFov(fn.ctx); }
+    void setDepth(float v) const { fn.setDepth(fn.ctx, v); }
+    void setConv(float v) const { fn.setConv(fn.ctx, v); }
+    void setFov(float v) const { fn.setFov(fn.ctx, v); }
+    void onApplied() const { if (fn.onApplied) fn.onApplied(fn.ctx); }
+};
+
+// Shared body of both overloads. `edge_ns` is the input-edge time of the
+// frame being evaluated (0 = unknown); it is recorded at the onApplied point.
+template <typename Backend, typename IsDownFn>
+inline std::string EvaluateUserSettingsHotkeys(
     StereoDisplayDriverConfiguration& cfg, bool got_xinput, uint32_t xstate,
-    const DepthConvBackend& b, IsDownFn is_down, float maxDelta = 0.001f)
+    Backend& b, IsDownFn is_down, float maxDelta, uint64_t edge_ns)
 {
+    VRTO3D_TRACE_ZONE("hotkeys.rows");
     std::string storeMsg;
 
     auto applied = [&]() {
-        if (b.onApplied) b.onApplied(b.ctx);
+        NotifyApplied(b);
+        input::HotkeyLatency().RecordEdge(edge_ns);
     };
 
     for (size_t i = 0; i < cfg.num_user_settings; ++i) {
@@ -91,9 +144,9 @@ inline std::string ApplyUserSettingsHotkeysImpl(
             return f;
         };
         auto applyPreset = [&](size_t k) {
-            b.setDepth(b.ctx, getD(k));
-            b.setConv(b.ctx,  getC(k));
-            b.setFov(b.ctx,   getF(k));
+            b.setDepth(getD(k));
+            b.setConv(getC(k));
+            b.setFov(getF(k));
             applied();
         };
 
@@ -107,17 +160,17 @@ inline std::string ApplyUserSettingsHotkeysImpl(
             const int32_t kt = cfg.user_key_type[i];
 
             if (kt == HOLD && !cfg.was_held[i]) {
-                cfg.prev_depth[i] = b.getDepth(b.ctx);
-                cfg.prev_convergence[i] = b.getConv(b.ctx);
-                cfg.prev_fov[i] = b.getFov(b.ctx);
+                cfg.prev_depth[i] = b.getDepth();
+                cfg.prev_convergence[i] = b.getConv();
+                cfg.prev_fov[i] = b.getFov();
                 cfg.was_held[i] = true;
                 applyPreset(hold_idx);
             } else if (kt == TOGGLE && cfg.sleep_count[i] < 1) {
                 cfg.sleep_count[i] = cfg.sleep_count_max;
 
-                const float curD = b.getDepth(b.ctx);
-                const float curC = b.getConv(b.ctx);
-                const float curF = b.getFov(b.ctx);
+                const float curD = b.getDepth();
+                const float curC = b.getConv();
+                const float curF = b.getFov();
 
                 const bool matches =
                     HotkeyNearlyEqual(curD, getD(idx), maxDelta) &&
@@ -129,9 +182,9 @@ inline std::string ApplyUserSettingsHotkeysImpl(
                     cfg.user_preset_index[i] = idx;
                     applyPreset(idx);
                 } else if (matches) {
-                    b.setDepth(b.ctx, cfg.prev_depth[i]);
-                    b.setConv(b.ctx,  cfg.prev_convergence[i]);
-                    b.setFov(b.ctx,   cfg.prev_fov[i]);
+                    b.setDepth(cfg.prev_depth[i]);
+                    b.setConv(cfg.prev_convergence[i]);
+                    b.setFov(cfg.prev_fov[i]);
                     applied();
                 } else {
                     cfg.prev_depth[i] = curD;
@@ -146,9 +199,9 @@ inline std::string ApplyUserSettingsHotkeysImpl(
             }
         } else if (cfg.user_key_type[i] == HOLD && cfg.was_held[i]) {
             cfg.was_held[i] = false;
-            b.setDepth(b.ctx, cfg.prev_depth[i]);
-            b.setConv(b.ctx, cfg.prev_convergence[i]);
-            b.setFov(b.ctx, cfg.prev_fov[i]);
+            b.setDepth(cfg.prev_depth[i]);
+            b.setConv(cfg.prev_convergence[i]);
+            b.setFov(cfg.prev_fov[i]);
             applied();
         }
     }
@@ -156,4 +209,241 @@ inline std::string ApplyUserSettingsHotkeysImpl(
     return storeMsg;
 }
 
+// Edge-triggered evaluation of a compiled table. Same per-row semantics as
+// EvaluateUserSettingsHotkeys(); the TOGGLE/SWITCH debounce is a frame
+// deadline instead of a per-row countdown, so idle frames touch no rows.
+template <typename Backend>
+inline std::string EvaluateHotkeyTable(
+    StereoDisplayDriverConfiguration& cfg, const input::InputFrame& frame,
+    Backend& b, float maxDelta)
+{
+    VRTO3D_TRACE_ZONE("hotkeys.table");
+    std::string storeMsg;
+    HotkeyTable& t = cfg.hotkey_table;
+    const uint64_t now = ++t.frame;
+
+    const std::bitset<256> keys = frame.keys & t.key_mask;
+    const uint64_t pad = frame.pad.connected
+        ? ((frame.XInputButtons() & t.pad_mask) | (1ull << 32)) : 0;
+    if (t.primed && now < t.wake_frame && pad == t.last_pad && keys == t.last_keys) {
+        VRTO3D_TRACE_COUNT("hotkeys.idle_frames", 1);
+        return storeMsg;
+    }
+    t.primed = true;
+    t.last_keys = keys;
+    t.last_pad = pad;
+    t.wake_frame = HotkeyTable::kNever;
+
+    const uint32_t xstate = static_cast<uint32_t>(pad);
+    const uint64_t debounce = static_cast<uint64_t>((std::max)(cfg.sleep_count_max, 0));
+
+    auto applied = [&]() {
+        NotifyApplied(b);
+        input::HotkeyLatency().RecordEdge(frame.edge_time_ns);
+    };
+    auto setAll = [&](float d, float c, float f) {
+        b.setDepth(d);
+        b.setConv(c);
+        b.setFov(f);
+        applied();
+    };
+
+    for (size_t r = 0; r < t.Size(); ++r) {
+        const int32_t key = t.key[r];
+        const bool pressed = t.is_pad[r]
+            ? (pad != 0 && (xstate & static_cast<uint32_t>(key)) == static_cast<uint32_t>(key))
+            : (key >= 0 && key < 256 && keys[static_cast<size_t>(key)]);
+
+        const size_t base = t.preset_begin[r];
+        const size_t presets = t.preset_count[r];
+        auto applyPreset = [&](size_t k) {
+            const float f = t.fov[base + k];
+            setAll(t.depth[base + k], t.convergence[base + k], f <= 0.0f ? cfg.fov : f);
+        };
+        auto savePrev = [&]() {
+            t.prev_depth[r] = b.getDepth();
+            t.prev_convergence[r] = b.getConv();
+            t.prev_fov[r] = b.getFov();
+        };
+        auto setIndex = [&](size_t k) {
+            t.preset_index[r] = static_cast<uint32_t>(k);
+            if (t.row[r] < cfg.user_preset_index.size())
+                cfg.user_preset_index[t.row[r]] = k;
+        };
+
+        const int32_t kt = t.type[r];
+        if (kt == HOLD) {
+            if (pressed && !t.held[r]) {
+                savePrev();
+                t.held[r] = 1;
+                applyPreset(0);
+            } else if (!pressed && t.held[r]) {
+                t.held[r] = 0;
+                setAll(t.prev_depth[r], t.prev_convergence[r], t.prev_fov[r]);
+            }
+            continue;
+        }
+        if (!pressed || (kt != TOGGLE && kt != SWITCH))
+            continue;
+
+        if (now >= t.ready_frame[r]) {
+            t.ready_frame[r] = now + debounce;
+            const size_t idx = t.preset_index[r];
+            if (kt == TOGGLE) {
+                const float f = t.fov[base + idx];
+                const bool matches =
+                    HotkeyNearlyEqual(b.getDepth(), t.depth[base + idx], maxDelta) &&
+                    HotkeyNearlyEqual(b.getConv(), t.convergence[base + idx], maxDelta) &&
+                    HotkeyNearlyEqual(b.getFov(), f <= 0.0f ? cfg.fov : f, maxDelta);
+                if (matches && presets > 1) {
+                    setIndex((idx + 1) % presets);
+                    applyPreset(t.preset_index[r]);
+                } else if (matches) {
+                    setAll(t.prev_depth[r], t.prev_convergence[r], t.prev_fov[r]);
+                } else {
+                    savePrev();
+                    applyPreset(idx);
+                }
+            } else {
+                applyPreset(idx);
+                setIndex((idx + 1) % presets);
+            }
+        }
+        // Held: wake again when the debounce lets this row repeat.
+        t.wake_frame = (std::min)(t.wake_frame, t.ready_frame[r]);
+    }
+
+    return storeMsg;
+}
+}  // namespace detail
+
+// Compile the user_settings[] rows into cfg.hotkey_table. JsonManager calls
+// this after loading a profile; after editing the user_* rows, bump
+// cfg.user_settings_generation and the next frame recompiles.
+// Rows the row walk would skip (no depth preset, short vectors) are dropped.
+inline void CompileHotkeyTable(StereoDisplayDriverConfiguration& cfg)
+{
+    HotkeyTable t;
+    const size_t n = cfg.num_user_settings;
+    const bool shaped =
+        cfg.user_load_key.size() >= n && cfg.user_key_type.size() >= n &&
+        cfg.load_xinput.size() >= n && cfg.user_depth.size() >= n &&
+        cfg.user_convergence.size() >= n && cfg.user_fov.size() >= n;
+
+    for (size_t i = 0; shaped && i < n; ++i) {
+        const std::vector<float>& depth = cfg.user_depth[i];
+        if (depth.empty()) continue;
+        const std::vector<float>& conv = cfg.user_convergence[i];
+        const std::vector<float>& fov = cfg.user_fov[i];
+
+        const size_t presets = depth.size();
+        const size_t begin = t.depth.size();
+        for (size_t k = 0; k < presets; ++k) {
+            t.depth.push_back(depth[k]);
+            t.convergence.push_back(k < conv.size() ? conv[k] : (conv.empty() ? 1.0f : conv.back()));
+            t.fov.push_back(k < fov.size() ? fov[k] : (fov.empty() ? 0.0f : fov.back()));
+        }
+
+        const int32_t key = cfg.user_load_key[i];
+        const bool pad = cfg.load_xinput[i];
+        if (pad)
+            t.pad_mask |= static_cast<uint32_t>(key);
+        else if (key >= 0 && key < 256)
+            t.key_mask.set(static_cast<size_t>(key));
+
+        size_t idx = i < cfg.user_preset_index.size() ? cfg.user_preset_index[i] : 0;
+        if (idx >= presets) idx = 0;
+
+        t.row.push_back(static_cast<uint32_t>(i));
+        t.key.push_back(key);
+        t.is_pad.push_back(pad ? 1 : 0);
+        t.type.push_back(cfg.user_key_type[i]);
+        t.preset_begin.push_back(static_cast<uint32_t>(begin));
+        t.preset_count.push_back(static_cast<uint32_t>(presets));
+        t.preset_index.push_back(static_cast<uint32_t>(idx));
+    }
+
+    const size_t rows = t.row.size();
+    t.held.assign(rows, 0);
+    t.ready_frame.assign(rows, 0);
+    t.prev_depth.assign(rows, 0.0f);
+    t.prev_convergence.assign(rows, 0.0f);
+    t.prev_fov.assign(rows, 0.0f);
+    t.source_rows = n;
+    t.source_generation = cfg.user_settings_generation;
+    t.compiled = true;
+    cfg.hotkey_table = std::move(t);
+}
+
+namespace detail {
+// True when the compiled table drives this frame. A table built from older
+// rows is rebuilt first, so an edit applies on the next frame instead of
+// evaluating stale presets or keys.
+inline bool UseHotkeyTable(StereoDisplayDriverConfiguration& cfg)
+{
+    const HotkeyTable& t = cfg.hotkey_table;
+    if (!t.compiled) return false;
+    if (t.source_generation != cfg.user_settings_generation || t.source_rows != cfg.num_user_settings)
+        CompileHotkeyTable(cfg);
+    return true;
+}
+}  // namespace detail
+
+// Evaluate the user_settings[] preset hotkeys. `is_down(vk)` reports keyboard
+// key state; `got_xinput`/`xstate` carry the merged gamepad button mask.
+// Line-for-line the former per-platform body — keep behavior identical. This
+// walks the user_* rows directly and never uses the compiled table.
+template <typename IsDownFn>
+inline std::string ApplyUserSettingsHotkeysImpl(
+    StereoDisplayDriverConfiguration& cfg, bool got_xinput, uint32_t xstate,
+    const DepthConvBackend& b, IsDownFn is_down, float maxDelta = 0.001f)
+{
+    detail::FnPtrBackend fb{b};
+    return detail::EvaluateUserSettingsHotkeys(cfg, got_xinput, xstate, fb, is_down, maxDelta, 0);
+}
+
+// Same evaluation against a frame captured once (input::Snapshot or
+// SnapshotInputFrame): one synchronization point, and all rows agree. Uses
+// the compiled table once CompileHotkeyTable() has run, so a caller that
+// edits the user_* rows must ++cfg.user_settings_generation before the next
+// call; until then the old bindings stay in effect.
+inline std::string ApplyUserSettingsHotkeysImpl(
+    StereoDisplayDriverConfiguration& cfg, const input::InputFrame& frame,
+    const DepthConvBackend& b, float maxDelta = 0.001f)
+{
+    detail::FnPtrBackend fb{b};
+    if (detail::UseHotkeyTable(cfg))
+        return detail::EvaluateHotkeyTable(cfg, frame, fb, maxDelta);
+    return detail::EvaluateUserSettingsHotkeys(
+        cfg, frame.pad.connected, frame.XInputButtons(), fb,
+        [&frame](int vk) { return frame.IsKeyDown(vk); }, maxDelta, frame.edge_time_ns);
+}
+
+// Overloads for a concrete backend object (e.g. the driver's display
+// component) with getDepth()/setDepth(float)/... members: the calls are
+// direct, so they inline into the evaluator and the HotkeyNearlyEqual
+// comparisons fold. DepthConvBackend itself never matches these. Same
+// table and generation rules as the DepthConvBackend pair above.
+template <typename Backend, typename IsDownFn,
+          std::enable_if_t<detail::IsHotkeyBackend<Backend>::value, int> = 0>
+inline std::string ApplyUserSettingsHotkeysImpl(
+    StereoDisplayDriverConfiguration& cfg, bool got_xinput, uint32_t xstate,
+    Backend& b, IsDownFn is_down, float maxDelta = 0.001f)
+{
+    return detail::EvaluateUserSettingsHotkeys(cfg, got_xinput, xstate, b, is_down, maxDelta, 0);
+}
+
+template <typename Backend,
+          std::enable_if_t<detail::IsHotkeyBackend<Backend>::value, int> = 0>
+inline std::string ApplyUserSettingsHotkeysImpl(
+    StereoDisplayDriverConfiguration& cfg, const input::InputFrame& frame,
+    Backend& b, float maxDelta = 0.001f)
+{
+    if (detail::UseHotkeyTable(cfg))
+        return detail::EvaluateHotkeyTable(cfg, frame, b, maxDelta);
+    return detail::EvaluateUserSettingsHotkeys(
+        cfg, frame.pad.connected, frame.XInputButtons(), b,
+        [&frame](int vk) { return frame.IsKeyDown(vk); }, maxDelta, frame.edge_time_ns);
+}
+
 }  // namespace vrto3d
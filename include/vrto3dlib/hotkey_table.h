@@ -0,0 +1,72 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+// Compiled form of the user_settings[] hotkey rows, built from the parallel
+// user_* vectors by CompileHotkeyTable() (hotkey_eval.hpp) whenever a profile
+// is loaded. The evaluator rebuilds it only when cfg.user_settings_generation
+// or num_user_settings differs from what it was built at, so an in-place row
+// edit without a generation bump keeps evaluating the old keys and presets.
+// One entry per evaluable row in flat parallel arrays; presets of all rows
+// share one flat depth/convergence/FoV pool addressed by
+// [preset_begin, preset_begin + preset_count).
+//
+// The evaluator keeps the previous frame's referenced-key/button state here
+// and skips the row walk entirely while that is unchanged and no held
+// TOGGLE/SWITCH row is due to repeat. Debounce is ready_frame, counted in
+// evaluated frames; cfg.sleep_count is neither read nor updated on this path.
+
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+struct HotkeyTable {
+    static constexpr uint64_t kNever = UINT64_MAX;
+
+    // Set by CompileHotkeyTable(); until then the evaluator walks cfg rows.
+    bool     compiled = false;
+    size_t   source_rows = 0;      // num_user_settings the table was built from
+    uint64_t source_generation = 0;  // user_settings_generation it was built at
+    std::vector<uint32_t> row;     // index into the user_* vectors
+    std::vector<int32_t>  key;     // VK, or XInput button mask when is_pad
+    std::vector<uint8_t>  is_pad;
+    std::vector<int32_t>  type;    // HOLD / TOGGLE / SWITCH
+    std::vector<uint32_t> preset_begin;
+    std::vector<uint32_t> preset_count;
+    std::vector<float>    depth;   // flat preset pool
+    std::vector<float>    convergence;
+    std::vector<float>    fov;     // 0 = "keep active FoV" sentinel, resolved on apply
+    std::bitset<256> key_mask;     // union of referenced VKs
+    uint32_t pad_mask = 0;         // union of referenced pad buttons
+
+    // Per-row runtime state.
+    std::vector<uint32_t> preset_index;
+    std::vector<uint8_t>  held;
+    std::vector<uint64_t> ready_frame;  // TOGGLE/SWITCH debounce: fires at frame >= this
+    std::vector<float>    prev_depth;
+    std::vector<float>    prev_convergence;
+    std::vector<float>    prev_fov;
+
+    // Edge-trigger state.
+    uint64_t frame = 0;
+    std::bitset<256> last_keys;     // frame.keys & key_mask
+    uint64_t last_pad = 0;          // (buttons & pad_mask) | connected << 32
+    uint64_t wake_frame = 0;        // next frame a held row may repeat (kNever = none)
+    bool     primed = false;        // last_* valid
+
+    size_t Size() const { return row.size(); }
+};
@@ -0,0 +1,158 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+// Input timebase and the opt-in input-to-apply latency histogram.
+//
+// Every `time_ns` in input_state.h is on InputClockNs(): CLOCK_MONOTONIC on
+// Linux (evdev devices are switched to it with EVIOCSCLOCKID), QPC on
+// Windows. The hotkey evaluator records "input edge -> preset applied" into
+// HotkeyLatency() at its onApplied point; recording is off until enabled.
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <ctime>
+#endif
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace vrto3d::input {
+
+inline uint64_t InputClockNs()
+{
+#ifdef _WIN32
+    static const uint64_t freq = [] {
+        LARGE_INTEGER f;
+        QueryPerformanceFrequency(&f);
+        return static_cast<uint64_t>(f.QuadPart);
+    }();
+    LARGE_INTEGER c;
+    QueryPerformanceCounter(&c);
+    const uint64_t ticks = static_cast<uint64_t>(c.QuadPart);
+    return (ticks / freq) * 1000000000ull + (ticks % freq) * 1000000000ull / freq;
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+#endif
+}
+
+struct LatencyStats {
+    uint64_t samples = 0;
+    uint32_t p50_us = 0;
+    uint32_t p99_us = 0;
+    uint32_t max_us = 0;
+    uint64_t within_budget = 0;  // samples <= the budget passed to Stats()
+};
+
+//-----------------------------------------------------------------------------
+// Purpose: Fixed 100 us buckets up to 50 ms plus an overflow bucket. Record()
+//          is a couple of relaxed atomics, so any thread may call it.
+//-----------------------------------------------------------------------------
+class LatencyHistogram {
+public:
+    static constexpr uint32_t kBucketUs = 100;
+    static constexpr size_t kBuckets = 500;
+
+    void SetEnabled(bool on) { enabled_.store(on, std::memory_order_relaxed); }
+    bool Enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    // Record now - edge_ns once per distinct input edge: a held TOGGLE key
+    // re-applies every sleep_count_max frames from the same edge, and those
+    // repeats say nothing about input latency. 0 = unknown timestamp.
+    void RecordEdge(uint64_t edge_ns)
+    {
+        if (!Enabled() || edge_ns == 0 ||
+            last_edge_.exchange(edge_ns, std::memory_order_relaxed) == edge_ns) {
+            return;
+        }
+        const uint64_t now = InputClockNs();
+        Record(now > edge_ns ? static_cast<uint32_t>(std::min<uint64_t>((now - edge_ns) / 1000, UINT32_MAX)) : 0);
+    }
+
+    void Record(uint32_t us)
+    {
+        const size_t bucket = std::min<size_t>(us / kBucketUs, kBuckets);
+        counts_[bucket].fetch_add(1, std::memory_order_relaxed);
+        uint32_t prev = max_us_.load(std::memory_order_relaxed);
+        while (us > prev && !max_us_.compare_exchange_weak(prev, us, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Percentiles are bucket upper bounds (100 us resolution). A typical
+    // budget is one display frame, e.g. 11111 us at 90 Hz.
+    LatencyStats Stats(uint32_t budget_us) const
+    {
+        std::array<uint64_t, kBuckets + 1> counts;
+        LatencyStats s;
+        for (size_t i = 0; i <= kBuckets; ++i) {
+            counts[i] = counts_[i].load(std::memory_order_relaxed);
+            s.samples += counts[i];
+            if ((i + 1) * kBucketUs <= budget_us) {
+                s.within_budget += counts[i];
+            }
+        }
+        s.max_us = max_us_.load(std::memory_order_relaxed);
+        s.p50_us = Percentile(counts, s.samples, 0.50, s.max_us);
+        s.p99_us = Percentile(counts, s.samples, 0.99, s.max_us);
+        return s;
+    }
+
+    void Reset()
+    {
+        for (auto& c : counts_) {
+            c.store(0, std::memory_order_relaxed);
+        }
+        max_us_.store(0, std::memory_order_relaxed);
+        last_edge_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static uint32_t Percentile(const std::array<uint64_t, kBuckets + 1>& counts,
+                               uint64_t total, double q, uint32_t max_us)
+    {
+        if (total == 0) {
+            return 0;
+        }
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(q * static_cast<double>(total) + 0.5));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return (std::min)(static_cast<uint32_t>((i + 1) * kBucketUs), max_us);
+            }
+        }
+        return max_us;  // in the overflow bucket
+    }
+
+    std::atomic<bool> enabled_{false};
+    std::atomic<uint64_t> last_edge_{0};
+    std::atomic<uint32_t> max_us_{0};
+    std::array<std::atomic<uint64_t>, kBuckets + 1> counts_{};
+};
+
+// Input edge -> user-preset hotkey applied (see ApplyUserSettingsHotkeysImpl).
+inline LatencyHistogram& HotkeyLatency()
+{
+    static LatencyHistogram histogram;
+    return histogram;
+}
+
+}  // namespace vrto3d::input
@@ -16,20 +16,31 @@
  */
 #pragma once
 
-// Portable global-input API for the Linux port. Semantics mirror the Win32
+// Portable global-input API. Semantics mirror the Win32
 // calls the driver uses (GetAsyncKeyState / XInputGetState / GetCursorPos):
 // state is *global* — the driver lives in vrserver and the game window has
 // focus, so a focused-window input model would never see anything.
 //
-// Linux backend: evdev (/dev/input/event*) reader thread with inotify
-// hotplug. Requires the user to be in the `input` group; PermissionOk()
-// reports whether any keyboard device could be opened.
+// Linux backend (linux_input.cpp): evdev (/dev/input/event*) reader thread
+// with inotify hotplug. Requires the user to be in the `input` group;
+// PermissionOk() reports whether any keyboard device could be opened.
+//
+// Windows backend (win32_input.cpp): Raw Input (RIDEV_INPUTSINK) on a
+// message-only window, gamepads from the XInput poller in win32_helper.hpp.
+// PermissionOk() reports whether the Raw Input registration succeeded.
 //
 // Key identity: plain int VK codes (see key_codes.h) — the same numeric
 // currency the config/profile system stores. The backend translates VK ->
 // evdev KEY_* internally.
+//
+// Timestamps: every time_ns is on input::InputClockNs() (input_latency.hpp),
+// taken from the kernel's evdev event time where available; 0 = unknown.
 
+#include <bitset>
 #include <cstdint>
+#include <string>
+
+#include "vrto3dlib/key_codes.h"
 
 namespace vrto3d::input {
 
@@ -44,6 +55,7 @@ struct GamepadState {
     int16_t  sThumbLY = 0;
     int16_t  sThumbRX = 0;
     int16_t  sThumbRY = 0;
+    uint64_t time_ns = 0;        // newest pad event folded in (not in XINPUT_GAMEPAD)
 };
 
 struct MouseState {
@@ -51,16 +63,72 @@ struct MouseState {
     int32_t y = 0;
     int32_t wheel = 0;           // accumulated detents since last GetMouseState
     bool    left = false, right = false, middle = false, x1 = false, x2 = false;
+    uint64_t time_ns = 0;        // newest motion/button event
 };
 
 // Edge events for the OSD (ImGui needs press/release edges + text).
 struct KeyEvent {
     int  vk = 0;                 // 0 when the key has no VK mapping
-    uint16_t evdev_code = 0;
+    uint16_t evdev_code = 0;     // Linux only (0 on Windows)
     bool down = false;
+    uint64_t time_ns = 0;        // kernel event time
+};
+
+// One coherent view of all level-triggered state, taken once per frame with
+// Snapshot() so every hotkey row evaluated in that frame agrees.
+struct InputFrame {
+    std::bitset<256> keys;       // VK-indexed; VK_SHIFT/CONTROL/MENU = either side
+    GamepadState pad;            // merged, as GetGamepadState()
+    MouseState mouse;            // wheel stays 0: detents belong to GetMouseState()
+    int pending_key_events = 0;  // edges waiting for DrainKeyEvents()
+    uint64_t edge_time_ns = 0;   // newest key or pad-button edge in this frame
+
+    bool IsKeyDown(int vk) const { return vk >= 0 && vk < 256 && keys[vk]; }
+
+    // Pad buttons with the triggers folded in, as GetXInputButtonState()
+    // reports them; 0 when no pad is connected.
+    uint32_t XInputButtons() const
+    {
+        if (!pad.connected) {
+            return 0;
+        }
+        uint32_t buttons = pad.wButtons;
+        if (pad.bLeftTrigger > XINPUT_GAMEPAD_TRIGGER_THRESHOLD)
+            buttons |= XINPUT_GAMEPAD_LEFT_TRIGGER;
+        if (pad.bRightTrigger > XINPUT_GAMEPAD_TRIGGER_THRESHOLD)
+            buttons |= XINPUT_GAMEPAD_RIGHT_TRIGGER;
+        return buttons;
+    }
+};
+
+// Device classes for InputOptions allow/deny masks. A node can be several at
+// once (keyboards with a built-in touchpad, pads with a motion sensor).
+enum DeviceClass : uint32_t {
+    kDeviceKeyboard = 1u << 0,
+    kDeviceMouse    = 1u << 1,
+    kDeviceGamepad  = 1u << 2,
+    kDeviceTouchpad = 1u << 3,   // INPUT_PROP_BUTTONPAD / pointer with MT axes
+    kDeviceSensor   = 1u << 4,   // INPUT_PROP_ACCELEROMETER (e.g. Steam Deck IMU)
+    kDeviceAll      = 0x1Fu,
 };
 
-// Start the evdev reader thread. Idempotent. Returns false when no input
+// Reader tuning for high-rate devices (8 kHz mice, gyros). Set before Start();
+// the class masks apply to devices opened afterwards.
+struct InputOptions {
+    // Apply REL/ABS motion once per drained batch instead of per event. Key
+    // edges still see the cursor / pad position reached at their place in
+    // the stream.
+    bool     coalesce_motion = true;
+    // Cap reader wakeups per second (0 = unlimited). Events queue in the
+    // kernel meanwhile, so this adds up to 1/rate of input latency.
+    int32_t  max_rate_hz = 0;
+    uint32_t allow_classes = kDeviceAll;   // roles a device may be used for
+    uint32_t deny_classes = kDeviceTouchpad | kDeviceSensor;  // skip outright
+};
+
+void Configure(const InputOptions& options);
+
+// Start the backend's input thread. Idempotent. Returns false when no input
 // devices could be opened (permissions) — the driver keeps running, hotkeys
 // are just dead; surface this to the user via OSD/log.
 bool Start();
@@ -72,14 +140,45 @@ bool IsKeyDown(int vk);
 bool IsCtrlDown();               // VK_CONTROL (either side)
 
 GamepadState GetGamepadState();  // merged across connected pads
+
+// Per-pad slots, for setups where pads must not be merged (a wheel plus a
+// pad). A pad keeps its slot from connect to disconnect: the lowest free
+// slot on Linux, the XInput user index on Windows. States use the same
+// XINPUT_GAMEPAD layout as the merged view, which stays derived from them.
+constexpr int kMaxPads = 4;
+
+uint32_t GetConnectedPads();          // bit per occupied slot
+GamepadState GetPadState(int slot);   // disconnected for empty/invalid slots
+std::string GetPadName(int slot);     // device name, "" for an empty slot
+// Slot state at `t_ns` (InputClockNs), interpolated from the slot's recent
+// reports (PadHistory::At); PadReportIntervalNs() is the report spacing.
+GamepadState SamplePad(int slot, uint64_t t_ns);
+uint64_t PadReportIntervalNs(int slot);
+// Up to `max_samples` recent reports of a slot, oldest first.
+int GetPadHistory(int slot, GamepadState* out, int max_samples);
+
+// Capture keys, pad, mouse and the pending edge count in one lock-free read.
+// Prefer SnapshotInputFrame() (linux_helper.hpp / win32_helper.hpp), which
+// falls back to polling on Windows when the backend is not running.
+void Snapshot(InputFrame& out);
 MouseState   GetMouseState();
 void SetMouseRegion(int32_t width, int32_t height);
 void WarpMouse(int32_t x, int32_t y);
 
-// Edge-triggered drain for the OSD input pump. Returns count written.
+// Drop counters for the edge-event and typed-text queues (the OSD pump fell
+// behind while they were full).
+struct InputStats {
+    uint64_t key_events_dropped = 0;
+    uint64_t typed_bytes_dropped = 0;
+};
+
+// Edge-triggered drain for the OSD input pump. Returns count written. Both
+// drains are lock-free single-consumer reads: call them from one thread.
 int  DrainKeyEvents(KeyEvent* out, int max_events);
 // Drains UTF-8 text typed since last call (xkbcommon-translated). Returns
 // bytes written (NUL-terminated).
 int  DrainTypedUtf8(char* out, int out_size);
 
+InputStats GetInputStats();
+
 }  // namespace vrto3d::input
@@ -16,124 +16,102 @@
  */
 #pragma once
 
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 #include <nlohmann/json.hpp>
 
+#include "vrto3dlib/async_json_writer.h"
 #include "vrto3dlib/stereo_config.h"
 
 
 const std::string DEF_CFG = "default_config.json";
 
+class ProfileWatcher;
+namespace vrto3d { class ProfileIndex; }
+
+// What a hot-reload change set touches, so the driver can refresh only that.
+enum ProfileChangeGroup : uint32_t {
+    kChangeDepthConv  = 1 << 0,  // depth, convergence
+    kChangeProjection = 1 << 1,  // fov, hmd_height, aspect_ratio
+    kChangeShader     = 1 << 2,  // shader_*
+    kChangeHotkeys    = 1 << 3,  // user_settings, key binds
+    kChangeCursor     = 1 << 4,  // cursor options
+    kChangeOther      = 1 << 5,
+};
+
+// One edited profile file, diffed against the live configuration.
+struct ProfileChangeSet {
+    std::string file;
+    bool removed = false;            // file is gone; nothing below is set
+    uint32_t groups = 0;             // ProfileChangeGroup bits
+    std::vector<const char*> keys;   // changed JSON keys; "user_settings" for the rows
+    StereoDisplayDriverConfiguration profile;  // the file as loaded over the live config
+};
+
 class JsonManager {
 public:
     JsonManager();
+    ~JsonManager();
 
     void EnsureDefaultConfigExists();
     void LoadParamsFromJson(StereoDisplayDriverConfiguration& config);
     bool LoadProfileFromJson(const std::string& filename, StereoDisplayDriverConfiguration& config);
-    void SaveProfileToJson(const std::string& filename, StereoDisplayDriverConfiguration& config);
-    void SaveFullConfigToJson(const std::string& filename, StereoDisplayDriverConfiguration& config);
+    // Saves return once the JSON is built; the file is written in the
+    // background (see async_json_writer.h). The future resolves to whether
+    // the write succeeded.
+    std::shared_future<bool> SaveProfileToJson(const std::string& filename, StereoDisplayDriverConfiguration& config);
+    std::shared_future<bool> SaveFullConfigToJson(const std::string& filename, StereoDisplayDriverConfiguration& config);
+
+    // Profile hot-reload. StartProfileWatch() begins watching vrto3dFolder;
+    // each frame (or tick) the driver takes the changed file names, diffs the
+    // active one against its live config, and applies just those fields:
+    //     for (auto& f : json.TakeChangedProfiles())
+    //         if (f == active && json.DiffProfile(f, cfg, changes))
+    //             json.ApplyProfileChanges(changes, cfg);
+    bool StartProfileWatch();
+    std::vector<std::string> TakeChangedProfiles();
+
+    // Whether vrto3dFolder has this profile. With the watch running this is
+    // answered from the in-memory index (see src/profile_index.h), as is a
+    // LoadProfileFromJson() for a missing or already-loaded profile.
+    bool HasProfile(const std::string& filename);
+    bool DiffProfile(const std::string& filename, const StereoDisplayDriverConfiguration& live,
+                     ProfileChangeSet& changes);
+    void ApplyProfileChanges(const ProfileChangeSet& changes, StereoDisplayDriverConfiguration& live);
 
 private:
     
-    // Create the example default JSON
-    nlohmann::ordered_json default_config_ = {
-        {"display_index", 0},
-        {"output_mode", "SbS"},
-        {"eye_swap", false},
-        {"render_width", 1920},
-        {"render_height", 1080},
-        {"display_frequency", 0.0},
-        {"hmd_height", 1.0},
-        {"hmd_x", 0.0},
-        {"hmd_y", 0.0},
-        {"hmd_yaw", 0.0},
-        {"aspect_ratio", 1.77778},
-        {"fov", 90.0},
-        {"depth", 0.1},
-        {"convergence", 1.0},
-        {"async_enable", false},
-        {"disable_hotkeys", false},
-        {"auto_depth_enabled", false},
-        {"auto_depth_target_disparity", 0.005},
-        {"auto_depth_smoothing", 0.08},
-        {"dash_enable", false},
-        {"auto_focus", true},
-        {"auto_exit", false},
-        {"hide_cursor", false},
-        {"lock_cursor", false},
-        {"stereo_cursor", false},
-        {"cursor_depth", 0.0},
-        {"cursor_size", 32},
-        {"pitch_enable", false},
-        {"yaw_enable", false},
-        {"use_open_track", false},
-        {"open_track_port", 4242},
-        {"use_track_filter", false},
-        {"trk_flt_rot_sens", 0.5},
-        {"trk_flt_pos_sens", 0.25},
-        {"trk_flt_rot_dz", 0.03},
-        {"trk_flt_pos_dz", 0.02},
-        {"trk_flt_zoom_smooth", 0.0},
-        {"trk_flt_max_zoom", 10.0},
-        {"sr_tracking_enabled", true},
-        {"sr_filter_pos_mincutoff", 0.08},
-        {"sr_filter_pos_beta", 0.08},
-        {"sr_filter_rot_mincutoff", 0.12},
-        {"sr_filter_rot_beta", 0.01},
-        {"sr_angle_deadzone_deg", 0.2},
-        {"sr_sens_yaw", 1.0},
-        {"sr_sens_pitch", 1.0},
-        {"sr_sens_roll", 1.0},
-        {"sr_max_yaw", 70.0},
-        {"sr_max_pitch", 70.0},
-        {"sr_max_roll", 70.0},
-        {"sr_track_mode", "XYZ_YawPitch"},
-        {"launch_script", ""},
-        {"pose_reset_key", "Numpad7"},
-        {"ctrl_toggle_key", "Numpad8"},
-        {"ctrl_toggle_type", "toggle"},
-        {"pitch_radius", 0.0},
-        {"ctrl_deadzone", 0.05},
-        {"ctrl_sensitivity", 1.0},
-        {"shader_enabled", false},
-        {"shader_lift",  {1.0, 1.0, 1.0}},
-        {"shader_gamma", {1.0, 1.0, 1.0}},
-        {"shader_gain",  {1.0, 1.0, 1.0}},
-        {"shader_curve", 1.0},
-        {"shader_curve_offset_low",  0.0},
-        {"shader_curve_offset_high", 0.0},
-        {"shader_curve_offset_both", 0.0},
-        {"user_settings", {
-            {
-                {"user_load_key", "Numpad1"},
-                {"user_key_type", "switch"},
-                {"user_depth", 0.1},
-                {"user_convergence", 1.0}
-            },
-            {
-                {"user_load_key", "Pad_Guide"},
-                {"user_key_type", "toggle"},
-                {"user_depth", 0.065},
-                {"user_convergence", 1.0}
-            },
-            {
-                {"user_load_key", "Numpad3"},
-                {"user_key_type", "hold"},
-                {"user_depth", 0.065},
-                {"user_convergence", 1.0},
-                {"user_fov", 50.0}
-            }
-        }}
-    };
-    
+    // The example default JSON, built from the schema table in
+    // src/config_schema.h (key order = default_config.json order).
+    nlohmann::ordered_json default_config_;
+
     std::string vrto3dFolder;
-    void writeJsonToFile(const std::string& fileName, const nlohmann::ordered_json& jsonData);
+    // Binary profile cache schema hashes (field layout + defaults), see
+    // src/profile_cache.h.
+    uint64_t params_schema_ = 0;
+    uint64_t profile_schema_ = 0;
+    std::string cachePath(const std::string& fileName, const char* kind) const;
+    std::shared_future<bool> writeJsonToFile(const std::string& fileName, nlohmann::ordered_json jsonData);
+    // Wait out any queued write of fileName before reading or stat'ing it.
+    bool flushPendingWrite(const std::string& fileName);
     nlohmann::json readJsonFromFile(const std::string& fileName);
     nlohmann::ordered_json reorderFillJson(const nlohmann::json& target_json);
     void createFolderIfNotExist(const std::string& path);
     std::vector<std::string> split(const std::string& str, char delimiter);
 
-    template <typename T>
-    T getValue(const nlohmann::json& jsonConfig, const std::string& key);
+    std::unique_ptr<ProfileWatcher> watcher_;
+    // Saves, loads and lookups arrive from the hotkey and OSD threads, so
+    // index_ and changed_profiles_ are only touched under index_mutex_.
+    std::mutex index_mutex_;
+    std::unique_ptr<vrto3d::ProfileIndex> index_;
+    std::vector<std::string> changed_profiles_;  // settled, not yet taken
+    void syncProfileIndex();
+    bool indexTrusted(const std::string& fileName);
+    // Last member: destroyed first, so pending saves land before the rest
+    // of the manager goes away.
+    AsyncJsonWriter writer_;
 };
@@ -21,6 +21,7 @@
 // input backend (vrto3dlib/input_state.h). Include this INSTEAD of
 // win32_helper.hpp on non-Windows — call sites gate on _WIN32.
 
+#include <algorithm>
 #include <atomic>
 #include <cctype>
 #include <cstdint>
@@ -34,10 +35,15 @@
 #include <unordered_set>
 #include <vector>
 
+#include <cerrno>
+#include <chrono>
 #include <dirent.h>
+#include <fcntl.h>
 #include <limits.h>
+#include <poll.h>
 #include <signal.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <unistd.h>
 
 #include "vrto3dlib/debug_log.hpp"
@@ -49,9 +55,55 @@
 //-----------------------------------------------------------------------------
 // Input state (evdev-backed mirrors of GetAsyncKeyState / XInputGetState)
 //-----------------------------------------------------------------------------
-inline auto isDown = [](int vk) { return vrto3d::input::IsKeyDown(vk); };
+// isDown(vk) queries live state; isDown(frame, vk) reads a per-frame
+// InputFrame so a whole frame of hotkey checks agrees.
+struct KeyDownQuery {
+    bool operator()(int vk) const { return vrto3d::input::IsKeyDown(vk); }
+    bool operator()(const vrto3d::input::InputFrame& frame, int vk) const
+    {
+        return frame.IsKeyDown(vk);
+    }
+};
+inline constexpr KeyDownQuery isDown{};
 inline auto isCtrlDown = []() { return vrto3d::input::IsCtrlDown(); };
 
+// Capture this frame's input. `cfg` is unused here (evdev publishes every
+// key); the Windows version samples only the keys cfg references.
+inline void SnapshotInputFrame(const StereoDisplayDriverConfiguration& cfg,
+                               vrto3d::input::InputFrame& frame)
+{
+    (void)cfg;
+    vrto3d::input::Snapshot(frame);
+}
+
+// Map the input_* config keys onto the evdev reader. Call before
+// input::Start(); unknown class names are logged and ignored.
+inline void ConfigureInputFromConfig(const StereoDisplayDriverConfiguration& cfg)
+{
+    using namespace vrto3d::input;
+    const auto mask = [](const std::vector<std::string>& names, uint32_t empty_mask) {
+        if (names.empty()) {
+            return empty_mask;
+        }
+        uint32_t m = 0;
+        for (const std::string& n : names) {
+            if (n == "keyboard")      m |= kDeviceKeyboard;
+            else if (n == "mouse")    m |= kDeviceMouse;
+            else if (n == "gamepad")  m |= kDeviceGamepad;
+            else if (n == "touchpad") m |= kDeviceTouchpad;
+            else if (n == "sensor")   m |= kDeviceSensor;
+            else LOG() << "ConfigureInputFromConfig: unknown device class \"" << n << "\"";
+        }
+        return m;
+    };
+    InputOptions opt;
+    opt.coalesce_motion = cfg.input_coalesce_motion;
+    opt.max_rate_hz = cfg.input_max_rate_hz;
+    opt.allow_classes = mask(cfg.input_allow_classes, kDeviceAll);
+    opt.deny_classes = mask(cfg.input_deny_classes, 0);
+    Configure(opt);
+}
+
 inline bool GetXInputButtonState(uint32_t& outButtons, uint32_t userIndex = 0)
 {
     (void)userIndex;  // evdev backend merges all pads
@@ -169,74 +221,157 @@ inline bool IsProcessRunning(uint32_t pid)
     return stat(path, &st) == 0;
 }
 
-// True when a process with the given comm name exists. `name` may carry a
-// Windows-style ".exe" suffix — it is compared with and without it so the
-// same call sites work for native and Proton processes.
-inline bool IsProcessNameRunning(const char* name)
-{
-    std::string wanted = name;
-    std::string wanted_noexe = wanted;
-    const auto pos = wanted_noexe.rfind(".exe");
-    if (pos != std::string::npos && pos == wanted_noexe.size() - 4)
-        wanted_noexe.resize(pos);
+// One /proc pass: every pid with its comm name (read with a single read(),
+// no stream). Several name queries share one snapshot.
+struct ProcessSnapshot {
+    std::vector<std::pair<uint32_t, std::string>> procs;
 
-    DIR* dir = opendir("/proc");
-    if (!dir)
+    // `name` may carry a Windows-style ".exe" suffix — it is compared with
+    // and without it so the same call sites work for native and Proton
+    // processes.
+    bool Has(const char* name) const
+    {
+        std::string wanted_noexe = name;
+        const auto pos = wanted_noexe.rfind(".exe");
+        if (pos != std::string::npos && pos == wanted_noexe.size() - 4)
+            wanted_noexe.resize(pos);
+        for (const auto& p : procs) {
+            if (p.second == name || p.second == wanted_noexe)
+                return true;
+        }
         return false;
-    bool found = false;
-    while (dirent* e = readdir(dir)) {
-        if (e->d_name[0] < '0' || e->d_name[0] > '9')
-            continue;
-        char path[NAME_MAX + 16];
-        snprintf(path, sizeof(path), "/proc/%s/comm", e->d_name);
-        std::ifstream f(path);
-        std::string comm;
-        if (f && std::getline(f, comm)) {
-            if (comm == wanted || comm == wanted_noexe) {
-                found = true;
-                break;
-            }
+    }
+
+    std::vector<uint32_t> PidsNamed(const char* comm) const
+    {
+        std::vector<uint32_t> pids;
+        for (const auto& p : procs) {
+            if (p.second == comm)
+                pids.push_back(p.first);
         }
+        return pids;
     }
-    closedir(dir);
-    return found;
-}
+};
 
-inline void KillProcessesNamed(const char* comm_name, int sig)
+inline ProcessSnapshot SnapshotProcesses()
 {
+    ProcessSnapshot snap;
     DIR* dir = opendir("/proc");
     if (!dir)
-        return;
+        return snap;
     while (dirent* e = readdir(dir)) {
         if (e->d_name[0] < '0' || e->d_name[0] > '9')
             continue;
         char path[NAME_MAX + 16];
         snprintf(path, sizeof(path), "/proc/%s/comm", e->d_name);
-        std::ifstream f(path);
-        std::string comm;
-        if (f && std::getline(f, comm) && comm == comm_name)
-            kill((pid_t)atoi(e->d_name), sig);
+        const int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            continue;
+        char comm[64];
+        const ssize_t n = read(fd, comm, sizeof(comm));
+        close(fd);
+        if (n <= 0)
+            continue;
+        size_t len = static_cast<size_t>(n);
+        if (comm[len - 1] == '\n')
+            --len;
+        snap.procs.emplace_back((uint32_t)strtoul(e->d_name, nullptr, 10), std::string(comm, len));
     }
     closedir(dir);
+    return snap;
+}
+
+// True when a process with the given comm name exists (see ProcessSnapshot::Has).
+inline bool IsProcessNameRunning(const char* name)
+{
+    return SnapshotProcesses().Has(name);
+}
+
+inline std::vector<uint32_t> KillProcessesNamed(const char* comm_name, int sig)
+{
+    std::vector<uint32_t> pids = SnapshotProcesses().PidsNamed(comm_name);
+    for (uint32_t pid : pids)
+        kill((pid_t)pid, sig);
+    return pids;
+}
+
+// pidfd for `pid` (Linux 5.3+), or -1 with errno set.
+inline int OpenPidFd(uint32_t pid)
+{
+#ifdef SYS_pidfd_open
+    return (int)syscall(SYS_pidfd_open, (pid_t)pid, 0);
+#else
+    (void)pid;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// Block until every pid has exited or `timeout_ms` passes; true if all
+// exited. Exit wakes the poll through each pid's pidfd. Kernels without
+// pidfd_open fall back to a kill(pid, 0) probe every 50ms.
+//-----------------------------------------------------------------------------
+inline bool WaitForProcessesExit(const std::vector<uint32_t>& pids, int timeout_ms)
+{
+    std::vector<struct pollfd> fds;
+    std::vector<uint32_t> probed;
+    for (uint32_t pid : pids) {
+        const int fd = OpenPidFd(pid);
+        if (fd >= 0)
+            fds.push_back({fd, POLLIN, 0});
+        else if (errno != ESRCH)
+            probed.push_back(pid);
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    for (;;) {
+        probed.erase(std::remove_if(probed.begin(), probed.end(), [](uint32_t pid) {
+            return kill((pid_t)pid, 0) != 0 && errno == ESRCH;
+        }), probed.end());
+        if (fds.empty() && probed.empty())
+            return true;
+
+        const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (left <= 0)
+            break;
+        int wait_ms = (int)left;
+        if (!probed.empty() && wait_ms > 50)
+            wait_ms = 50;
+        const int n = poll(fds.data(), fds.size(), wait_ms);
+        if (n < 0 && errno != EINTR)
+            break;
+        for (size_t i = 0; i < fds.size();) {
+            if (fds[i].revents) {
+                close(fds[i].fd);
+                fds[i] = fds.back();
+                fds.pop_back();
+            } else {
+                ++i;
+            }
+        }
+    }
+    for (const auto& f : fds)
+        close(f.fd);
+    return false;
 }
 
 //-----------------------------------------------------------------------------
 // SteamVR shutdown: SIGTERM vrmonitor, wait, escalate; then vrserver if it
-// lingers. Mirrors the taskkill flow in win32_helper.hpp.
+// lingers. Mirrors the taskkill flow in win32_helper.hpp. The waits block on
+// the signalled pids' exit rather than rescanning /proc.
 //-----------------------------------------------------------------------------
 inline void RequestSteamVRShutdown(int graceful_timeout_seconds = 5)
 {
-    const int poll_ms = 500;
     auto kill_named = [&](const char* comm) {
-        KillProcessesNamed(comm, SIGTERM);
-        const int max_polls = (graceful_timeout_seconds * 1000) / poll_ms;
-        for (int i = 0; i < max_polls; ++i) {
-            if (!IsProcessNameRunning(comm)) {
-                LOG() << "auto_exit: " << comm << " exited cleanly after "
-                      << (i * poll_ms) << "ms";
-                return;
-            }
-            std::this_thread::sleep_for(std::chrono::milliseconds(poll_ms));
+        const auto start = std::chrono::steady_clock::now();
+        const std::vector<uint32_t> pids = KillProcessesNamed(comm, SIGTERM);
+        if (WaitForProcessesExit(pids, graceful_timeout_seconds * 1000)) {
+            LOG() << "auto_exit: " << comm << " exited cleanly after "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::steady_clock::now() - start).count() << "ms";
+            return;
         }
         LOG() << "auto_exit: " << comm << " still running after "
               << graceful_timeout_seconds << "s, escalating to SIGKILL";
@@ -251,6 +386,8 @@ inline void RequestSteamVRShutdown(int graceful_timeout_seconds = 5)
     }
 }
 
+// Published by device_provider on ProcessConnected/Disconnected; see the
+// win32_helper.hpp twin. ProcessWatch (process_watch.h) pushes its exit.
 inline std::atomic<uint32_t> g_current_app_pid{0};
 
 inline void RequestSteamVRShutdownWithApp(uint32_t pid, int app_close_timeout_seconds = 30)
@@ -261,14 +398,9 @@ inline void RequestSteamVRShutdownWithApp(uint32_t pid, int app_close_timeout_se
     }
     // No WM_CLOSE equivalent — SIGTERM is the polite ask on Linux.
     kill((pid_t)pid, SIGTERM);
-    const int poll_ms = 500;
-    const int max_polls = (app_close_timeout_seconds * 1000) / poll_ms;
-    for (int i = 0; i < max_polls; ++i) {
-        if (!IsProcessRunning(pid)) {
-            RequestSteamVRShutdown();
-            return;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(poll_ms));
+    if (WaitForProcessesExit({pid}, app_close_timeout_seconds * 1000)) {
+        RequestSteamVRShutdown();
+        return;
     }
     LOG() << "auto_exit: pid " << pid << " still running after "
           << app_close_timeout_seconds << "s, terminating";
@@ -328,7 +460,9 @@ static constexpr const char* kVRto3DLockName = "vrto3d-driver.lock";
 //-----------------------------------------------------------------------------
 // User-settings hotkey evaluation. The evaluator itself is platform-neutral
 // (vrto3dlib/hotkey_eval.hpp, shared with win32_helper.hpp); this wrapper only
-// supplies the Linux key-state query (evdev via input::IsKeyDown).
+// supplies the Linux key-state query (evdev via input::IsKeyDown). The
+// InputFrame overloads run the compiled hotkey table: after editing any
+// user_* row, ++cfg.user_settings_generation or the edit is not seen.
 //-----------------------------------------------------------------------------
 using vrto3d::DepthConvBackend;
 
@@ -343,3 +477,38 @@ inline std::string ApplyUserSettingsHotkeys(
         cfg, got_xinput, xstate, b,
         [](int vk) { return isDown(vk); }, maxDelta);
 }
+
+inline std::string ApplyUserSettingsHotkeys(
+    StereoDisplayDriverConfiguration& cfg,
+    const vrto3d::input::InputFrame& frame,
+    const DepthConvBackend& b,
+    float maxDelta = 0.001f)
+{
+    return vrto3d::ApplyUserSettingsHotkeysImpl(cfg, frame, b, maxDelta);
+}
+
+// Concrete backend (getDepth()/setDepth(float)/... members): direct calls.
+template <typename Backend,
+          std::enable_if_t<vrto3d::detail::IsHotkeyBackend<Backend>::value, int> = 0>
+inline std::string ApplyUserSettingsHotkeys(
+    StereoDisplayDriverConfiguration& cfg,
+    bool got_xinput,
+    uint32_t xstate,
+    Backend& b,
+    float maxDelta = 0.001f)
+{
+    return vrto3d::ApplyUserSettingsHotkeysImpl(
+        cfg, got_xinput, xstate, b,
+        [](int vk) { return isDown(vk); }, maxDelta);
+}
+
+template <typename Backend,
+          std::enable_if_t<vrto3d::detail::IsHotkeyBackend<Backend>::value, int> = 0>
+inline std::string ApplyUserSettingsHotkeys(
+    StereoDisplayDriverConfiguration& cfg,
+    const vrto3d::input::InputFrame& frame,
+    Backend& b,
+    float maxDelta = 0.001f)
+{
+    return vrto3d::ApplyUserSettingsHotkeysImpl(cfg, frame, b, maxDelta);
+}
@@ -20,8 +20,14 @@
 #include <windows.h>
 #include <string>
 
-// Initialize GDI+ (must be called once before any drawing)
+// Initialize GDI+ and the overlay font (must be called once before any drawing)
 void InitGDIPlus();
 
-// Draw text in the given HWND
+// Free the cached text bitmaps and font, then shut GDI+ down. This is the only
+// place they are released: call it after the last DrawOverlayText() and before
+// unloading; if it is skipped they are leaked, never destroyed at exit.
+void ShutdownGDIPlus();
+
+// Draw UTF-8 text in the given HWND. The rasterized text is cached per
+// (text, height), so redrawing unchanged status text is a single blit.
 void DrawOverlayText(HWND hwnd, const std::string& text, int height);
@@ -0,0 +1,215 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+// Per-slot gamepad history for the input_state.h backends. Each pad slot
+// keeps its last kSamples states, stamped with the event time (InputClockNs)
+// they took effect, so a consumer running at its own rate (the head-look
+// thread) can interpolate stick and trigger input between device reports
+// instead of polling faster than the device sends. One writer per slot (the
+// backend's input thread); readers are lock-free and never block it.
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#include "vrto3dlib/input_state.h"
+
+namespace vrto3d::input {
+
+namespace detail {
+
+// GamepadState <-> two words, for publishing under a seqlock.
+inline uint64_t PackPadButtons(const GamepadState& pad)
+{
+    return (pad.connected ? 1ull : 0ull) |
+           (static_cast<uint64_t>(pad.wButtons) << 8) |
+           (static_cast<uint64_t>(pad.bLeftTrigger) << 24) |
+           (static_cast<uint64_t>(pad.bRightTrigger) << 32);
+}
+
+inline uint64_t PackPadSticks(const GamepadState& pad)
+{
+    return static_cast<uint64_t>(static_cast<uint16_t>(pad.sThumbLX)) |
+           (static_cast<uint64_t>(static_cast<uint16_t>(pad.sThumbLY)) << 16) |
+           (static_cast<uint64_t>(static_cast<uint16_t>(pad.sThumbRX)) << 32) |
+           (static_cast<uint64_t>(static_cast<uint16_t>(pad.sThumbRY)) << 48);
+}
+
+inline GamepadState UnpackPad(uint64_t buttons, uint64_t sticks, uint64_t time_ns)
+{
+    GamepadState pad;
+    pad.connected = (buttons & 1u) != 0;
+    pad.wButtons = static_cast<uint16_t>(buttons >> 8);
+    pad.bLeftTrigger = static_cast<uint8_t>(buttons >> 24);
+    pad.bRightTrigger = static_cast<uint8_t>(buttons >> 32);
+    pad.sThumbLX = static_cast<int16_t>(static_cast<uint16_t>(sticks));
+    pad.sThumbLY = static_cast<int16_t>(static_cast<uint16_t>(sticks >> 16));
+    pad.sThumbRX = static_cast<int16_t>(static_cast<uint16_t>(sticks >> 32));
+    pad.sThumbRY = static_cast<int16_t>(static_cast<uint16_t>(sticks >> 48));
+    pad.time_ns = time_ns;
+    return pad;
+}
+
+}  // namespace detail
+
+//-----------------------------------------------------------------------------
+// Purpose: Ring of one slot's recent states under a single seqlock. A push
+//          is three stores; a read copies the ring and retries if a push
+//          landed meanwhile.
+//-----------------------------------------------------------------------------
+class PadHistory {
+public:
+    static constexpr size_t kSamples = 32;  // power of two; ~30 ms at 1 kHz
+
+    // Writer: record `pad` as of pad.time_ns. Redundant pushes are the
+    // caller's to skip.
+    void Push(const GamepadState& pad)
+    {
+        const uint64_t h = head_.load(std::memory_order_relaxed);
+        Sample& s = samples_[h & (kSamples - 1)];
+        seq_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        s.buttons.store(detail::PackPadButtons(pad), std::memory_order_relaxed);
+        s.sticks.store(detail::PackPadSticks(pad), std::memory_order_relaxed);
+        s.time_ns.store(pad.time_ns, std::memory_order_relaxed);
+        head_.store(h + 1, std::memory_order_relaxed);
+        seq_.fetch_add(1, std::memory_order_release);
+    }
+
+    // Newest state; disconnected when nothing was pushed yet.
+    GamepadState Latest() const
+    {
+        GamepadState out;
+        Read([&](uint64_t head) {
+            if (head == 0) {
+                out = GamepadState{};
+                return;
+            }
+            out = Load(samples_[(head - 1) & (kSamples - 1)]);
+        });
+        return out;
+    }
+
+    // Up to `max_samples` newest states, oldest first. Returns the count.
+    int Copy(GamepadState* out, int max_samples) const
+    {
+        int n = 0;
+        Read([&](uint64_t head) {
+            const uint64_t count = (std::min)({head, static_cast<uint64_t>(kSamples),
+                                               static_cast<uint64_t>((std::max)(max_samples, 0))});
+            for (uint64_t i = 0; i < count; ++i) {
+                out[i] = Load(samples_[(head - count + i) & (kSamples - 1)]);
+            }
+            n = static_cast<int>(count);
+        });
+        return n;
+    }
+
+    // State at `t_ns`: buttons as of the last report at or before t, sticks
+    // and triggers interpolated toward the next report. t past the newest
+    // report holds it (no extrapolation); sample at now - IntervalNs() for
+    // output that is smooth rather than stepped.
+    GamepadState At(uint64_t t_ns) const
+    {
+        GamepadState ring[kSamples];
+        const int n = Copy(ring, static_cast<int>(kSamples));
+        if (n == 0) {
+            return GamepadState{};
+        }
+        if (t_ns <= ring[0].time_ns) {
+            return ring[0];
+        }
+        for (int i = 1; i < n; ++i) {
+            if (ring[i].time_ns <= t_ns) continue;
+            const GamepadState& a = ring[i - 1];
+            const GamepadState& b = ring[i];
+            GamepadState out = a;
+            out.time_ns = t_ns;
+            if (a.connected && b.connected && b.time_ns > a.time_ns) {
+                const double f = static_cast<double>(t_ns - a.time_ns) /
+                                 static_cast<double>(b.time_ns - a.time_ns);
+                const auto lerp = [f](auto from, auto to) {
+                    return static_cast<decltype(from)>(std::lround(from + (to - from) * f));
+                };
+                out.bLeftTrigger = lerp(a.bLeftTrigger, b.bLeftTrigger);
+                out.bRightTrigger = lerp(a.bRightTrigger, b.bRightTrigger);
+                out.sThumbLX = lerp(a.sThumbLX, b.sThumbLX);
+                out.sThumbLY = lerp(a.sThumbLY, b.sThumbLY);
+                out.sThumbRX = lerp(a.sThumbRX, b.sThumbRX);
+                out.sThumbRY = lerp(a.sThumbRY, b.sThumbRY);
+            }
+            return out;
+        }
+        return ring[n - 1];
+    }
+
+    // Mean spacing of the connected reports in the ring (0 = fewer than two).
+    uint64_t IntervalNs() const
+    {
+        GamepadState ring[kSamples];
+        const int n = Copy(ring, static_cast<int>(kSamples));
+        int first = n;
+        for (int i = n - 1; i >= 0 && ring[i].connected; --i) {
+            first = i;
+        }
+        if (n - first < 2) {
+            return 0;
+        }
+        return (ring[n - 1].time_ns - ring[first].time_ns) / static_cast<uint64_t>(n - 1 - first);
+    }
+
+private:
+    struct Sample {
+        std::atomic<uint64_t> buttons{0};
+        std::atomic<uint64_t> sticks{0};
+        std::atomic<uint64_t> time_ns{0};
+    };
+
+    static GamepadState Load(const Sample& s)
+    {
+        return detail::UnpackPad(s.buttons.load(std::memory_order_relaxed),
+                                 s.sticks.load(std::memory_order_relaxed),
+                                 s.time_ns.load(std::memory_order_relaxed));
+    }
+
+    template <typename ReadFn>
+    void Read(ReadFn read) const
+    {
+        for (;;) {
+            const uint32_t seq = seq_.load(std::memory_order_acquire);
+            if (seq & 1u) {
+                std::this_thread::yield();
+                continue;
+            }
+            read(head_.load(std::memory_order_relaxed));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == seq) {
+                return;
+            }
+        }
+    }
+
+    std::atomic<uint32_t> seq_{0};
+    std::atomic<uint64_t> head_{0};
+    Sample samples_[kSamples];
+};
+
+}  // namespace vrto3d::input
@@ -0,0 +1,96 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+// Push notification of process exit, so auto_exit and the shutdown paths
+// react the moment a watched app (g_current_app_pid and friends) goes away
+// instead of finding out on the next poll. Linux waits on a pidfd per
+// process from one thread (poll + eventfd); Windows hands each process
+// handle to the thread pool with RegisterWaitForSingleObject.
+//
+//     ProcessWatch::Instance().Watch(pid, [](uint32_t pid) { ... });
+//
+// The callback runs once, on the watch thread (Linux) or a pool thread
+// (Windows), and may call Watch()/Unwatch() itself.
+//
+// Like XInputPoller, Stop() must come from driver shutdown; the destructor
+// only detaches, because joining the watch thread or waiting out pool
+// callbacks from a static destructor would run under the Windows loader lock.
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class ProcessWatch {
+public:
+    using ExitFn = std::function<void(uint32_t pid)>;
+
+    ProcessWatch();
+    ~ProcessWatch();
+
+    ProcessWatch(const ProcessWatch&) = delete;
+    ProcessWatch& operator=(const ProcessWatch&) = delete;
+
+    // Shared instance for the driver-wide pids.
+    static ProcessWatch& Instance();
+
+    // Call `on_exit` when `pid` exits (replacing any earlier watch of it).
+    // A pid that is already gone fires immediately on the caller's thread.
+    // False if the process exists but can't be waited on.
+    bool Watch(uint32_t pid, ExitFn on_exit);
+
+    // Drop the watch. Once this returns its callback won't start, and a run
+    // of it on another thread has finished; from inside that callback it only
+    // drops the watch.
+    void Unwatch(uint32_t pid);
+
+    // Drop every watch and wait out running callbacks (Linux: join the watch
+    // thread). Not from inside a callback. Watch() works again afterwards.
+    void Stop();
+
+private:
+    struct Entry;
+
+    // Runs e->on_exit unless Unwatch() withdrew `e` from firing_ first.
+    void Fire(const std::shared_ptr<Entry>& e);
+    // With mutex_ held: withdraw `pid`'s callbacks that haven't started and
+    // wait for those running on other threads. pid 0 = every pid.
+    void WaitCallbacks(std::unique_lock<std::mutex>& lock, uint32_t pid);
+
+    std::mutex mutex_;
+    std::unordered_map<uint32_t, std::shared_ptr<Entry>> entries_;
+    std::vector<std::shared_ptr<Entry>> firing_;  // taken from entries_, callback due or running
+    std::condition_variable fired_cv_;            // a firing_ entry finished
+
+#ifndef _WIN32
+    void Run();
+    void Wake();
+
+    std::vector<int> retired_fds_;  // closed by the thread, never mid-poll
+    std::thread thread_;
+    int wake_fd_ = -1;
+    bool stop_ = false;
+#else
+    // WAITORTIMERCALLBACK, spelled without <windows.h>.
+    static void __stdcall OnSignaled(void* context, unsigned char timed_out);
+#endif
+};
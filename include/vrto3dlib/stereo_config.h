@@ -20,6 +20,7 @@
 #include <string>
 #include <vector>
 
+#include "vrto3dlib/hotkey_table.h"
 
 // Output format selected for the built-in DX11 presenter (or alternate presenter).
 // Compositor always renders canonical 2W x H SbS upstream; the presenter repacks.
@@ -152,6 +153,16 @@ struct StereoDisplayDriverConfiguration
     float   cursor_depth     = 0.0f;
     int32_t cursor_size      = 32;
 
+    // Linux evdev reader tuning (vrto3d::input::InputOptions, applied by
+    // ConfigureInputFromConfig in linux_helper.hpp; ignored on Windows).
+    //   input_allow_classes / input_deny_classes: device class names
+    //     ("keyboard", "mouse", "gamepad", "touchpad", "sensor"); an empty
+    //     allow list means every class.
+    bool    input_coalesce_motion = true;
+    int32_t input_max_rate_hz     = 0;
+    std::vector<std::string> input_allow_classes;
+    std::vector<std::string> input_deny_classes = {"touchpad", "sensor"};
+
     // Display-correction shader pass — applied to the final composited SbS
     // texture (post-OSD, pre-presenter) to reduce visible crosstalk on
     // displays that suffer from it (e.g. some passive row-interlaced 3D
@@ -243,5 +254,16 @@ struct StereoDisplayDriverConfiguration
     std::vector<float> prev_fov;
     std::vector<bool> was_held;
     std::vector<bool> load_xinput;
+    // Row-walk debounce countdown per row. The compiled hotkey_table keeps
+    // its own (HotkeyTable::ready_frame) and leaves these untouched.
     std::vector<int32_t> sleep_count;
+    // Contract: ++ this after ANY in-place edit of the user_* rows above (a
+    // stored preset, a key rebind, a type change). hotkey_table is rebuilt
+    // only when it (or num_user_settings) changes; a missed bump silently
+    // keeps the old bindings. JsonManager bumps it on load and hot-reload.
+    uint64_t user_settings_generation = 0;
+    // Compiled form of the rows above (CompileHotkeyTable in hotkey_eval.hpp).
+    // JsonManager builds it on profile load; the evaluator rebuilds it when
+    // user_settings_generation has moved on since.
+    HotkeyTable hotkey_table;
 };
@@ -0,0 +1,195 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+// Opt-in hot-path instrumentation. Define VRTO3D_TRACE for the whole build to
+// turn it on; otherwise every macro below expands to nothing (its arguments
+// are not evaluated) and the exporters are no-ops.
+//
+//   VRTO3D_TRACE_ZONE("name");          time the rest of the enclosing block
+//   VRTO3D_TRACE_COUNT("name", delta);  named counter, summed
+//   VRTO3D_TRACE_VALUE("name", value);  named gauge, last value
+//
+// Names must be string literals (they are kept by pointer). Each macro use is
+// a call site with relaxed-atomic aggregates (calls/total/max, or the counter
+// value); every zone end and counter change is also appended to the calling
+// thread's ring of the last kRingEvents records, single writer, no lock.
+// WriteChromeTrace() dumps the rings as chrome://tracing / Perfetto JSON;
+// StartSummary() logs the per-name aggregates through DebugLog every period.
+// Timestamps are on input::InputClockNs(), like the input_state.h events.
+
+#include <chrono>
+#include <string>
+
+#ifdef VRTO3D_TRACE
+#include <atomic>
+#include <cstdint>
+
+#include "vrto3dlib/input_latency.hpp"  // InputClockNs
+#endif
+
+namespace vrto3d::trace {
+
+#ifdef VRTO3D_TRACE
+constexpr bool kEnabled = true;
+#else
+constexpr bool kEnabled = false;
+#endif
+
+// Ring contents as Chrome trace JSON ({"traceEvents":[...]}).
+std::string ChromeTraceJson();
+// ChromeTraceJson() to `path`; false on I/O error or when compiled out.
+bool WriteChromeTrace(const std::string& path);
+
+// Log calls/avg/max/total per zone and value/delta per counter since the
+// previous summary, then start a new period.
+void LogSummary();
+// LogSummary() from a background thread every `period`. Like XInputPoller,
+// StopSummary() must come from driver shutdown.
+void StartSummary(std::chrono::milliseconds period = std::chrono::seconds(10));
+void StopSummary();
+
+#ifdef VRTO3D_TRACE
+
+// Counter sites are summed across same-name sites in the summary; Gauge
+// sites (VRTO3D_TRACE_VALUE) report the most recently set one.
+enum class EventKind : uint8_t { Zone, Counter, Gauge };
+
+struct Event {
+    const char* name;
+    uint64_t ts_ns;   // zone begin / counter change
+    int64_t  value;   // zone duration (ns) / counter value after the change
+    EventKind kind;
+};
+
+//-----------------------------------------------------------------------------
+// Purpose: One thread's recent events. Only the owning thread pushes; the
+//          exporter copies [head - kRingEvents, head) and drops whatever the
+//          owner overwrote meanwhile (seqlock-style re-read of head).
+//-----------------------------------------------------------------------------
+struct ThreadRing {
+    static constexpr size_t kRingEvents = 8192;  // power of two
+
+    uint32_t tid = 0;
+    std::atomic<uint64_t> head{0};
+    Event events[kRingEvents];
+
+    void Push(const Event& e)
+    {
+        const uint64_t h = head.load(std::memory_order_relaxed);
+        events[h & (kRingEvents - 1)] = e;
+        head.store(h + 1, std::memory_order_release);
+    }
+};
+
+// Allocates and registers the calling thread's ring (kept for the process).
+ThreadRing* RegisterThread();
+
+inline ThreadRing& LocalRing()
+{
+    thread_local ThreadRing* ring = RegisterThread();
+    return *ring;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Aggregates of one macro call site; registered on construction
+//-----------------------------------------------------------------------------
+struct Site {
+    Site(const char* site_name, EventKind site_kind);
+
+    const char* name;
+    EventKind kind;
+    std::atomic<uint64_t> calls{0};     // per summary period
+    std::atomic<uint64_t> total_ns{0};
+    std::atomic<uint64_t> max_ns{0};
+    std::atomic<int64_t>  value{0};     // counters: running value
+    std::atomic<uint64_t> set_ns{0};    // gauges: time of the last set
+    int64_t reported = 0;               // counters: value at the last summary
+    Site* next = nullptr;
+};
+
+class ScopedZone {
+public:
+    explicit ScopedZone(Site& site) : site_(site), begin_ns_(input::InputClockNs()) {}
+    ~ScopedZone()
+    {
+        const uint64_t dur = input::InputClockNs() - begin_ns_;
+        site_.calls.fetch_add(1, std::memory_order_relaxed);
+        site_.total_ns.fetch_add(dur, std::memory_order_relaxed);
+        uint64_t prev = site_.max_ns.load(std::memory_order_relaxed);
+        while (dur > prev && !site_.max_ns.compare_exchange_weak(prev, dur, std::memory_order_relaxed)) {
+        }
+        LocalRing().Push({site_.name, begin_ns_, static_cast<int64_t>(dur), EventKind::Zone});
+    }
+    ScopedZone(const ScopedZone&) = delete;
+    ScopedZone& operator=(const ScopedZone&) = delete;
+
+private:
+    Site& site_;
+    uint64_t begin_ns_;
+};
+
+inline void CounterAdd(Site& site, int64_t delta)
+{
+    const int64_t v = site.value.fetch_add(delta, std::memory_order_relaxed) + delta;
+    site.calls.fetch_add(1, std::memory_order_relaxed);
+    LocalRing().Push({site.name, input::InputClockNs(), v, EventKind::Counter});
+}
+
+inline void CounterSet(Site& site, int64_t value)
+{
+    const uint64_t now = input::InputClockNs();
+    site.value.store(value, std::memory_order_relaxed);
+    site.set_ns.store(now, std::memory_order_relaxed);
+    site.calls.fetch_add(1, std::memory_order_relaxed);
+    LocalRing().Push({site.name, now, value, EventKind::Gauge});
+}
+
+#endif  // VRTO3D_TRACE
+
+}  // namespace vrto3d::trace
+
+#ifdef VRTO3D_TRACE
+
+#define VRTO3D_TRACE_CAT2(a, b) a##b
+#define VRTO3D_TRACE_CAT(a, b) VRTO3D_TRACE_CAT2(a, b)
+
+#define VRTO3D_TRACE_ZONE(name)                                                         \
+    static ::vrto3d::trace::Site VRTO3D_TRACE_CAT(vrto3d_trace_site_, __LINE__){       \
+        name, ::vrto3d::trace::EventKind::Zone};                                        \
+    ::vrto3d::trace::ScopedZone VRTO3D_TRACE_CAT(vrto3d_trace_zone_, __LINE__){        \
+        VRTO3D_TRACE_CAT(vrto3d_trace_site_, __LINE__)}
+
+#define VRTO3D_TRACE_COUNT(name, delta)                                                 \
+    do {                                                                                \
+        static ::vrto3d::trace::Site vrto3d_trace_site{name, ::vrto3d::trace::EventKind::Counter}; \
+        ::vrto3d::trace::CounterAdd(vrto3d_trace_site, static_cast<int64_t>(delta));   \
+    } while (0)
+
+#define VRTO3D_TRACE_VALUE(name, val)                                                   \
+    do {                                                                                \
+        static ::vrto3d::trace::Site vrto3d_trace_site{name, ::vrto3d::trace::EventKind::Gauge}; \
+        ::vrto3d::trace::CounterSet(vrto3d_trace_site, static_cast<int64_t>(val));     \
+    } while (0)
+
+#else
+
+#define VRTO3D_TRACE_ZONE(name) static_cast<void>(0)
+#define VRTO3D_TRACE_COUNT(name, delta) static_cast<void>(0)
+#define VRTO3D_TRACE_VALUE(name, val) static_cast<void>(0)
+
+#endif  // VRTO3D_TRACE
@@ -1,7 +1,7 @@
 /*
  * ue3d_protocol.h - UE3D Shared Memory Protocol Definition
  *
- * VERSION: 4.1
+ * VERSION: 4.5 (v5.0 layout available, opt-in)
  *
  * SINGLE SOURCE OF TRUTH for 3-party shared memory (UEVR + VRto3D + 3DGameBridge).
  * All projects should include this EXACT file to prevent struct misalignment.
@@ -21,6 +21,41 @@
  *   calibration, Leia eye tracking data, and diagnostic readback.
  *
  * CHANGELOG:
+ *   v5.0 - Cache-line-partitioned layout (UE3D_SharedDataV5, opt-in)
+ *        - Separate 320-byte mapping UE3D_V5_SHMEM_NAME; each writer owns
+ *          its 64-byte region so heartbeats no longer share lines with UEVR
+ *          or 3DGameBridge stores
+ *        - Negotiated by header: version 5, struct_size 320,
+ *          UE3D_FLAG_LAYOUT_V5. Readers that don't find a valid v5 block
+ *          fall back to the v4 mapping
+ *        - Depth commands are acknowledged by VRto3D writing command_ack
+ *          instead of clearing auto_depth_request in UEVR's region
+ *        - uevr.seq is mandatory in v5 (covers UEVR + profile regions)
+ *   v4.5 - Leia eye-sample history
+ *        - Added: leia_timestamp_ns (was _leia_reserved), UE3D ns clock
+ *        - Companion mapping UE3D_LEIA_RING_NAME (UE3D_LeiaEyeRing),
+ *          written by 3DGameBridge: the last 32 timestamped eye samples,
+ *          one seqlocked 64-byte slot each, so readers can extrapolate
+ *        - Main block layout unchanged; the ring is optional
+ *   v4.4 - Nanosecond timestamps (UE3D_FLAG_TIMESTAMP_NS)
+ *        - Added: uevr_timestamp_ns (was _reserved_fov1/2), and
+ *          vrto3d_timestamp_ns_lo (was _pad4, low 32 bits only)
+ *        - Both use the UE3D ns clock: QueryPerformanceCounter() scaled to
+ *          ns on Windows (Wine backs QPC with CLOCK_MONOTONIC_RAW), and
+ *          CLOCK_MONOTONIC_RAW natively on Linux
+ *        - Millisecond timestamps are unchanged and still drive staleness
+ *   v4.3 - Command doorbell (UE3D_FLAG_COMMAND_DOORBELL)
+ *        - Writers that set the flag signal every command_seq change:
+ *          SetEvent() on the auto-reset event UE3D_COMMAND_EVENT_NAME on
+ *          Windows, FUTEX_WAKE on the command_seq word on Linux
+ *        - No layout change; readers without doorbell support keep polling
+ *   v4.2 - Seqlock for the UEVR -> VRto3D sections (UE3D_FLAG_SEQLOCK)
+ *        - Added: uevr_seq (first 4 bytes of the old aim-correction reserve)
+ *        - Writers that set UE3D_FLAG_SEQLOCK bracket every update with
+ *          ue3d_seq_write_begin()/ue3d_seq_write_end(); readers copy the
+ *          block and retry while the sequence is odd or has moved
+ *        - Wire-compatible with v4.0/4.1: old writers leave uevr_seq zero
+ *          and never set the flag, old readers ignore both
  *   v4.1 - Monitor mode cleanup: removed VR-only fields
  *        - Removed: game_fov, base_fov, convergence_multiplier,
  *          uevr_frametime, is_zooming, stereo_aim_correction, stereo_aim_base
@@ -37,6 +72,7 @@
 #define UE3D_PROTOCOL_H
 
 #include <cstdint>
+#include <string.h>
 
 /* ========================================================================== */
 /* PROTOCOL CONSTANTS                                                         */
@@ -47,6 +83,15 @@
 #define UE3D_STRUCT_SIZE    256          /* Total struct size in bytes          */
 #define UE3D_SHMEM_NAME    "UE3D_SharedData"
 
+/* v5.0 cache-line-partitioned layout (separate mapping, opt-in by writer)    */
+#define UE3D_V5_VERSION     5
+#define UE3D_V5_STRUCT_SIZE 320
+#define UE3D_V5_SHMEM_NAME "UE3D_SharedData_v5"
+#define UE3D_CACHE_LINE     64
+
+/* v4.3 command doorbell: auto-reset event UEVR signals on command_seq change */
+#define UE3D_COMMAND_EVENT_NAME "UE3D_CommandEvent"
+
 /* Staleness threshold: data older than this (ms) is considered disconnected  */
 #define UE3D_STALE_MS       1000
 
@@ -55,6 +100,10 @@
 #define UE3D_FLAG_SCENE_AWARE      0x02   /* Sends scene_type field           */
 #define UE3D_FLAG_FOV_COMP         0x04   /* Supports FOV compensation        */
 #define UE3D_FLAG_LEIA_EYES        0x20   /* v4.0: Leia eye tracking + display */
+#define UE3D_FLAG_SEQLOCK          0x40   /* v4.2: uevr_seq brackets updates  */
+#define UE3D_FLAG_LAYOUT_V5        0x80   /* v5.0: UE3D_SharedDataV5 layout   */
+#define UE3D_FLAG_COMMAND_DOORBELL 0x100  /* v4.3: command_seq changes signalled */
+#define UE3D_FLAG_TIMESTAMP_NS     0x200  /* v4.4: uevr_timestamp_ns is written */
 
 /* ========================================================================== */
 /* ENUMS                                                                       */
@@ -83,7 +132,7 @@ enum UE3D_ZoomMode : uint8_t {
 /*                                                                             */
 /* Offset map:                                                                 */
 /*   0-15    HEADER             (16 bytes)                                     */
-/*   16-39   FOV / ZOOM         (24 bytes)  UEVR -> VRto3D                    */
+/*   16-39   FOV / ZOOM         (24 bytes)  UEVR -> VRto3D  (16-23: ns ts)    */
 /*   40-55   DEPTH CONTROL      (16 bytes)  UEVR -> VRto3D                    */
 /*   56-71   TIMING             (16 bytes)  UEVR -> VRto3D                    */
 /*   72-103  VRTO3D STATE       (32 bytes)  VRto3D -> UEVR  (diagnostic)      */
@@ -91,9 +140,10 @@ enum UE3D_ZoomMode : uint8_t {
 /*   120-183 PROFILE INFO       (64 bytes)  UEVR -> VRto3D                    */
 /*   184-215 LEIA EYE TRACKING  (32 bytes)  3DGameBridge -> UEVR  [v4.0]     */
 /*   216-223 LEIA DISPLAY INFO  (8 bytes)   3DGameBridge -> UEVR  [v4.0]     */
-/*   224-231 LEIA RESERVED      (8 bytes)   Future Leia fields                */
+/*   224-231 LEIA TIMESTAMP     (8 bytes)   3DGameBridge -> UEVR  [v4.5]     */
 /*   232-235 COMMANDS           (4 bytes)   UEVR -> VRto3D                    */
-/*   236-243 RESERVED           (8 bytes)   (was aim correction, v4.1)        */
+/*   236-239 UEVR SEQLOCK       (4 bytes)   UEVR -> VRto3D  [v4.2]           */
+/*   240-243 RESERVED           (4 bytes)   (was aim correction, v4.1)        */
 /*   244-245 MONITOR MODE       (2 bytes)   Bidirectional                     */
 /*   246-249 STEREO DEPTH HINT  (4 bytes)   UEVR -> VRto3D                    */
 /*   250-255 RESERVED           (6 bytes)   Future use                         */
@@ -109,8 +159,8 @@ typedef struct UE3D_SharedData {
     uint32_t flags;                  /* Bitfield: UE3D_FLAG_*                */
 
     /* ----- UEVR -> VRTO3D: FOV / ZOOM (24 bytes) ----------------------- */
-    uint8_t  _reserved_fov1[4];      /* (was game_fov, UEVR-internal now)   */
-    uint8_t  _reserved_fov2[4];      /* (was base_fov, UEVR-internal now)   */
+    uint64_t uevr_timestamp_ns;      /* v4.4: UE3D ns clock (was game_fov,  */
+                                     /* base_fov); valid with FLAG_TIMESTAMP_NS */
     float    fov_scale;              /* Projection scale (0.5 = 2x zoom)    */
     float    zoom_factor;            /* Magnification (2.0 = 2x zoom)       */
     uint8_t  _reserved_zoom1;        /* (was is_zooming, derive fov_scale)  */
@@ -148,7 +198,7 @@ typedef struct UE3D_SharedData {
     uint8_t  vrto3d_auto_depth_active; /* 1 if applying depth multiplier     */
     uint8_t  vrto3d_profile_loaded;  /* 1 if VRto3D has a game profile       */
     uint8_t  vrto3d_listener_enabled;/* 1 if Ctrl+F11 auto-depth is ON       */
-    uint8_t  _pad4[4];              /* Padding                              */
+    uint32_t vrto3d_timestamp_ns_lo; /* v4.4: low 32 bits, UE3D ns clock    */
     uint64_t vrto3d_timestamp;       /* GetTickCount64() from VRto3D         */
 
     /* ----- PROFILE INFO (64 bytes) -------------------------------------- */
@@ -170,14 +220,17 @@ typedef struct UE3D_SharedData {
     float    leia_display_width_cm;  /* Physical display width (cm)         */
     float    leia_display_height_cm; /* Physical display height (cm)        */
 
-    /* ----- v4.0: RESERVED FOR LEIA (8 bytes) ---------------------------- */
-    uint8_t  _leia_reserved[8];      /* Zero-filled, future Leia fields     */
+    /* ----- v4.5: LEIA TIMESTAMP (8 bytes, was Leia reserve) ------------- */
+    uint64_t leia_timestamp_ns;      /* UE3D ns clock when sample was taken */
 
     /* ----- COMMANDS (4 bytes) UEVR -> VRto3D ---------------------------- */
     uint32_t command_seq;            /* Sequence number for depth commands    */
 
-    /* ----- RESERVED (8 bytes, was aim correction in v3.2) --------------- */
-    uint8_t  _reserved_aim[8];       /* Zero-filled                         */
+    /* ----- v4.2: UEVR SEQLOCK (4 bytes) UEVR -> VRto3D ----------------- */
+    uint32_t uevr_seq;               /* Odd while UEVR is mid-update         */
+
+    /* ----- RESERVED (4 bytes, was aim correction in v3.2) --------------- */
+    uint8_t  _reserved_aim[4];       /* Zero-filled                         */
 
     /* ----- MONITOR MODE (2 bytes) Bidirectional ------------------------- */
     uint8_t  monitor_mode;           /* 1 if UEVR monitor mode is active     */
@@ -201,6 +254,178 @@ static_assert(sizeof(UE3D_SharedData) == 256,
     "UE3D_SharedData must be exactly 256 bytes");
 #endif
 
+/* ========================================================================== */
+/* v5.0 SHARED MEMORY STRUCTURE - 320 BYTES, FIVE 64-BYTE REGIONS              */
+/*                                                                             */
+/* One writer per cache line. The mapping is page-aligned, so every region     */
+/* starts on its own line and a store in one region never invalidates the      */
+/* line another process is writing.                                            */
+/*                                                                             */
+/* Offset map:                                                                 */
+/*   0-63    HEADER             Creator (UEVR), written once                  */
+/*   64-127  UEVR STATE         UEVR -> VRto3D   (seqlocked by uevr.seq)      */
+/*   128-191 PROFILE INFO       UEVR -> VRto3D   (seqlocked by uevr.seq)      */
+/*   192-255 VRTO3D STATE       VRto3D -> UEVR                                */
+/*   256-319 LEIA               3DGameBridge -> UEVR                          */
+/* ========================================================================== */
+
+#pragma pack(push, 1)
+typedef struct UE3D_V5_Header {
+    uint32_t magic;                  /* Must be UE3D_MAGIC                   */
+    uint32_t version;                /* UE3D_V5_VERSION                      */
+    uint32_t struct_size;            /* sizeof(UE3D_SharedDataV5) = 320      */
+    uint32_t flags;                  /* UE3D_FLAG_* incl. UE3D_FLAG_LAYOUT_V5 */
+    uint8_t  _reserved[48];          /* Zero-filled                          */
+} UE3D_V5_Header;
+
+typedef struct UE3D_V5_Uevr {
+    uint32_t seq;                    /* Odd while UEVR is mid-update         */
+    uint32_t command_seq;            /* Bumped with every auto_depth_request */
+    uint64_t uevr_timestamp;         /* GetTickCount64() from UEVR           */
+    uint32_t uevr_frame_count;       /* UEVR frame counter                   */
+    float    fov_scale;              /* Projection scale (0.5 = 2x zoom)    */
+    float    zoom_factor;            /* Magnification (2.0 = 2x zoom)       */
+    float    depth_multiplier;       /* 0.05 - 1.0 (1.0 = no change)        */
+    float    world_scale;            /* UEVR world scale                     */
+    float    stereo_depth_hint;      /* UEVR stereo depth for overlay IPD    */
+    uint8_t  is_valid;               /* 1 if FOV reading is trustworthy      */
+    uint8_t  zoom_mode;              /* UE3D_ZoomMode enum                   */
+    uint8_t  scene_type;             /* UE3D_SceneType enum                  */
+    uint8_t  auto_depth_request;     /* Pending while command_seq != ack     */
+    uint8_t  monitor_mode;           /* 1 if UEVR monitor mode is active     */
+    uint8_t  _pad[3];                /* Padding                              */
+    uint64_t uevr_timestamp_ns;      /* UE3D ns clock, with FLAG_TIMESTAMP_NS */
+    uint8_t  _reserved[8];           /* Zero-filled                          */
+} UE3D_V5_Uevr;
+
+typedef struct UE3D_V5_Profile {
+    char     uevr_profile_name[32];  /* Current UEVR profile name            */
+    char     game_exe_name[32];      /* Game executable name                 */
+} UE3D_V5_Profile;
+
+typedef struct UE3D_V5_Vrto3d {
+    float    depth;                  /* VRto3D's current depth               */
+    float    convergence;            /* VRto3D's current convergence         */
+    float    fov;                    /* VRto3D's current FOV                 */
+    float    fov_adjustment;         /* FOV delta from convergence           */
+    float    aspect_ratio;           /* Display aspect ratio                 */
+    float    ipd;                    /* IPD setting                          */
+    float    hmd_height;             /* HMD height                           */
+    uint8_t  sbs_mode;               /* 0 = TaB, 1 = SbS                    */
+    uint8_t  connected;              /* 1 if VRto3D is reading this memory   */
+    uint8_t  auto_depth_active;      /* 1 if applying depth multiplier       */
+    uint8_t  profile_loaded;         /* 1 if VRto3D has a game profile       */
+    uint8_t  listener_enabled;       /* 1 if Ctrl+F11 auto-depth is ON       */
+    uint8_t  is_monitor_display;     /* 1 if VRto3D is outputting to monitor  */
+    uint8_t  _pad[2];                /* Padding                              */
+    uint32_t command_ack;            /* Last uevr.command_seq handled        */
+    uint64_t vrto3d_timestamp;       /* GetTickCount64() from VRto3D         */
+    uint64_t vrto3d_timestamp_ns;    /* UE3D ns clock                        */
+    uint8_t  _reserved[8];           /* Zero-filled                          */
+} UE3D_V5_Vrto3d;
+
+typedef struct UE3D_V5_Leia {
+    uint8_t  tracking_active;        /* 1 if face tracked, 0 if not         */
+    uint8_t  _pad[3];                /* Alignment padding                   */
+    float    left_eye_x;             /* Left eye X (mm, right)              */
+    float    left_eye_y;             /* Left eye Y (mm, up)                 */
+    float    left_eye_z;             /* Left eye Z (mm, backward)           */
+    float    right_eye_x;            /* Right eye X (mm, right)             */
+    float    right_eye_y;            /* Right eye Y (mm, up)                */
+    float    right_eye_z;            /* Right eye Z (mm, backward)          */
+    uint32_t frame_counter;          /* Writer increments each update       */
+    float    display_width_cm;       /* Physical display width (cm)         */
+    float    display_height_cm;      /* Physical display height (cm)        */
+    uint64_t timestamp_ns;           /* UE3D ns clock when sample was taken */
+    uint8_t  _reserved[16];          /* Zero-filled, future Leia fields     */
+} UE3D_V5_Leia;
+
+typedef struct UE3D_SharedDataV5 {
+    UE3D_V5_Header  header;
+    UE3D_V5_Uevr    uevr;
+    UE3D_V5_Profile profile;
+    UE3D_V5_Vrto3d  vrto3d;
+    UE3D_V5_Leia    leia;
+} UE3D_SharedDataV5;
+#pragma pack(pop)
+
+#ifndef __cplusplus
+_Static_assert(sizeof(UE3D_V5_Header) == UE3D_CACHE_LINE &&
+               sizeof(UE3D_V5_Uevr) == UE3D_CACHE_LINE &&
+               sizeof(UE3D_V5_Profile) == UE3D_CACHE_LINE &&
+               sizeof(UE3D_V5_Vrto3d) == UE3D_CACHE_LINE &&
+               sizeof(UE3D_V5_Leia) == UE3D_CACHE_LINE,
+    "UE3D v5 regions must be exactly one cache line");
+_Static_assert(sizeof(UE3D_SharedDataV5) == UE3D_V5_STRUCT_SIZE,
+    "UE3D_SharedDataV5 must be exactly 320 bytes");
+#else
+static_assert(sizeof(UE3D_V5_Header) == UE3D_CACHE_LINE &&
+              sizeof(UE3D_V5_Uevr) == UE3D_CACHE_LINE &&
+              sizeof(UE3D_V5_Profile) == UE3D_CACHE_LINE &&
+              sizeof(UE3D_V5_Vrto3d) == UE3D_CACHE_LINE &&
+              sizeof(UE3D_V5_Leia) == UE3D_CACHE_LINE,
+    "UE3D v5 regions must be exactly one cache line");
+static_assert(sizeof(UE3D_SharedDataV5) == UE3D_V5_STRUCT_SIZE,
+    "UE3D_SharedDataV5 must be exactly 320 bytes");
+#endif
+
+/* ========================================================================== */
+/* v4.5 LEIA EYE-SAMPLE RING - COMPANION MAPPING, 2112 BYTES, PACKED           */
+/*                                                                             */
+/* Written by 3DGameBridge only. Per update the writer takes slot              */
+/* head % UE3D_LEIA_RING_SLOTS, brackets the store with that slot's seqlock,   */
+/* then publishes by incrementing head (release). Readers load head (acquire), */
+/* walk back from head - 1 and drop any slot whose seqlock says torn.          */
+/*                                                                             */
+/* Offset map:                                                                 */
+/*   0-63     HEADER            (64 bytes)                                    */
+/*   64-2111  SLOTS             (32 x 64 bytes, one cache line each)          */
+/* ========================================================================== */
+
+#define UE3D_LEIA_RING_NAME    "UE3D_LeiaEyeRing"
+#define UE3D_LEIA_RING_MAGIC   0x4C455945   /* "LEYE" in ASCII                */
+#define UE3D_LEIA_RING_VERSION 1
+#define UE3D_LEIA_RING_SLOTS   32
+
+#pragma pack(push, 1)
+typedef struct UE3D_LeiaEyeSlot {
+    uint32_t seq;                    /* Odd while the writer fills the slot  */
+    uint8_t  tracking_active;        /* 1 if face tracked, 0 if not         */
+    uint8_t  _pad[3];                /* Alignment padding                   */
+    uint64_t timestamp_ns;           /* UE3D ns clock when sample was taken */
+    float    left_eye_x;             /* Left eye X (mm, right)              */
+    float    left_eye_y;             /* Left eye Y (mm, up)                 */
+    float    left_eye_z;             /* Left eye Z (mm, backward)           */
+    float    right_eye_x;            /* Right eye X (mm, right)             */
+    float    right_eye_y;            /* Right eye Y (mm, up)                */
+    float    right_eye_z;            /* Right eye Z (mm, backward)          */
+    uint32_t frame_counter;          /* Same counter as leia_frame_counter  */
+    uint8_t  _reserved[20];          /* Zero-filled                         */
+} UE3D_LeiaEyeSlot;
+
+typedef struct UE3D_LeiaEyeRing {
+    uint32_t magic;                  /* Must be UE3D_LEIA_RING_MAGIC         */
+    uint32_t version;                /* UE3D_LEIA_RING_VERSION               */
+    uint32_t struct_size;            /* sizeof(UE3D_LeiaEyeRing) = 2112      */
+    uint32_t slot_count;             /* UE3D_LEIA_RING_SLOTS                 */
+    uint32_t head;                   /* Samples published so far (wraps)    */
+    uint8_t  _reserved[44];          /* Zero-filled                         */
+    UE3D_LeiaEyeSlot slots[UE3D_LEIA_RING_SLOTS];
+} UE3D_LeiaEyeRing;
+#pragma pack(pop)
+
+#ifndef __cplusplus
+_Static_assert(sizeof(UE3D_LeiaEyeSlot) == UE3D_CACHE_LINE,
+    "UE3D_LeiaEyeSlot must be exactly one cache line");
+_Static_assert(sizeof(UE3D_LeiaEyeRing) == 2112,
+    "UE3D_LeiaEyeRing must be exactly 2112 bytes");
+#else
+static_assert(sizeof(UE3D_LeiaEyeSlot) == UE3D_CACHE_LINE,
+    "UE3D_LeiaEyeSlot must be exactly one cache line");
+static_assert(sizeof(UE3D_LeiaEyeRing) == 2112,
+    "UE3D_LeiaEyeRing must be exactly 2112 bytes");
+#endif
+
 /* ========================================================================== */
 /* HELPERS                                                                     */
 /* ========================================================================== */
@@ -225,4 +450,187 @@ static inline int ue3d_has_leia_eyes(const UE3D_SharedData* d) {
     return (d->flags & UE3D_FLAG_LEIA_EYES) && d->leia_tracking_active;
 }
 
+/* Check that a mapped companion block really is a Leia eye ring (v4.5) */
+static inline int ue3d_is_leia_ring(const UE3D_LeiaEyeRing* r) {
+    if (!r || r->magic != UE3D_LEIA_RING_MAGIC) return 0;
+    return r->version == UE3D_LEIA_RING_VERSION &&
+           r->struct_size == sizeof(UE3D_LeiaEyeRing) &&
+           r->slot_count == UE3D_LEIA_RING_SLOTS;
+}
+
+/* Check if the writer brackets its updates with uevr_seq (v4.2) */
+static inline int ue3d_has_seqlock(const UE3D_SharedData* d) {
+    if (!d || d->magic != UE3D_MAGIC) return 0;
+    return (d->flags & UE3D_FLAG_SEQLOCK) != 0;
+}
+
+/* Check that a mapped block really is a v5 layout (v5.0) */
+static inline int ue3d_is_v5_layout(const UE3D_SharedDataV5* d) {
+    if (!d || d->header.magic != UE3D_MAGIC) return 0;
+    return d->header.version == UE3D_V5_VERSION &&
+           d->header.struct_size == UE3D_V5_STRUCT_SIZE &&
+           (d->header.flags & UE3D_FLAG_LAYOUT_V5) != 0;
+}
+
+/* Translate a v5 block into the v4 shape, for code that only speaks v4.
+ * A depth request already acknowledged by VRto3D reads back as 0, matching
+ * the v4 convention of clearing auto_depth_request. */
+static inline void ue3d_v5_to_v4(const UE3D_SharedDataV5* s, UE3D_SharedData* d) {
+    memset(d, 0, sizeof(*d));
+    d->magic                    = s->header.magic;
+    d->version                  = UE3D_VERSION;
+    d->struct_size              = UE3D_STRUCT_SIZE;
+    d->flags                    = (s->header.flags & ~(uint32_t)UE3D_FLAG_LAYOUT_V5)
+                                  | UE3D_FLAG_SEQLOCK;
+    d->uevr_timestamp_ns        = s->uevr.uevr_timestamp_ns;
+    d->fov_scale                = s->uevr.fov_scale;
+    d->zoom_factor              = s->uevr.zoom_factor;
+    d->is_valid                 = s->uevr.is_valid;
+    d->zoom_mode                = s->uevr.zoom_mode;
+    d->depth_multiplier         = s->uevr.depth_multiplier;
+    d->scene_type               = s->uevr.scene_type;
+    d->auto_depth_request       = (s->uevr.command_seq != s->vrto3d.command_ack)
+                                  ? s->uevr.auto_depth_request : 0;
+    d->world_scale              = s->uevr.world_scale;
+    d->uevr_timestamp           = s->uevr.uevr_timestamp;
+    d->uevr_frame_count         = s->uevr.uevr_frame_count;
+    d->vrto3d_depth             = s->vrto3d.depth;
+    d->vrto3d_convergence       = s->vrto3d.convergence;
+    d->vrto3d_fov               = s->vrto3d.fov;
+    d->vrto3d_fov_adjustment    = s->vrto3d.fov_adjustment;
+    d->vrto3d_aspect_ratio      = s->vrto3d.aspect_ratio;
+    d->vrto3d_ipd               = s->vrto3d.ipd;
+    d->vrto3d_hmd_height        = s->vrto3d.hmd_height;
+    d->vrto3d_sbs_mode          = s->vrto3d.sbs_mode;
+    d->vrto3d_connected         = s->vrto3d.connected;
+    d->vrto3d_auto_depth_active = s->vrto3d.auto_depth_active;
+    d->vrto3d_profile_loaded    = s->vrto3d.profile_loaded;
+    d->vrto3d_listener_enabled  = s->vrto3d.listener_enabled;
+    d->vrto3d_timestamp_ns_lo   = (uint32_t)s->vrto3d.vrto3d_timestamp_ns;
+    d->vrto3d_timestamp         = s->vrto3d.vrto3d_timestamp;
+    memcpy(d->uevr_profile_name, s->profile.uevr_profile_name, sizeof(d->uevr_profile_name));
+    memcpy(d->game_exe_name, s->profile.game_exe_name, sizeof(d->game_exe_name));
+    d->leia_tracking_active     = s->leia.tracking_active;
+    d->leia_left_eye_x          = s->leia.left_eye_x;
+    d->leia_left_eye_y          = s->leia.left_eye_y;
+    d->leia_left_eye_z          = s->leia.left_eye_z;
+    d->leia_right_eye_x         = s->leia.right_eye_x;
+    d->leia_right_eye_y         = s->leia.right_eye_y;
+    d->leia_right_eye_z         = s->leia.right_eye_z;
+    d->leia_frame_counter       = s->leia.frame_counter;
+    d->leia_display_width_cm    = s->leia.display_width_cm;
+    d->leia_display_height_cm   = s->leia.display_height_cm;
+    d->leia_timestamp_ns        = s->leia.timestamp_ns;
+    d->command_seq              = s->uevr.command_seq;
+    d->uevr_seq                 = s->uevr.seq;
+    d->monitor_mode             = s->uevr.monitor_mode;
+    d->is_monitor_display       = s->vrto3d.is_monitor_display;
+    d->stereo_depth_hint        = s->uevr.stereo_depth_hint;
+}
+
+/* ========================================================================== */
+/* SEQLOCK (v4.2, C++ only)                                                    */
+/*                                                                             */
+/* Covers every UEVR -> VRto3D field. UEVR is the only writer of uevr_seq:     */
+/*   ue3d_seq_write_begin(d);   // uevr_seq becomes odd                        */
+/*   ... write FOV/depth/timing/profile/command/monitor/hint fields ...        */
+/*   ue3d_seq_write_end(d);     // uevr_seq becomes even again                 */
+/* Readers sample the sequence, copy, then confirm it is even and unchanged.   */
+/* Fields written by VRto3D or 3DGameBridge are NOT covered.                   */
+/* The same helpers accept a UE3D_SharedDataV5*, where uevr.seq covers the     */
+/* UEVR state and profile regions.                                             */
+/* ========================================================================== */
+
+#ifdef __cplusplus
+#include <atomic>
+#include <cstddef>
+
+static_assert(offsetof(UE3D_SharedData, uevr_seq) == 236,
+    "uevr_seq must stay at offset 236");
+static_assert(offsetof(UE3D_SharedData, leia_timestamp_ns) == 224 &&
+              offsetof(UE3D_LeiaEyeRing, slots) == 64,
+    "v4.5 Leia fields must stay where the layout documents them");
+static_assert(offsetof(UE3D_SharedData, uevr_timestamp_ns) == 16 &&
+              offsetof(UE3D_SharedData, vrto3d_timestamp_ns_lo) == 108,
+    "v4.4 timestamps must stay in the slots they took over");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) &&
+              std::atomic<uint32_t>::is_always_lock_free,
+    "uevr_seq must be accessible as a lock-free 32-bit atomic");
+
+inline std::atomic<uint32_t>& ue3d_seq_word(UE3D_SharedData* d) {
+    return *reinterpret_cast<std::atomic<uint32_t>*>(&d->uevr_seq);
+}
+
+inline const std::atomic<uint32_t>& ue3d_seq_word(const UE3D_SharedData* d) {
+    return *reinterpret_cast<const std::atomic<uint32_t>*>(&d->uevr_seq);
+}
+
+static_assert(offsetof(UE3D_SharedDataV5, uevr) == 64 &&
+              offsetof(UE3D_SharedDataV5, vrto3d) == 192 &&
+              offsetof(UE3D_SharedDataV5, leia) == 256,
+    "UE3D v5 regions must start on cache-line boundaries");
+
+inline std::atomic<uint32_t>& ue3d_seq_word(UE3D_SharedDataV5* d) {
+    return *reinterpret_cast<std::atomic<uint32_t>*>(&d->uevr.seq);
+}
+
+inline const std::atomic<uint32_t>& ue3d_seq_word(const UE3D_SharedDataV5* d) {
+    return *reinterpret_cast<const std::atomic<uint32_t>*>(&d->uevr.seq);
+}
+
+/* Leia ring: per-slot seqlock, and head as the publish counter */
+inline std::atomic<uint32_t>& ue3d_seq_word(UE3D_LeiaEyeSlot* s) {
+    return *reinterpret_cast<std::atomic<uint32_t>*>(&s->seq);
+}
+
+inline const std::atomic<uint32_t>& ue3d_seq_word(const UE3D_LeiaEyeSlot* s) {
+    return *reinterpret_cast<const std::atomic<uint32_t>*>(&s->seq);
+}
+
+inline const std::atomic<uint32_t>& ue3d_leia_head(const UE3D_LeiaEyeRing* r) {
+    return *reinterpret_cast<const std::atomic<uint32_t>*>(&r->head);
+}
+
+inline std::atomic<uint32_t>& ue3d_leia_head(UE3D_LeiaEyeRing* r) {
+    return *reinterpret_cast<std::atomic<uint32_t>*>(&r->head);
+}
+
+/* command_seq is also the futex word for the v4.3 doorbell on Linux */
+static_assert(offsetof(UE3D_SharedData, command_seq) % 4 == 0 &&
+              offsetof(UE3D_SharedDataV5, uevr.command_seq) % 4 == 0,
+    "command_seq must be 4-byte aligned to serve as a futex word");
+
+inline std::atomic<uint32_t>& ue3d_command_word(UE3D_SharedData* d) {
+    return *reinterpret_cast<std::atomic<uint32_t>*>(&d->command_seq);
+}
+
+inline std::atomic<uint32_t>& ue3d_command_word(UE3D_SharedDataV5* d) {
+    return *reinterpret_cast<std::atomic<uint32_t>*>(&d->uevr.command_seq);
+}
+
+template <typename Block>
+inline void ue3d_seq_write_begin(Block* d) {
+    ue3d_seq_word(d).fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+template <typename Block>
+inline void ue3d_seq_write_end(Block* d) {
+    ue3d_seq_word(d).fetch_add(1, std::memory_order_release);
+}
+
+template <typename Block>
+inline uint32_t ue3d_seq_read_begin(const Block* d) {
+    return ue3d_seq_word(d).load(std::memory_order_acquire);
+}
+
+/* True if the copy taken since ue3d_seq_read_begin() returned `seq` is torn */
+template <typename Block>
+inline bool ue3d_seq_read_retry(const Block* d, uint32_t seq) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return (seq & 1u) != 0 ||
+           ue3d_seq_word(d).load(std::memory_order_relaxed) != seq;
+}
+#endif /* __cplusplus */
+
 #endif /* UE3D_PROTOCOL_H */
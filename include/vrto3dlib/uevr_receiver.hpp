@@ -10,6 +10,17 @@
  *   - Monitor mode flag propagation
  *   - Stereo depth hint for overlay IPD matching
  *   - Heartbeat (writes vrto3d_connected + timestamp back to UEVR)
+ *   - Per-frame snapshot: one seqlock-checked copy of the whole block, so a
+ *     frame's reads agree with each other and never see a half-written update
+ *   - Layout negotiation: the v5 cache-line-partitioned mapping when UEVR
+ *     publishes one, otherwise the v4 block
+ *   - Command wakeup: wait_for_command() blocks on UEVR's doorbell (named
+ *     event / futex) and falls back to short polling for older writers
+ *   - Leia eye prediction: reads 3DGameBridge's eye-sample ring and
+ *     extrapolates to scan-out (predict_eyes / predict_eyes_for_latency)
+ *   - Telemetry: ring of UEVR frame age and heartbeat intervals, dropped /
+ *     duplicated frame counts, p50/p99 via get_telemetry() and an optional
+ *     periodic summary callback (set_telemetry_sink)
  *
  * LICENSE: Dual-licensed (MIT for UEVR compatibility, LGPL v3 for VRto3D).
  */
@@ -18,36 +29,245 @@
 
 #ifdef _WIN32
 #include <Windows.h>
-#else
-// UEVR bridge is Windows-only for now (the Proton-visible shared-memory
-// bridge is deferred). The Linux build compiles this header but init()
-// always fails, so monitor mode stays dormant.
-#include <chrono>
 #endif
+#ifdef __linux__
+// Linux/Proton bridge: UEVR runs inside Wine, where named file mappings are
+// private to the wineserver. The UEVR side therefore backs its mapping with
+// Z:\dev\shm\UE3D_SharedData, which is the same object shm_open() finds
+// here (see detail::OpenShmBlock). Other non-Windows builds stay dormant.
+#include <cstdlib>
+#include <ctime>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <cstring>
 #include <cmath>
 #include <algorithm>
+#include <thread>
 
 #include "vrto3dlib/ue3d_protocol.h"
 
 #ifndef _WIN32
 namespace uevr::detail {
 inline uint64_t TickMs() {
+#ifdef __linux__
+    // Wine's GetTickCount64() counts CLOCK_MONOTONIC_RAW milliseconds. Use the
+    // same clock so UE3D_STALE_MS compares like with like: CLOCK_MONOTONIC
+    // is NTP-slewed and drifts by seconds from the raw clock over long uptimes.
+    timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC_RAW, &ts) == 0)
+        return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+#endif
     using namespace std::chrono;
     return (uint64_t)duration_cast<milliseconds>(
         steady_clock::now().time_since_epoch()).count();
 }
+
+#ifdef __linux__
+// File behind a UE3D mapping name when UE3D_SHM_PATH overrides the v4 file
+// path, e.g. for a per-prefix location; empty without an override. Blocks
+// whose mapping name extends UE3D_SHMEM_NAME keep that extension ("<path>_v5");
+// any other block sits next to it as "<path>.<name>", e.g. the Leia ring at
+// "<path>.UE3D_LeiaEyeRing".
+inline std::string ShmOverridePath(const char* name) {
+    const char* override_path = std::getenv("UE3D_SHM_PATH");
+    if (!override_path || !*override_path) return std::string();
+    std::string path = override_path;
+    const size_t base_len = std::strlen(UE3D_SHMEM_NAME);
+    if (std::strncmp(name, UE3D_SHMEM_NAME, base_len) == 0)
+        path += name + base_len;
+    else
+        path.append(".").append(name);
+    return path;
+}
+
+// Opens the block behind a UE3D mapping name: the ShmOverridePath() file, or
+// by default the POSIX shm object "/<name>" (i.e. /dev/shm/<name>).
+inline int OpenShmBlock(const char* name) {
+    const std::string path = ShmOverridePath(name);
+    if (!path.empty()) return open(path.c_str(), O_RDWR | O_CLOEXEC);
+    const std::string shm_name = std::string("/") + name;
+    return shm_open(shm_name.c_str(), O_RDWR, 0);
+}
+#endif
 }
 #define GetTickCount64() ::uevr::detail::TickMs()
 #endif
 
+namespace uevr::detail {
+// UE3D ns clock (protocol v4.4): the timebase UEVR stamps uevr_timestamp_ns
+// with. QPC on Windows, which Wine backs with CLOCK_MONOTONIC_RAW.
+inline uint64_t TickNs() {
+#ifdef _WIN32
+    static const uint64_t freq = [] {
+        LARGE_INTEGER f;
+        QueryPerformanceFrequency(&f);
+        return (uint64_t)f.QuadPart;
+    }();
+    LARGE_INTEGER c;
+    QueryPerformanceCounter(&c);
+    const uint64_t ticks = (uint64_t)c.QuadPart;
+    return (ticks / freq) * 1000000000ull + (ticks % freq) * 1000000000ull / freq;
+#elif defined(__linux__)
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#else
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<nanoseconds>(
+        steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Fixed-size ring of microsecond samples; percentiles over the last N.
+template <size_t N>
+class SampleRing {
+public:
+    void push(uint32_t us) {
+        m_samples[m_next] = us;
+        m_next = (m_next + 1) % N;
+        if (m_count < N) ++m_count;
+    }
+
+    uint32_t count() const { return static_cast<uint32_t>(m_count); }
+
+    // q in [0, 1]; 0 when empty.
+    uint32_t percentile(double q) const {
+        if (m_count == 0) return 0;
+        uint32_t sorted[N];
+        std::copy(m_samples, m_samples + m_count, sorted);
+        const size_t k = (std::min)(m_count - 1, static_cast<size_t>(q * (double)m_count));
+        std::nth_element(sorted, sorted + k, sorted + m_count);
+        return sorted[k];
+    }
+
+    void clear() { m_next = m_count = 0; }
+
+private:
+    uint32_t m_samples[N]{};
+    size_t m_next = 0;
+    size_t m_count = 0;
+};
+}
+
 namespace uevr {
 
 constexpr uint32_t UEVR_MAGIC = UE3D_MAGIC;
 constexpr const char* SHARED_MEM_NAME = UE3D_SHMEM_NAME;
 
 using SharedData = UE3D_SharedData;
+using SharedDataV5 = UE3D_SharedDataV5;
 static_assert(sizeof(SharedData) == 256, "SharedData must be 256 bytes!");
+static_assert(sizeof(SharedDataV5) == 320, "SharedDataV5 must be 320 bytes!");
+
+enum class Layout : uint8_t {
+    None = 0,
+    V4   = 4,   // UE3D_SharedData, shared cache lines
+    V5   = 5    // UE3D_SharedDataV5, one region per writer
+};
+
+namespace detail {
+inline float SanitizeDepthHint(float hint) {
+    return (std::isfinite(hint) && hint > 0.0f && hint < 2.0f) ? hint : 0.0f;
+}
+
+inline float SanitizeWorldScale(float ws) {
+    return (std::isfinite(ws) && ws > 0.0f) ? ws : 100.0f;
+}
+
+// Formula tuned from 136+ game profiles.
+inline bool AutoStereoFromWorldScale(float ws, float& out_depth, float& out_convergence) {
+    if (ws < 0.1f) return false;
+    float scale_factor = ws / 100.0f;
+    out_depth = (std::max)(0.02f, (std::min)(0.08f * scale_factor, 0.50f));
+    out_convergence = 1.0f;
+    return true;
+}
+}
+
+/**
+ * Latency/jitter summary from Receiver's telemetry ring (microseconds).
+ * Frame age needs a v4.4 writer (UE3D_FLAG_TIMESTAMP_NS); the counters and
+ * heartbeat interval work with any writer.
+ */
+struct TelemetryStats {
+    uint32_t frame_age_samples = 0;
+    uint32_t frame_age_p50_us = 0;    // snapshot time - uevr_timestamp_ns
+    uint32_t frame_age_p99_us = 0;
+    uint32_t heartbeat_samples = 0;
+    uint32_t heartbeat_p50_us = 0;    // interval between update() calls
+    uint32_t heartbeat_p99_us = 0;
+    uint64_t dropped_frames = 0;      // UEVR frames skipped between snapshots
+    uint64_t duplicate_frames = 0;    // snapshots that saw no new UEVR frame
+    uint32_t torn_snapshots = 0;      // see Receiver::get_torn_snapshot_count()
+};
+
+/**
+ * Receives Receiver's periodic telemetry summary; `user` is the pointer given
+ * to set_telemetry_sink(). Called on the thread that calls snapshot().
+ */
+using TelemetrySink = void (*)(const TelemetryStats& stats, void* user);
+
+/**
+ * Eye positions in the Leia tracker frame (mm; x right, y up, z backward).
+ */
+struct EyePose {
+    float    left[3] = {};
+    float    right[3] = {};
+    uint64_t sample_ns = 0;    // UE3D ns clock of the newest sample used
+    uint64_t target_ns = 0;    // time the pose was extrapolated to
+    bool     predicted = false; // false: newest sample as-is (no history)
+};
+
+/**
+ * Local copy of the shared block, taken once per frame by Receiver::snapshot().
+ * All queries run against the copy: no cross-process loads, no repeated
+ * GetTickCount64() calls, and every field comes from the same UEVR update.
+ */
+struct Snapshot {
+    SharedData data{};
+    uint64_t   taken_ms = 0;       // GetTickCount64() when the copy was taken
+    bool       connected = false;  // a mapping with the right magic existed
+    bool       coherent = false;   // seqlock confirmed the copy (false for pre-4.2 writers)
+    Layout     layout = Layout::None;  // layout the copy was translated from
+
+    bool has_valid_data() const {
+        return connected && ue3d_is_uevr_fresh(&data, taken_ms);
+    }
+
+    bool monitor_mode() const {
+        return has_valid_data() && data.monitor_mode != 0;
+    }
+
+    float stereo_depth_hint() const {
+        return has_valid_data() ? detail::SanitizeDepthHint(data.stereo_depth_hint) : 0.0f;
+    }
+
+    uint8_t depth_request() const {
+        return connected ? data.auto_depth_request : 0;
+    }
+
+    uint32_t command_seq() const {
+        return connected ? data.command_seq : 0;
+    }
+
+    float world_scale() const {
+        return has_valid_data() ? detail::SanitizeWorldScale(data.world_scale) : 100.0f;
+    }
+
+    bool calculate_auto_stereo(float& out_depth, float& out_convergence) const {
+        if (!has_valid_data()) return false;
+        return detail::AutoStereoFromWorldScale(world_scale(), out_depth, out_convergence);
+    }
+};
 
 class Receiver {
 public:
@@ -58,16 +278,16 @@ public:
 
     // ----- Lifecycle -----
 
+    /**
+     * Attach to UEVR's shared memory. The v5 mapping is tried first and only
+     * accepted if its header negotiates the v5 layout (magic, version,
+     * struct_size and UE3D_FLAG_LAYOUT_V5); otherwise the v4 block is used.
+     */
     bool init() {
-        if (m_data) return true;
-#ifndef _WIN32
-        return false;
-#else
-        m_mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, SHARED_MEM_NAME);
-        if (!m_mapping) return false;
+        if (is_connected()) return true;
+        if (m_allow_v5 && try_map_v5()) return true;
 
-        m_data = static_cast<SharedData*>(MapViewOfFile(
-            m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(SharedData)));
+        m_data = static_cast<SharedData*>(map_block(SHARED_MEM_NAME, sizeof(SharedData), m_mapping));
 
         if (!m_data) {
             cleanup();
@@ -79,25 +299,51 @@ public:
             return false;
         }
 
+        m_layout = Layout::V4;
         return true;
-#endif
     }
 
     void shutdown() {
-        if (m_data) {
+        if (m_v5) {
+            m_v5->vrto3d.connected = 0;
+        } else if (m_data) {
             m_data->vrto3d_connected = 0;
         }
         cleanup();
     }
 
-    bool is_connected() const { return m_data != nullptr; }
+    bool is_connected() const { return m_data != nullptr || m_v5 != nullptr; }
+
+    /** Layout negotiated by init(), Layout::None while disconnected. */
+    Layout layout() const { return m_layout; }
+
+    /**
+     * Allow init() to pick the v5 layout when UEVR publishes it (default on).
+     * Takes effect on the next init(); pass false to pin the v4 block.
+     */
+    void set_allow_v5(bool allow) { m_allow_v5 = allow; }
 
     uint32_t get_last_magic_mismatch() const { return m_last_magic_mismatch; }
 
+    /**
+     * True if the writer signals command_seq changes (v4.3 doorbell). UEVR
+     * creates the Windows event lazily, so wait_for_command() keeps polling
+     * and re-tries opening it every kCommandEventRetryMs until it exists.
+     */
+    bool has_command_doorbell() const {
+        return writer_has_doorbell(m_v5 ? m_v5->header.flags : (m_data ? m_data->flags : 0));
+    }
+
     // ----- Raw field accessors (for debug logging) -----
-    uint32_t raw_magic() const { return m_data ? m_data->magic : 0; }
-    uint32_t raw_version() const { return m_data ? m_data->version : 0; }
-    uint8_t  raw_is_valid() const { return m_data ? m_data->is_valid : 0; }
+    uint32_t raw_magic() const {
+        return m_v5 ? m_v5->header.magic : (m_data ? m_data->magic : 0);
+    }
+    uint32_t raw_version() const {
+        return m_v5 ? m_v5->header.version : (m_data ? m_data->version : 0);
+    }
+    uint8_t  raw_is_valid() const {
+        return m_v5 ? m_v5->uevr.is_valid : (m_data ? m_data->is_valid : 0);
+    }
 
     // ----- Heartbeat Update (call every frame) -----
 
@@ -107,7 +353,27 @@ public:
      */
     void update(float depth, float convergence, float fov, float fov_adj,
                 uint8_t sbs_mode, bool profile_loaded = false) {
-        if (!m_data && !init()) return;
+        if (!is_connected() && !init()) return;
+
+        if (m_v5) {
+            // Only VRto3D's own line is touched; UEVR's region stays clean.
+            if (!ue3d_is_v5_layout(m_v5)) {
+                cleanup();
+                return;
+            }
+            UE3D_V5_Vrto3d& out = m_v5->vrto3d;
+            out.depth = depth;
+            out.convergence = convergence;
+            out.fov = fov;
+            out.fov_adjustment = fov_adj;
+            out.sbs_mode = sbs_mode;
+            out.connected = 1;
+            out.profile_loaded = profile_loaded ? 1 : 0;
+            out.is_monitor_display = 1;
+            out.vrto3d_timestamp = GetTickCount64();
+            out.vrto3d_timestamp_ns = record_heartbeat();
+            return;
+        }
 
         if (m_data->magic != UEVR_MAGIC) {
             cleanup();
@@ -123,11 +389,175 @@ public:
         m_data->vrto3d_profile_loaded = profile_loaded ? 1 : 0;
         m_data->is_monitor_display = 1;
         m_data->vrto3d_timestamp = GetTickCount64();
+        m_data->vrto3d_timestamp_ns_lo = static_cast<uint32_t>(record_heartbeat());
+    }
+
+    // ----- Per-frame Snapshot -----
+
+    /**
+     * Copy the whole shared block once and return the copy. Call once per
+     * frame (after update()) and query the Snapshot instead of the live
+     * getters below. With a v4.2 writer the copy is retried until the seqlock
+     * confirms it is untorn; if UEVR stays mid-write for every attempt the
+     * previous coherent copy is kept. Pre-4.2 writers get a single plain copy.
+     * A v5 block is always seqlocked and is translated into the v4 shape.
+     */
+    const Snapshot& snapshot() {
+        if (m_v5) return snapshot_v5();
+        if (!m_data || m_data->magic != UEVR_MAGIC) {
+            m_snapshot = Snapshot{};
+            return m_snapshot;
+        }
+
+        const uint64_t now = GetTickCount64();
+        if (!ue3d_has_seqlock(m_data)) {
+            std::memcpy(&m_snapshot.data, m_data, sizeof(SharedData));
+            m_snapshot.taken_ms = now;
+            m_snapshot.connected = true;
+            m_snapshot.coherent = false;
+            m_snapshot.layout = Layout::V4;
+            record_frame(m_snapshot);
+            return m_snapshot;
+        }
+
+        for (int attempt = 0; attempt < kSnapshotRetries; ++attempt) {
+            const uint32_t seq = ue3d_seq_read_begin(m_data);
+            if ((seq & 1u) == 0) {
+                std::memcpy(&m_scratch, m_data, sizeof(SharedData));
+                if (!ue3d_seq_read_retry(m_data, seq)) {
+                    m_snapshot.data = m_scratch;
+                    m_snapshot.taken_ms = now;
+                    m_snapshot.connected = true;
+                    m_snapshot.coherent = true;
+                    m_snapshot.layout = Layout::V4;
+                    record_frame(m_snapshot);
+                    return m_snapshot;
+                }
+            }
+            if (attempt >= kSnapshotSpins) std::this_thread::yield();
+        }
+
+        // Writer never settled: keep the last coherent copy, re-evaluated
+        // against the current time so staleness still applies.
+        ++m_torn_snapshots;
+        m_snapshot.taken_ms = now;
+        m_snapshot.connected = true;
+        return m_snapshot;
     }
 
+    const Snapshot& last_snapshot() const { return m_snapshot; }
+
+    /** Number of snapshot() calls that gave up on a torn read. */
+    uint32_t get_torn_snapshot_count() const { return m_torn_snapshots; }
+
+    // ----- Leia Eye Prediction -----
+
+    /**
+     * Eye positions extrapolated to target_ns (UE3D ns clock, see
+     * detail::TickNs()). Uses the two newest coherent samples from
+     * 3DGameBridge's eye ring; the look-ahead is clamped to kLeiaMaxHorizonNs
+     * and a gap over kLeiaMaxSampleGapNs disables extrapolation. Without the
+     * ring this returns the single sample from the last snapshot() as-is.
+     * Returns false if no fresh, tracked sample exists.
+     */
+    bool predict_eyes(uint64_t target_ns, EyePose& out) {
+        const uint64_t now_ns = detail::TickNs();
+        UE3D_LeiaEyeSlot newest{}, older{};
+        const int n = read_leia_samples(newest, older);
+
+        if (n == 0) {
+            // No history: fall back to the single sample in the main block.
+            const SharedData& d = m_snapshot.data;
+            if (!m_snapshot.connected || !ue3d_has_leia_eyes(&d)) return false;
+            if (d.leia_timestamp_ns != 0 && now_ns - d.leia_timestamp_ns > kLeiaStaleNs) return false;
+            out = EyePose{};
+            out.left[0] = d.leia_left_eye_x;  out.left[1] = d.leia_left_eye_y;  out.left[2] = d.leia_left_eye_z;
+            out.right[0] = d.leia_right_eye_x; out.right[1] = d.leia_right_eye_y; out.right[2] = d.leia_right_eye_z;
+            out.sample_ns = d.leia_timestamp_ns;
+            out.target_ns = target_ns;
+            return true;
+        }
+        if (now_ns - newest.timestamp_ns > kLeiaStaleNs) return false;
+
+        out = EyePose{};
+        const float p1[6] = { newest.left_eye_x, newest.left_eye_y, newest.left_eye_z,
+                              newest.right_eye_x, newest.right_eye_y, newest.right_eye_z };
+        float p[6];
+        std::copy(p1, p1 + 6, p);
+
+        const uint64_t dt = newest.timestamp_ns - older.timestamp_ns;
+        if (n == 2 && older.timestamp_ns < newest.timestamp_ns && dt <= kLeiaMaxSampleGapNs) {
+            const uint64_t horizon = target_ns > newest.timestamp_ns
+                ? (std::min)(target_ns - newest.timestamp_ns, kLeiaMaxHorizonNs) : 0;
+            const float t = static_cast<float>(static_cast<double>(horizon) / static_cast<double>(dt));
+            const float p0[6] = { older.left_eye_x, older.left_eye_y, older.left_eye_z,
+                                  older.right_eye_x, older.right_eye_y, older.right_eye_z };
+            for (int i = 0; i < 6; ++i) p[i] = p1[i] + (p1[i] - p0[i]) * t;
+            out.predicted = true;
+        }
+
+        std::copy(p, p + 3, out.left);
+        std::copy(p + 3, p + 6, out.right);
+        out.sample_ns = newest.timestamp_ns;
+        out.target_ns = target_ns;
+        return true;
+    }
+
+    /** predict_eyes() for "now + display_latency" (seconds, as in
+     *  StereoDisplayDriverConfiguration::display_latency). */
+    bool predict_eyes_for_latency(float display_latency_s, EyePose& out) {
+        const double latency_ns = (std::max)(0.0, static_cast<double>(display_latency_s) * 1e9);
+        return predict_eyes(detail::TickNs() + static_cast<uint64_t>(latency_ns), out);
+    }
+
+    bool has_leia_ring() const { return m_leia != nullptr; }
+
+    // ----- Telemetry -----
+
+    /** p50/p99 over the last kTelemetrySamples snapshots / heartbeats. */
+    TelemetryStats get_telemetry() const {
+        TelemetryStats t;
+        t.frame_age_samples = m_frame_age.count();
+        t.frame_age_p50_us = m_frame_age.percentile(0.50);
+        t.frame_age_p99_us = m_frame_age.percentile(0.99);
+        t.heartbeat_samples = m_heartbeat.count();
+        t.heartbeat_p50_us = m_heartbeat.percentile(0.50);
+        t.heartbeat_p99_us = m_heartbeat.percentile(0.99);
+        t.dropped_frames = m_dropped_frames;
+        t.duplicate_frames = m_duplicate_frames;
+        t.torn_snapshots = m_torn_snapshots;
+        return t;
+    }
+
+    void reset_telemetry() {
+        m_frame_age.clear();
+        m_heartbeat.clear();
+        m_dropped_frames = m_duplicate_frames = 0;
+        m_last_frame_count_valid = false;
+        m_last_heartbeat_ns = 0;
+    }
+
+    /**
+     * Hand get_telemetry() to `sink` from snapshot() every
+     * set_telemetry_log_interval() ms. The receiver does no logging of its
+     * own (this header stays free of VRto3D dependencies), so the caller
+     * formats and logs the summary; nullptr (the default) disables it.
+     */
+    void set_telemetry_sink(TelemetrySink sink, void* user = nullptr) {
+        m_telemetry_sink = sink;
+        m_telemetry_sink_user = user;
+    }
+
+    /** Period of the telemetry sink calls from snapshot(); 0 disables. */
+    void set_telemetry_log_interval(uint32_t ms) { m_telemetry_log_ms = ms; }
+
     // ----- Data Validity -----
 
     bool has_valid_data() const {
+        if (m_v5) {
+            if (!m_v5->uevr.is_valid) return false;
+            return (GetTickCount64() - m_v5->uevr.uevr_timestamp) < UE3D_STALE_MS;
+        }
         if (!m_data) return false;
         if (!m_data->is_valid) return false;
         uint64_t now = GetTickCount64();
@@ -137,32 +567,85 @@ public:
     // ----- Monitor Mode -----
 
     bool get_monitor_mode() const {
-        return has_valid_data() && m_data->monitor_mode != 0;
+        if (!has_valid_data()) return false;
+        return (m_v5 ? m_v5->uevr.monitor_mode : m_data->monitor_mode) != 0;
     }
 
     // ----- Stereo Depth Hint (for overlay IPD matching) -----
 
     float get_stereo_depth_hint() const {
         if (!has_valid_data()) return 0.0f;
-        float hint = m_data->stereo_depth_hint;
-        return (std::isfinite(hint) && hint > 0.0f && hint < 2.0f) ? hint : 0.0f;
+        return detail::SanitizeDepthHint(
+            m_v5 ? m_v5->uevr.stereo_depth_hint : m_data->stereo_depth_hint);
     }
 
     // ----- Depth Commands (UEVR -> VRto3D) -----
 
-    uint8_t get_depth_request() const {
-        if (!m_data) return 0;
-        return m_data->auto_depth_request;
-    }
+    // v5 never writes into UEVR's region: a request is pending while
+    // uevr.command_seq differs from our command_ack, and clearing it means
+    // acknowledging that sequence number.
+
+    uint8_t get_depth_request() const { return depth_request(m_data, m_v5); }
 
     void clear_depth_request() {
+        if (m_v5) {
+            m_v5->vrto3d.command_ack = m_v5->uevr.command_seq;
+            return;
+        }
         if (m_data) m_data->auto_depth_request = 0;
     }
 
+    /**
+     * Block until a depth command is pending or timeout_ms elapses; returns
+     * true if a depth request is pending on return. With a doorbell writer
+     * this sleeps on the event/futex and wakes as soon as UEVR bumps
+     * command_seq; otherwise it polls every kCommandPollMs. A pending
+     * command keeps returning true until clear_depth_request() is called.
+     *
+     * Meant for a command thread that runs while the frame thread is
+     * stalled: the wait maps the block and opens the event itself, so
+     * update()/snapshot()/shutdown() dropping the frame thread's mapping
+     * never pulls memory or a handle out from under it. It attaches on
+     * first use (returning false at once if there is no writer) and keeps
+     * its mapping until release_command_wait(). One waiting thread at a
+     * time.
+     */
+    bool wait_for_command(uint32_t timeout_ms) {
+        if (!attach_waiter()) return false;
+
+        const uint64_t deadline = GetTickCount64() + timeout_ms;
+        for (;;) {
+            // Sample the sequence before checking, so a command landing in
+            // between makes the wait below return immediately.
+            const uint32_t seq = waiter_command_word().load(std::memory_order_acquire);
+            if (depth_request(m_waiter.data, m_waiter.v5) != 0) return true;
+
+            const uint64_t now = GetTickCount64();
+            if (now >= deadline) return false;
+            const uint32_t remaining = static_cast<uint32_t>(deadline - now);
+
+            if (waiter_has_doorbell()) {
+                wait_doorbell(seq, remaining);
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(
+                    (std::min)(remaining, kCommandPollMs)));
+            }
+
+            // The writer may have gone away (or switched layout) meanwhile.
+            if (!attach_waiter()) return false;
+        }
+    }
+
+    /**
+     * Drop wait_for_command()'s mapping and event. Call from the waiting
+     * thread once it stops waiting; the destructor covers the rest.
+     */
+    void release_command_wait() { detach_waiter(); }
+
     float get_world_scale() const {
         if (!has_valid_data()) return 100.0f;
-        float ws = m_data->world_scale;
-        return (std::isfinite(ws) && ws > 0.0f) ? ws : 100.0f;
+        return detail::SanitizeWorldScale(
+            m_v5 ? m_v5->uevr.world_scale : m_data->world_scale);
     }
 
     /**
@@ -171,43 +654,373 @@ public:
      */
     bool calculate_auto_stereo(float& out_depth, float& out_convergence) const {
         if (!has_valid_data()) return false;
-        float ws = get_world_scale();
-        if (ws < 0.1f) return false;
-        float scale_factor = ws / 100.0f;
-        out_depth = (std::max)(0.02f, (std::min)(0.08f * scale_factor, 0.50f));
-        out_convergence = 1.0f;
-        return true;
+        return detail::AutoStereoFromWorldScale(get_world_scale(), out_depth, out_convergence);
     }
 
 private:
     Receiver() = default;
-    ~Receiver() { shutdown(); }
+    ~Receiver() {
+        shutdown();
+        detach_waiter();
+    }
     Receiver(const Receiver&) = delete;
     Receiver& operator=(const Receiver&) = delete;
 
-    void cleanup() {
+    // Immediate retries before yielding, and the total before giving up. A
+    // UEVR update is a few dozen stores, so the first retry almost always wins.
+    static constexpr int kSnapshotSpins = 4;
+    static constexpr int kSnapshotRetries = 16;
+
+    // Poll interval for wait_for_command() when the writer has no doorbell,
+    // and how often it re-tries opening a doorbell event not created yet.
+    static constexpr uint32_t kCommandPollMs = 2;
+    static constexpr uint64_t kCommandEventRetryMs = 250;
+
+    static constexpr size_t kTelemetrySamples = 512;
+
+    // Leia prediction limits. Past ~50 ms linear extrapolation overshoots
+    // head motion more than it helps; a 100 ms sample gap means tracking
+    // dropped out and the velocity is meaningless.
+    static constexpr uint64_t kLeiaMaxHorizonNs   = 50ull * 1000000ull;
+    static constexpr uint64_t kLeiaMaxSampleGapNs = 100ull * 1000000ull;
+    static constexpr uint64_t kLeiaStaleNs        = uint64_t(UE3D_STALE_MS) * 1000000ull;
+    static constexpr uint64_t kLeiaRetryMs        = 1000;  // re-probe for the ring
+    static constexpr uint32_t kLeiaScanSlots      = 4;     // torn / untracked slots to skip
+
+    // Maps the companion ring on demand, re-probing at most every kLeiaRetryMs.
+    bool ensure_leia_ring() {
+        if (m_leia) {
+            if (ue3d_is_leia_ring(m_leia)) return true;
+            unmap_leia_ring();
+        }
+        const uint64_t now = GetTickCount64();
+        if (m_leia_probe_ms != 0 && now - m_leia_probe_ms < kLeiaRetryMs) return false;
+        m_leia_probe_ms = now;
+
+        m_leia = static_cast<UE3D_LeiaEyeRing*>(
+            map_block(UE3D_LEIA_RING_NAME, sizeof(UE3D_LeiaEyeRing), m_leia_mapping));
+        if (!m_leia || !ue3d_is_leia_ring(m_leia)) {
+            unmap_leia_ring();
+            return false;
+        }
+        return true;
+    }
+
+    // Copies up to two coherent, tracked samples, newest first; returns how many.
+    int read_leia_samples(UE3D_LeiaEyeSlot& newest, UE3D_LeiaEyeSlot& older) {
+        if (!ensure_leia_ring()) return 0;
+
+        const uint32_t head = ue3d_leia_head(m_leia).load(std::memory_order_acquire);
+        const uint32_t avail = (std::min)(head, (uint32_t)UE3D_LEIA_RING_SLOTS - 1);
+        const uint32_t scan = (std::min)(avail, kLeiaScanSlots);
+        int found = 0;
+        for (uint32_t i = 1; i <= scan && found < 2; ++i) {
+            const UE3D_LeiaEyeSlot* slot = &m_leia->slots[(head - i) % UE3D_LEIA_RING_SLOTS];
+            UE3D_LeiaEyeSlot copy;
+            const uint32_t seq = ue3d_seq_read_begin(slot);
+            std::memcpy(&copy, slot, sizeof(copy));
+            if (ue3d_seq_read_retry(slot, seq) || !copy.tracking_active) continue;
+            (found == 0 ? newest : older) = copy;
+            ++found;
+        }
+        return found;
+    }
+
+    void unmap_leia_ring() {
+        if (m_leia) {
+            unmap_block(m_leia, sizeof(UE3D_LeiaEyeRing));
+            m_leia = nullptr;
+        }
+#ifdef _WIN32
+        if (m_leia_mapping) {
+            CloseHandle(m_leia_mapping);
+            m_leia_mapping = nullptr;
+        }
+#endif
+    }
+
+    // A frame_count jump this large is a UEVR restart, not dropped frames.
+    static constexpr uint32_t kFrameCountResetJump = 100000;
+
+    uint64_t record_heartbeat() {
+        const uint64_t now_ns = detail::TickNs();
+        if (m_last_heartbeat_ns != 0)
+            m_heartbeat.push(static_cast<uint32_t>((std::min)(
+                (now_ns - m_last_heartbeat_ns) / 1000, (uint64_t)UINT32_MAX)));
+        m_last_heartbeat_ns = now_ns;
+        return now_ns;
+    }
+
+    void record_frame(const Snapshot& s) {
+        if (!s.has_valid_data()) {
+            m_last_frame_count_valid = false;
+            return;
+        }
+
+        const uint64_t now_ns = detail::TickNs();
+        if ((s.data.flags & UE3D_FLAG_TIMESTAMP_NS) && s.data.uevr_timestamp_ns != 0 &&
+            now_ns >= s.data.uevr_timestamp_ns) {
+            m_frame_age.push(static_cast<uint32_t>((std::min)(
+                (now_ns - s.data.uevr_timestamp_ns) / 1000, (uint64_t)UINT32_MAX)));
+        }
+
+        const uint32_t frame = s.data.uevr_frame_count;
+        if (m_last_frame_count_valid) {
+            const uint32_t delta = frame - m_last_frame_count;
+            if (delta == 0) ++m_duplicate_frames;
+            else if (delta < kFrameCountResetJump) m_dropped_frames += delta - 1;
+        }
+        m_last_frame_count = frame;
+        m_last_frame_count_valid = true;
+
+        if (m_telemetry_sink && m_telemetry_log_ms != 0 &&
+            s.taken_ms - m_last_telemetry_log_ms >= m_telemetry_log_ms) {
+            if (m_last_telemetry_log_ms != 0) m_telemetry_sink(get_telemetry(), m_telemetry_sink_user);
+            m_last_telemetry_log_ms = s.taken_ms;
+        }
+    }
+
+    // get_depth_request() against either view of the block.
+    static uint8_t depth_request(const SharedData* data, const SharedDataV5* v5) {
+        if (v5) {
+            return v5->uevr.command_seq != v5->vrto3d.command_ack
+                ? v5->uevr.auto_depth_request : 0;
+        }
+        return data ? data->auto_depth_request : 0;
+    }
+
+    static bool writer_has_doorbell(uint32_t flags) {
+#if defined(_WIN32) || defined(__linux__)
+        return (flags & UE3D_FLAG_COMMAND_DOORBELL) != 0;
+#else
+        (void)flags;
+        return false;
+#endif
+    }
+
 #ifdef _WIN32
+    using MappingHandle = HANDLE;
+#else
+    using MappingHandle = void*;  // unused: the view keeps the shm object alive
+#endif
+
+    // wait_for_command()'s own view of the block and doorbell event. Only the
+    // waiting thread touches it, so cleanup() on the frame thread can unmap
+    // and re-map freely while a wait is blocked.
+    struct CommandWaiter {
+        MappingHandle mapping = nullptr;
+        SharedData* data = nullptr;
+        SharedDataV5* v5 = nullptr;
+#ifdef _WIN32
+        HANDLE event = nullptr;
+        uint64_t event_probe_ms = 0;
+#endif
+    };
+
+    // Keeps the waiter's view if it still holds a live block, otherwise maps
+    // one with init()'s layout preference. False if there is no writer.
+    bool attach_waiter() {
+        CommandWaiter& w = m_waiter;
+        if (w.v5 && ue3d_is_v5_layout(w.v5)) return true;
+        if (w.data && w.data->magic == UEVR_MAGIC) return true;
+        detach_waiter();
+
+        if (m_allow_v5) {
+            w.v5 = static_cast<SharedDataV5*>(map_block(UE3D_V5_SHMEM_NAME, sizeof(SharedDataV5), w.mapping));
+            if (w.v5 && ue3d_is_v5_layout(w.v5)) return true;
+            detach_waiter();
+        }
+        w.data = static_cast<SharedData*>(map_block(SHARED_MEM_NAME, sizeof(SharedData), w.mapping));
+        if (w.data && w.data->magic == UEVR_MAGIC) return true;
+        detach_waiter();
+        return false;
+    }
+
+    void detach_waiter() {
+        CommandWaiter& w = m_waiter;
+        if (w.v5) unmap_block(w.v5, sizeof(SharedDataV5));
+        if (w.data) unmap_block(w.data, sizeof(SharedData));
+#ifdef _WIN32
+        if (w.mapping) CloseHandle(w.mapping);
+        if (w.event) CloseHandle(w.event);
+#endif
+        w = CommandWaiter{};
+    }
+
+    std::atomic<uint32_t>& waiter_command_word() {
+        return m_waiter.v5 ? ue3d_command_word(m_waiter.v5) : ue3d_command_word(m_waiter.data);
+    }
+
+    // The event is optional: UEVR creates it only when it first rings the
+    // doorbell, so a missing one is re-tried rather than given up on. On
+    // Linux the doorbell is a futex on the mapping itself.
+    bool waiter_has_doorbell() {
+        CommandWaiter& w = m_waiter;
+        if (!writer_has_doorbell(w.v5 ? w.v5->header.flags : w.data->flags)) return false;
+#ifdef _WIN32
+        if (!w.event) {
+            const uint64_t now = GetTickCount64();
+            if (w.event_probe_ms != 0 && now - w.event_probe_ms < kCommandEventRetryMs) return false;
+            w.event_probe_ms = now;
+            w.event = OpenEventA(SYNCHRONIZE, FALSE, UE3D_COMMAND_EVENT_NAME);
+        }
+        return w.event != nullptr;
+#else
+        return true;
+#endif
+    }
+
+    // One doorbell wait; spurious and stale wakeups are fine, the caller
+    // re-checks command state.
+    void wait_doorbell(uint32_t seq, uint32_t timeout_ms) {
+#ifdef _WIN32
+        (void)seq;
+        WaitForSingleObject(m_waiter.event, timeout_ms);
+#elif defined(__linux__)
+        timespec ts;
+        ts.tv_sec = static_cast<time_t>(timeout_ms / 1000);
+        ts.tv_nsec = static_cast<long>(timeout_ms % 1000) * 1000000L;
+        // Shared (non-PRIVATE) futex: the word lives in another process' mapping.
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&waiter_command_word()),
+                FUTEX_WAIT, seq, &ts, nullptr, 0);
+#else
+        (void)seq;
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+#endif
+    }
+
+    // Map `size` bytes of the named block read/write, or nullptr. Never
+    // creates the block: its writer owns the lifetime.
+    static void* map_block(const char* name, size_t size, MappingHandle& mapping) {
+#ifdef _WIN32
+        mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name);
+        if (!mapping) return nullptr;
+        return MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+#elif defined(__linux__)
+        (void)mapping;
+        const int fd = detail::OpenShmBlock(name);
+        if (fd < 0) return nullptr;
+
+        // A short file would SIGBUS on first access past its end.
+        struct stat st;
+        void* view = nullptr;
+        if (fstat(fd, &st) == 0 && st.st_size >= static_cast<off_t>(size)) {
+            view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (view == MAP_FAILED) view = nullptr;
+        }
+        close(fd);  // the mapping keeps the object alive
+        return view;
+#else
+        (void)name;
+        (void)size;
+        (void)mapping;
+        return nullptr;
+#endif
+    }
+
+    static void unmap_block(void* view, size_t size) {
+#ifdef _WIN32
+        (void)size;
+        UnmapViewOfFile(view);
+#elif defined(__linux__)
+        munmap(view, size);
+#else
+        (void)view;
+        (void)size;
+#endif
+    }
+
+    bool try_map_v5() {
+        m_v5 = static_cast<SharedDataV5*>(map_block(UE3D_V5_SHMEM_NAME, sizeof(SharedDataV5), m_mapping));
+        if (!m_v5 || !ue3d_is_v5_layout(m_v5)) {
+            if (m_v5 && m_v5->header.magic != UEVR_MAGIC)
+                m_last_magic_mismatch = m_v5->header.magic;
+            cleanup();
+            return false;
+        }
+
+        m_layout = Layout::V5;
+        return true;
+    }
+
+    const Snapshot& snapshot_v5() {
+        if (!ue3d_is_v5_layout(m_v5)) {
+            m_snapshot = Snapshot{};
+            return m_snapshot;
+        }
+
+        const uint64_t now = GetTickCount64();
+        for (int attempt = 0; attempt < kSnapshotRetries; ++attempt) {
+            const uint32_t seq = ue3d_seq_read_begin(m_v5);
+            if ((seq & 1u) == 0) {
+                std::memcpy(&m_scratch_v5, m_v5, sizeof(SharedDataV5));
+                if (!ue3d_seq_read_retry(m_v5, seq)) {
+                    ue3d_v5_to_v4(&m_scratch_v5, &m_snapshot.data);
+                    m_snapshot.taken_ms = now;
+                    m_snapshot.connected = true;
+                    m_snapshot.coherent = true;
+                    m_snapshot.layout = Layout::V5;
+                    record_frame(m_snapshot);
+                    return m_snapshot;
+                }
+            }
+            if (attempt >= kSnapshotSpins) std::this_thread::yield();
+        }
+
+        ++m_torn_snapshots;
+        m_snapshot.taken_ms = now;
+        m_snapshot.connected = true;
+        m_snapshot.layout = Layout::V5;
+        return m_snapshot;
+    }
+
+    void cleanup() {
+        m_snapshot = Snapshot{};
+        m_layout = Layout::None;
+        unmap_leia_ring();
+        m_leia_probe_ms = 0;
         if (m_data) {
-            UnmapViewOfFile(m_data);
+            unmap_block(m_data, sizeof(SharedData));
             m_data = nullptr;
         }
+        if (m_v5) {
+            unmap_block(m_v5, sizeof(SharedDataV5));
+            m_v5 = nullptr;
+        }
+#ifdef _WIN32
         if (m_mapping) {
             CloseHandle(m_mapping);
             m_mapping = nullptr;
         }
-#else
-        m_data = nullptr;
-        m_mapping = nullptr;
 #endif
     }
 
-#ifdef _WIN32
-    HANDLE m_mapping = nullptr;
-#else
-    void* m_mapping = nullptr;
-#endif
-    SharedData* m_data = nullptr;
+    MappingHandle m_mapping = nullptr;
+    MappingHandle m_leia_mapping = nullptr;
+    CommandWaiter m_waiter;             // wait_for_command() thread only
+    SharedData* m_data = nullptr;       // set when m_layout == V4
+    SharedDataV5* m_v5 = nullptr;       // set when m_layout == V5
+    UE3D_LeiaEyeRing* m_leia = nullptr; // optional companion mapping
+    uint64_t m_leia_probe_ms = 0;
+    Layout m_layout = Layout::None;
+    std::atomic<bool> m_allow_v5{true};  // also read by the waiting thread
     uint32_t m_last_magic_mismatch = 0;
+    Snapshot m_snapshot;
+    SharedData m_scratch{};
+    SharedDataV5 m_scratch_v5{};
+    uint32_t m_torn_snapshots = 0;
+
+    detail::SampleRing<kTelemetrySamples> m_frame_age;
+    detail::SampleRing<kTelemetrySamples> m_heartbeat;
+    uint64_t m_dropped_frames = 0;
+    uint64_t m_duplicate_frames = 0;
+    uint64_t m_last_heartbeat_ns = 0;
+    uint64_t m_last_telemetry_log_ms = 0;
+    uint32_t m_telemetry_log_ms = 10000;
+    TelemetrySink m_telemetry_sink = nullptr;
+    void* m_telemetry_sink_user = nullptr;
+    uint32_t m_last_frame_count = 0;
+    bool m_last_frame_count_valid = false;
 };
 
 inline Receiver& receiver() {
@@ -25,8 +25,11 @@
 #include <cstring>
 #include <cmath>
 #include <filesystem>
+#include <future>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include <windows.h>
@@ -35,6 +38,8 @@
 
 #include "vrto3dlib/debug_log.hpp"
 #include "vrto3dlib/hotkey_eval.hpp"
+#include "vrto3dlib/input_state.h"
+#include "vrto3dlib/pad_history.h"
 #include "vrto3dlib/stereo_config.h"
 
 
@@ -105,22 +110,249 @@ inline void SwitchToXinpuGetStateEx()
 
 
 //-----------------------------------------------------------------------------
-// Purpose: Get XInput button state including triggers as buttons
+// Purpose: Background XInput poller. XInputGetState on an empty slot costs
+//          hundreds of microseconds, so frame-side code never calls it: one
+//          thread polls connected slots every kPollUs, retries empty slots with
+//          exponential backoff (kRetryMinMs..kRetryMaxMs), and publishes each
+//          slot's new packets into its PadHistory plus an all-pads merge (as
+//          the Linux GetGamepadState()) under a seqlock. Single writer;
+//          readers never block.
+//
+//          Started lazily by the first read. Call StopXInputPoller() from
+//          driver shutdown: joining from a static destructor would run under
+//          the loader lock.
 //-----------------------------------------------------------------------------
-inline bool GetXInputButtonState(DWORD& outButtons, DWORD userIndex = 0)
+class XInputPoller {
+public:
+    static constexpr DWORD kSlots = XUSER_MAX_COUNT;
+    static constexpr uint32_t kPollUs = 2000;
+    static constexpr uint32_t kRetryMinMs = 100;
+    static constexpr uint32_t kRetryMaxMs = 2000;
+
+    ~XInputPoller()
+    {
+        // Last resort only; see StopXInputPoller().
+        m_running.store(false, std::memory_order_relaxed);
+        if (m_thread.joinable()) m_thread.detach();
+    }
+
+    // Cached state of one slot, or the merge of all slots for XUSER_INDEX_ANY.
+    vrto3d::input::GamepadState Get(DWORD userIndex)
+    {
+        EnsureStarted();
+        return userIndex < kSlots ? m_slots[userIndex].Latest() : Read(m_merged);
+    }
+
+    // Recent packets of one slot (nullptr for an invalid index).
+    const vrto3d::input::PadHistory* History(DWORD userIndex)
+    {
+        EnsureStarted();
+        return userIndex < kSlots ? &m_slots[userIndex] : nullptr;
+    }
+
+    void Stop()
+    {
+        std::lock_guard<std::mutex> lock(m_lifecycle);
+        if (!m_thread.joinable()) return;
+        m_running.store(false, std::memory_order_relaxed);
+        if (m_wake) SetEvent(m_wake);
+        m_thread.join();
+        if (m_wake) {
+            CloseHandle(m_wake);
+            m_wake = nullptr;
+        }
+        for (auto& slot : m_slots) {
+            if (slot.Latest().connected) {
+                vrto3d::input::GamepadState gone;
+                gone.time_ns = vrto3d::input::InputClockNs();
+                slot.Push(gone);
+            }
+        }
+        Publish(m_merged, vrto3d::input::GamepadState{});
+    }
+
+private:
+    struct Record {
+        std::atomic<uint32_t> seq{0};
+        std::atomic<uint64_t> buttons{0};  // connected | wButtons<<8 | LT<<24 | RT<<32
+        std::atomic<uint64_t> sticks{0};   // LX | LY<<16 | RX<<32 | RY<<48
+        std::atomic<uint64_t> time_ns{0};
+    };
+
+    void EnsureStarted()
+    {
+        if (m_running.load(std::memory_order_acquire)) return;
+        std::lock_guard<std::mutex> lock(m_lifecycle);
+        if (m_thread.joinable()) return;
+        m_wake = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+        m_running.store(true, std::memory_order_release);
+        m_thread = std::thread([this] { Run(); });
+    }
+
+    static void Publish(Record& r, const vrto3d::input::GamepadState& pad)
+    {
+        const uint64_t buttons = vrto3d::input::detail::PackPadButtons(pad);
+        const uint64_t sticks = vrto3d::input::detail::PackPadSticks(pad);
+        r.seq.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        r.buttons.store(buttons, std::memory_order_relaxed);
+        r.sticks.store(sticks, std::memory_order_relaxed);
+        r.time_ns.store(pad.time_ns, std::memory_order_relaxed);
+        r.seq.fetch_add(1, std::memory_order_release);
+    }
+
+    static vrto3d::input::GamepadState Read(const Record& r)
+    {
+        uint64_t buttons, sticks, time_ns;
+        for (;;) {
+            const uint32_t seq = r.seq.load(std::memory_order_acquire);
+            if (seq & 1u) {
+                std::this_thread::yield();
+                continue;
+            }
+            buttons = r.buttons.load(std::memory_order_relaxed);
+            sticks = r.sticks.load(std::memory_order_relaxed);
+            time_ns = r.time_ns.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (r.seq.load(std::memory_order_relaxed) == seq) break;
+        }
+        return vrto3d::input::detail::UnpackPad(buttons, sticks, time_ns);
+    }
+
+    void Run()
+    {
+        // A high-resolution waitable timer gives a real 2 ms period without
+        // timeBeginPeriod; older Windows falls back to a regular timer.
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+        HANDLE timer = CreateWaitableTimerExW(nullptr, nullptr,
+            CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        if (!timer) timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+
+        vrto3d::input::GamepadState pads[kSlots];
+        DWORD packets[kSlots] = {};
+        ULONGLONG retry_at[kSlots] = {};
+        uint32_t backoff_ms[kSlots] = {};
+
+        while (m_running.load(std::memory_order_relaxed)) {
+            const ULONGLONG now_ms = GetTickCount64();
+            bool changed = false;
+            for (DWORD i = 0; i < kSlots; ++i) {
+                if (!pads[i].connected && now_ms < retry_at[i]) continue;
+
+                XINPUT_STATE state{};
+                if (_XInputGetState(i, &state) != ERROR_SUCCESS) {
+                    // ERROR_DEVICE_NOT_CONNECTED (or worse): empty slot.
+                    backoff_ms[i] = backoff_ms[i] ? (std::min)(backoff_ms[i] * 2, kRetryMaxMs) : kRetryMinMs;
+                    retry_at[i] = now_ms + backoff_ms[i];
+                    if (pads[i].connected) {
+                        pads[i] = vrto3d::input::GamepadState{};
+                        pads[i].time_ns = vrto3d::input::InputClockNs();
+                        m_slots[i].Push(pads[i]);
+                        changed = true;
+                    }
+                    continue;
+                }
+                backoff_ms[i] = 0;
+                if (pads[i].connected && state.dwPacketNumber == packets[i]) continue;
+
+                packets[i] = state.dwPacketNumber;
+                pads[i].connected = true;
+                pads[i].wButtons = state.Gamepad.wButtons;
+                pads[i].bLeftTrigger = state.Gamepad.bLeftTrigger;
+                pads[i].bRightTrigger = state.Gamepad.bRightTrigger;
+                pads[i].sThumbLX = state.Gamepad.sThumbLX;
+                pads[i].sThumbLY = state.Gamepad.sThumbLY;
+                pads[i].sThumbRX = state.Gamepad.sThumbRX;
+                pads[i].sThumbRY = state.Gamepad.sThumbRY;
+                pads[i].time_ns = vrto3d::input::InputClockNs();
+                m_slots[i].Push(pads[i]);
+                changed = true;
+            }
+            if (changed) Publish(m_merged, Merge(pads));
+
+            if (timer) {
+                LARGE_INTEGER due;
+                due.QuadPart = -static_cast<LONGLONG>(kPollUs) * 10;  // 100 ns units, relative
+                SetWaitableTimer(timer, &due, 0, nullptr, nullptr, FALSE);
+                HANDLE waits[2] = { m_wake, timer };
+                WaitForMultipleObjects(m_wake ? 2 : 1, m_wake ? waits : waits + 1, FALSE, INFINITE);
+            } else {
+                Sleep(1);
+            }
+        }
+        if (timer) CloseHandle(timer);
+    }
+
+    static vrto3d::input::GamepadState Merge(const vrto3d::input::GamepadState (&pads)[kSlots])
+    {
+        vrto3d::input::GamepadState merged;
+        const auto max_magnitude = [](int16_t& dst, int16_t v) {
+            if (std::abs(static_cast<int>(v)) > std::abs(static_cast<int>(dst))) dst = v;
+        };
+        for (const auto& pad : pads) {
+            if (!pad.connected) continue;
+            merged.connected = true;
+            merged.wButtons |= pad.wButtons;
+            merged.bLeftTrigger = (std::max)(merged.bLeftTrigger, pad.bLeftTrigger);
+            merged.bRightTrigger = (std::max)(merged.bRightTrigger, pad.bRightTrigger);
+            max_magnitude(merged.sThumbLX, pad.sThumbLX);
+            max_magnitude(merged.sThumbLY, pad.sThumbLY);
+            max_magnitude(merged.sThumbRX, pad.sThumbRX);
+            max_magnitude(merged.sThumbRY, pad.sThumbRY);
+            merged.time_ns = (std::max)(merged.time_ns, pad.time_ns);
+        }
+        return merged;
+    }
+
+    static_assert(kSlots == vrto3d::input::kMaxPads, "pad slots are XInput user indices");
+    vrto3d::input::PadHistory m_slots[kSlots];
+    Record m_merged;
+    std::atomic<bool> m_running{false};
+    std::mutex m_lifecycle;
+    std::thread m_thread;
+    HANDLE m_wake = nullptr;
+};
+
+// One poller program-wide (function-local static, as XInputGetStateRef()).
+inline XInputPoller& GetXInputPoller()
 {
-    XINPUT_STATE state{};
-    if (_XInputGetState(userIndex, &state) != ERROR_SUCCESS) {
+    static XInputPoller poller;
+    return poller;
+}
+
+inline void StopXInputPoller()
+{
+    GetXInputPoller().Stop();
+}
+
+// Cached pad state; XUSER_INDEX_ANY (default) = all pads merged.
+inline vrto3d::input::GamepadState GetXInputGamepadState(DWORD userIndex = XUSER_INDEX_ANY)
+{
+    return GetXInputPoller().Get(userIndex);
+}
+
+
+//-----------------------------------------------------------------------------
+// Purpose: Get XInput button state including triggers as buttons. Reads the
+//          poller's cache; the default XUSER_INDEX_ANY merges every pad, as
+//          the Linux backend does.
+//-----------------------------------------------------------------------------
+inline bool GetXInputButtonState(DWORD& outButtons, DWORD userIndex = XUSER_INDEX_ANY)
+{
+    const vrto3d::input::GamepadState pad = GetXInputGamepadState(userIndex);
+    if (!pad.connected) {
         outButtons = 0;
         return false;
     }
 
-    DWORD buttons = state.Gamepad.wButtons;
+    DWORD buttons = pad.wButtons;
 
-    if (state.Gamepad.bLeftTrigger > XINPUT_GAMEPAD_TRIGGER_THRESHOLD)
+    if (pad.bLeftTrigger > XINPUT_GAMEPAD_TRIGGER_THRESHOLD)
         buttons |= XINPUT_GAMEPAD_LEFT_TRIGGER;
 
-    if (state.Gamepad.bRightTrigger > XINPUT_GAMEPAD_TRIGGER_THRESHOLD)
+    if (pad.bRightTrigger > XINPUT_GAMEPAD_TRIGGER_THRESHOLD)
         buttons |= XINPUT_GAMEPAD_RIGHT_TRIGGER;
 
     outButtons = buttons;
@@ -131,10 +363,62 @@ inline bool GetXInputButtonState(DWORD& outButtons, DWORD userIndex = 0)
 //-----------------------------------------------------------------------------
 // Purpose: Cleaner check for key down state
 //-----------------------------------------------------------------------------
-inline auto isDown = [](int vk) { return GetAsyncKeyState(vk) & 0x8000; };
+// isDown(vk) queries live state: the Raw Input backend's bitset when
+// input::Start() succeeded (one atomic load), else GetAsyncKeyState.
+// isDown(frame, vk) reads a per-frame InputFrame so a whole frame of hotkey
+// checks agrees.
+struct KeyDownQuery {
+    bool operator()(int vk) const
+    {
+        if (vrto3d::input::PermissionOk())
+            return vrto3d::input::IsKeyDown(vk);
+        return (GetAsyncKeyState(vk) & 0x8000) != 0;
+    }
+    bool operator()(const vrto3d::input::InputFrame& frame, int vk) const
+    {
+        return frame.IsKeyDown(vk);
+    }
+};
+inline constexpr KeyDownQuery isDown{};
 inline auto isCtrlDown = [&]() { return isDown(VK_CONTROL); };
 
 
+//-----------------------------------------------------------------------------
+// Purpose: Capture this frame's input. With the Raw Input backend running
+//          this is one lock-free input::Snapshot(). Otherwise only the keys
+//          `cfg` references are sampled (one GetAsyncKeyState each) plus the
+//          poller's cached, merged pad when a binding uses it; unreferenced
+//          keys read as up.
+//-----------------------------------------------------------------------------
+inline void SnapshotInputFrame(const StereoDisplayDriverConfiguration& cfg,
+                               vrto3d::input::InputFrame& frame)
+{
+    if (vrto3d::input::PermissionOk()) {
+        vrto3d::input::Snapshot(frame);
+        return;
+    }
+    frame = vrto3d::input::InputFrame{};
+    bool want_pad = cfg.reset_xinput || cfg.ctrl_xinput;
+
+    auto sample = [&](int vk) {
+        if (vk > 0 && vk < 256 && !frame.keys[vk])
+            frame.keys[vk] = isDown(vk);
+    };
+    for (size_t i = 0; i < cfg.num_user_settings && i < cfg.user_load_key.size(); ++i) {
+        if (i < cfg.load_xinput.size() && cfg.load_xinput[i])
+            want_pad = true;
+        else
+            sample(cfg.user_load_key[i]);
+    }
+    if (!cfg.reset_xinput) sample(cfg.pose_reset_key);
+    if (!cfg.ctrl_xinput) sample(cfg.ctrl_toggle_key);
+    sample(VK_CONTROL);
+
+    if (want_pad)
+        frame.pad = GetXInputGamepadState();
+}
+
+
 //-----------------------------------------------------------------------------
 // Purpose: Signify Operation Success
 //-----------------------------------------------------------------------------
@@ -211,6 +495,44 @@ inline std::string WideToUtf8(const wchar_t* wide)
 }
 
 
+//-----------------------------------------------------------------------------
+// Purpose: Convert UTF-8 strings to UTF-16 for the W APIs (GDI+ text)
+//-----------------------------------------------------------------------------
+inline std::wstring Utf8ToWide(const std::string& utf8)
+{
+    if (utf8.empty()) {
+        return {};
+    }
+
+    const int required_size = MultiByteToWideChar(
+        CP_UTF8,
+        0,
+        utf8.c_str(),
+        static_cast<int>(utf8.size()),
+        nullptr,
+        0);
+
+    if (required_size <= 0) {
+        return {};
+    }
+
+    std::wstring wide(static_cast<size_t>(required_size), L'\0');
+    const int converted = MultiByteToWideChar(
+        CP_UTF8,
+        0,
+        utf8.c_str(),
+        static_cast<int>(utf8.size()),
+        wide.data(),
+        required_size);
+
+    if (converted <= 0) {
+        return {};
+    }
+
+    return wide;
+}
+
+
 //-----------------------------------------------------------------------------
 // Purpose: Retrieve Steam path from registry
 //-----------------------------------------------------------------------------
@@ -474,6 +796,8 @@ inline bool ApplyDisplaySelectionToWindowConfig(StereoDisplayDriverConfiguration
 // Purpose: Check and apply user settings hotkeys. The evaluator itself is
 // platform-neutral (vrto3dlib/hotkey_eval.hpp, shared with linux_helper.hpp);
 // this wrapper only supplies the Win32 key-state query (GetAsyncKeyState).
+// The InputFrame overloads run the compiled hotkey table: after editing any
+// user_* row, ++cfg.user_settings_generation or the edit is not seen.
 //-----------------------------------------------------------------------------
 using vrto3d::DepthConvBackend;
 
@@ -489,6 +813,41 @@ inline std::string ApplyUserSettingsHotkeys(
         [](int vk) { return isDown(vk) != 0; }, maxDelta);
 }
 
+inline std::string ApplyUserSettingsHotkeys(
+    StereoDisplayDriverConfiguration& cfg,
+    const vrto3d::input::InputFrame& frame,
+    const DepthConvBackend& b,
+    float maxDelta = 0.001f)
+{
+    return vrto3d::ApplyUserSettingsHotkeysImpl(cfg, frame, b, maxDelta);
+}
+
+// Concrete backend (getDepth()/setDepth(float)/... members): direct calls.
+template <typename Backend,
+          std::enable_if_t<vrto3d::detail::IsHotkeyBackend<Backend>::value, int> = 0>
+inline std::string ApplyUserSettingsHotkeys(
+    StereoDisplayDriverConfiguration& cfg,
+    bool got_xinput,
+    DWORD xstate,
+    Backend& b,
+    float maxDelta = 0.001f)
+{
+    return vrto3d::ApplyUserSettingsHotkeysImpl(
+        cfg, got_xinput, static_cast<uint32_t>(xstate), b,
+        [](int vk) { return isDown(vk) != 0; }, maxDelta);
+}
+
+template <typename Backend,
+          std::enable_if_t<vrto3d::detail::IsHotkeyBackend<Backend>::value, int> = 0>
+inline std::string ApplyUserSettingsHotkeys(
+    StereoDisplayDriverConfiguration& cfg,
+    const vrto3d::input::InputFrame& frame,
+    Backend& b,
+    float maxDelta = 0.001f)
+{
+    return vrto3d::ApplyUserSettingsHotkeysImpl(cfg, frame, b, maxDelta);
+}
+
 
 
  //-----------------------------------------------------------------------------
@@ -551,9 +910,9 @@ inline std::string GetProcessName(uint32_t processID)
 
 
 //-----------------------------------------------------------------------------
-// Purpose: Return window handle from process ID
+// Purpose: First visible top-level window of a process: one EnumWindows pass
 //-----------------------------------------------------------------------------
-inline HWND GetHWNDFromPID(DWORD targetPID) {
+inline HWND EnumHWNDFromPID(DWORD targetPID) {
     struct FindWindowData {
         DWORD targetPID;
         HWND result;
@@ -575,6 +934,171 @@ inline HWND GetHWNDFromPID(DWORD targetPID) {
 }
 
 
+//-----------------------------------------------------------------------------
+// Purpose: Per-PID cache of EnumHWNDFromPID() results, misses included. A
+//          WinEvent hook thread (out of context, own message loop) drops a
+//          pid's entry when one of its windows is created, shown, hidden, or
+//          brought to the foreground, and any entry holding a window that is
+//          destroyed. A hit is still checked with IsWindow + pid + visibility,
+//          so the steady state costs O(1) instead of a walk over every
+//          top-level window.
+//
+//          If the hooks can't be installed every call enumerates, as before.
+//          Started lazily by the first lookup. Call StopWindowPidCache() from
+//          driver shutdown: joining from a static destructor would run under
+//          the loader lock.
+//-----------------------------------------------------------------------------
+class WindowPidCache {
+public:
+    ~WindowPidCache()
+    {
+        // Last resort only; see StopWindowPidCache().
+        if (m_thread.joinable()) m_thread.detach();
+    }
+
+    HWND Find(DWORD pid)
+    {
+        EnsureStarted();
+        if (!m_hooked.load(std::memory_order_acquire)) return EnumHWNDFromPID(pid);
+
+        uint64_t generation = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_windows.find(pid);
+            if (it != m_windows.end()) {
+                HWND hwnd = it->second;
+                if (!hwnd) return nullptr;  // a miss no window event has disturbed
+                DWORD owner = 0;
+                if (IsWindow(hwnd) && GetWindowThreadProcessId(hwnd, &owner) && owner == pid &&
+                    IsWindowVisible(hwnd)) {
+                    return hwnd;
+                }
+                m_windows.erase(it);
+            }
+            generation = m_generation;
+        }
+
+        HWND hwnd = EnumHWNDFromPID(pid);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_generation == generation) {  // no event raced the walk
+            m_windows[pid] = hwnd;
+        }
+        return hwnd;
+    }
+
+    void Stop()
+    {
+        std::lock_guard<std::mutex> lock(m_lifecycle);
+        if (!m_thread.joinable()) return;
+        m_started.store(false, std::memory_order_release);  // a later lookup restarts it
+        PostThreadMessageW(m_thread_id, WM_QUIT, 0, 0);
+        m_thread.join();
+        m_thread_id = 0;
+    }
+
+private:
+    void EnsureStarted()
+    {
+        if (m_started.load(std::memory_order_acquire)) return;
+        std::lock_guard<std::mutex> lock(m_lifecycle);
+        if (m_thread.joinable()) return;
+        std::promise<DWORD> ready;
+        std::future<DWORD> thread_id = ready.get_future();
+        m_thread = std::thread([this, p = std::move(ready)]() mutable { Run(p); });
+        m_thread_id = thread_id.get();
+        m_started.store(true, std::memory_order_release);
+    }
+
+    void Invalidate(HWND hwnd, bool destroyed)
+    {
+        // A destroyed window no longer maps to its pid; drop whichever entry
+        // cached it (a destruction can't turn a cached miss into a hit).
+        DWORD pid = 0;
+        if (!destroyed) GetWindowThreadProcessId(hwnd, &pid);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (destroyed) {
+            for (auto it = m_windows.begin(); it != m_windows.end();) {
+                if (it->second == hwnd) it = m_windows.erase(it);
+                else ++it;
+            }
+        } else if (pid != 0) {
+            m_windows.erase(pid);
+        } else {
+            m_windows.clear();
+        }
+        ++m_generation;
+    }
+
+    static void CALLBACK OnWinEvent(HWINEVENTHOOK, DWORD event, HWND hwnd, LONG idObject,
+                                    LONG idChild, DWORD, DWORD);
+
+    void Run(std::promise<DWORD>& ready)
+    {
+        MSG msg;
+        PeekMessageW(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);  // create the queue
+        const DWORD flags = WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS;
+        HWINEVENTHOOK objects = SetWinEventHook(EVENT_OBJECT_CREATE, EVENT_OBJECT_HIDE, nullptr,
+                                                &WindowPidCache::OnWinEvent, 0, 0, flags);
+        HWINEVENTHOOK foreground = SetWinEventHook(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND,
+                                                   nullptr, &WindowPidCache::OnWinEvent, 0, 0, flags);
+        if (!objects || !foreground) {
+            LOG() << "WindowPidCache: SetWinEventHook failed (err=" << GetLastError()
+                  << "); GetHWNDFromPID will enumerate every call";
+        } else {
+            m_hooked.store(true, std::memory_order_release);
+        }
+        ready.set_value(GetCurrentThreadId());
+
+        while (GetMessageW(&msg, nullptr, 0, 0) > 0) {
+            TranslateMessage(&msg);
+            DispatchMessageW(&msg);
+        }
+
+        m_hooked.store(false, std::memory_order_release);
+        if (objects) UnhookWinEvent(objects);
+        if (foreground) UnhookWinEvent(foreground);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_windows.clear();
+    }
+
+    std::mutex m_lifecycle;
+    std::thread m_thread;
+    DWORD m_thread_id = 0;
+    std::atomic<bool> m_started{false};
+    std::atomic<bool> m_hooked{false};
+
+    std::mutex m_mutex;
+    std::unordered_map<DWORD, HWND> m_windows;  // nullptr = known to have no window
+    uint64_t m_generation = 0;                  // bumped by every invalidation
+};
+
+inline WindowPidCache& GetWindowPidCache()
+{
+    static WindowPidCache cache;
+    return cache;
+}
+
+inline void CALLBACK WindowPidCache::OnWinEvent(HWINEVENTHOOK, DWORD event, HWND hwnd, LONG idObject,
+                                                LONG idChild, DWORD, DWORD)
+{
+    if (idObject != OBJID_WINDOW || idChild != CHILDID_SELF || !hwnd) return;
+    GetWindowPidCache().Invalidate(hwnd, event == EVENT_OBJECT_DESTROY);
+}
+
+inline void StopWindowPidCache()
+{
+    GetWindowPidCache().Stop();
+}
+
+
+//-----------------------------------------------------------------------------
+// Purpose: Return window handle from process ID (cached; see WindowPidCache)
+//-----------------------------------------------------------------------------
+inline HWND GetHWNDFromPID(DWORD targetPID) {
+    return GetWindowPidCache().Find(targetPID);
+}
+
+
 //-----------------------------------------------------------------------------
 // Purpose: Check if a game is still running
 //-----------------------------------------------------------------------------
@@ -595,31 +1119,111 @@ inline bool IsProcessRunning(DWORD pid) {
 
 
 //-----------------------------------------------------------------------------
-// Purpose: Check whether any process with the given exe name is running.
-// `name` is matched case-insensitively against the exe filename only.
+// Purpose: One Toolhelp32 snapshot: every pid with its exe filename, so
+// several name queries pay for one process walk. Names are matched
+// case-insensitively against the exe filename only.
 //-----------------------------------------------------------------------------
-inline bool IsProcessNameRunning(const char* name) {
+struct ProcessSnapshot {
+    std::vector<std::pair<DWORD, std::string>> procs;
+
+    bool Has(const char* name) const {
+        for (const auto& p : procs) {
+            if (_stricmp(p.second.c_str(), name) == 0) return true;
+        }
+        return false;
+    }
+
+    bool HasPid(DWORD pid) const {
+        for (const auto& p : procs) {
+            if (p.first == pid) return true;
+        }
+        return false;
+    }
+
+    std::vector<DWORD> PidsNamed(const char* name) const {
+        std::vector<DWORD> pids;
+        for (const auto& p : procs) {
+            if (_stricmp(p.second.c_str(), name) == 0) pids.push_back(p.first);
+        }
+        return pids;
+    }
+};
+
+inline ProcessSnapshot SnapshotProcesses() {
+    ProcessSnapshot result;
     HANDLE snap = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
-    if (snap == INVALID_HANDLE_VALUE) return false;
+    if (snap == INVALID_HANDLE_VALUE) return result;
 
     // Use the W variants unconditionally — modern SDKs only declare the A
     // variants when UNICODE is undefined, but the W ones always exist.
     PROCESSENTRY32W entry{};
     entry.dwSize = sizeof(entry);
-    bool found = false;
     if (Process32FirstW(snap, &entry)) {
         do {
             char exe[MAX_PATH] = {};
             WideCharToMultiByte(CP_ACP, 0, entry.szExeFile, -1,
                                 exe, MAX_PATH, nullptr, nullptr);
-            if (_stricmp(exe, name) == 0) {
-                found = true;
-                break;
-            }
+            result.procs.emplace_back(entry.th32ProcessID, exe);
         } while (Process32NextW(snap, &entry));
     }
     CloseHandle(snap);
-    return found;
+    return result;
+}
+
+
+//-----------------------------------------------------------------------------
+// Purpose: Check whether any process with the given exe name is running.
+//-----------------------------------------------------------------------------
+inline bool IsProcessNameRunning(const char* name) {
+    return SnapshotProcesses().Has(name);
+}
+
+
+//-----------------------------------------------------------------------------
+// Purpose: Block until every pid has exited or `timeout_ms` passes; true if
+// all exited. One WaitForMultipleObjects on the process handles — no
+// polling. A pid OpenProcess rejects as invalid is already gone; one it
+// won't open for other reasons (ERROR_ACCESS_DENIED: elevated, protected)
+// is still running and is probed against a process snapshot every 50ms,
+// as Linux does without pidfds.
+//-----------------------------------------------------------------------------
+inline bool WaitForProcessesExit(const std::vector<DWORD>& pids, DWORD timeout_ms) {
+    std::vector<HANDLE> handles;
+    std::vector<DWORD> probed;
+    for (DWORD pid : pids) {
+        if (HANDLE h = OpenProcess(SYNCHRONIZE, FALSE, pid)) handles.push_back(h);
+        else if (GetLastError() != ERROR_INVALID_PARAMETER) probed.push_back(pid);
+    }
+    bool all_exited = true;
+    const ULONGLONG deadline = GetTickCount64() + timeout_ms;
+    auto left = [deadline]() -> DWORD {
+        const ULONGLONG now = GetTickCount64();
+        return now >= deadline ? 0 : static_cast<DWORD>(deadline - now);
+    };
+    for (size_t i = 0; i < handles.size(); i += MAXIMUM_WAIT_OBJECTS) {
+        const DWORD n = static_cast<DWORD>((std::min)(handles.size() - i, size_t(MAXIMUM_WAIT_OBJECTS)));
+        const DWORD r = WaitForMultipleObjects(n, handles.data() + i, TRUE, left());
+        if (r >= WAIT_OBJECT_0 + n) {
+            all_exited = false;
+            break;
+        }
+    }
+    for (HANDLE h : handles) CloseHandle(h);
+
+    while (all_exited && !probed.empty()) {
+        const ProcessSnapshot snap = SnapshotProcesses();
+        probed.erase(std::remove_if(probed.begin(), probed.end(), [&snap](DWORD pid) {
+            return !snap.HasPid(pid);
+        }), probed.end());
+        if (probed.empty()) break;
+        const DWORD wait_ms = left();
+        if (wait_ms == 0) {
+            all_exited = false;
+            break;
+        }
+        Sleep((std::min)(wait_ms, DWORD(50)));
+    }
+    return all_exited;
 }
 
 
@@ -657,21 +1261,18 @@ inline void RequestSteamVRShutdown(int graceful_timeout_seconds = 5) {
         LOG() << "auto_exit: " << tag.c_str() << " exit=" << exit_code;
     };
 
-    const int poll_ms = 500;
-
     auto kill_named = [&](const char* image_name) {
+        // Take the pids before asking; the wait is then on their handles.
+        const std::vector<DWORD> pids = SnapshotProcesses().PidsNamed(image_name);
+        const ULONGLONG start = GetTickCount64();
         std::string graceful = std::string("taskkill /IM ") + image_name;
         std::string graceful_tag = std::string("taskkill ") + image_name;
         run(graceful, graceful_tag);
 
-        const int max_polls = (graceful_timeout_seconds * 1000) / poll_ms;
-        for (int i = 0; i < max_polls; ++i) {
-            if (!IsProcessNameRunning(image_name)) {
-                LOG() << "auto_exit: " << image_name
-                      << " exited cleanly after " << (i * poll_ms) << "ms";
-                return;
-            }
-            Sleep(poll_ms);
+        if (WaitForProcessesExit(pids, static_cast<DWORD>(graceful_timeout_seconds) * 1000)) {
+            LOG() << "auto_exit: " << image_name
+                  << " exited cleanly after " << (GetTickCount64() - start) << "ms";
+            return;
         }
 
         LOG() << "auto_exit: " << image_name << " still running after "
@@ -698,7 +1299,7 @@ inline void RequestSteamVRShutdown(int graceful_timeout_seconds = 5) {
 // Published by device_provider on ProcessConnected/Disconnected so any other
 // TU (present-window WndProc, WibbleWobble subclass) can ask the currently
 // attached app to close before triggering a SteamVR shutdown. 0 = nothing
-// connected.
+// connected. ProcessWatch (process_watch.h) pushes its exit.
 //-----------------------------------------------------------------------------
 inline std::atomic<uint32_t> g_current_app_pid{0};
 
@@ -731,16 +1332,13 @@ inline void RequestSteamVRShutdownWithApp(
               << ", skipping graceful WM_CLOSE";
     }
 
-    const int poll_ms = 500;
-    const int max_polls = (app_close_timeout_seconds * 1000) / poll_ms;
-    for (int i = 0; i < max_polls; ++i) {
-        if (!IsProcessRunning(pid)) {
-            LOG() << "auto_exit: pid " << pid << " exited after "
-                  << (i * poll_ms) << "ms, shutting down SteamVR";
-            RequestSteamVRShutdown();
-            return;
-        }
-        Sleep(poll_ms);
+    const ULONGLONG start = GetTickCount64();
+    if (WaitForProcessesExit({static_cast<DWORD>(pid)},
+                             static_cast<DWORD>(app_close_timeout_seconds) * 1000)) {
+        LOG() << "auto_exit: pid " << pid << " exited after "
+              << (GetTickCount64() - start) << "ms, shutting down SteamVR";
+        RequestSteamVRShutdown();
+        return;
     }
 
     // Game refused to close (declined a Save prompt, hung, etc.) — force
@@ -16,8 +16,9 @@
  */
 
 #define WIN32_LEAN_AND_MEAN
-#include <fstream>
-#include <regex>
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
 
 #include "vrto3dlib/app_id_mgr.h"
 #include "vrto3dlib/debug_log.hpp"
@@ -26,6 +27,10 @@
 #include "vrto3dlib/win32_helper.hpp"
 #else
 #include "vrto3dlib/linux_helper.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 
 AppIdMgr::AppIdMgr() {
@@ -33,6 +38,146 @@ AppIdMgr::AppIdMgr() {
 }
 
 
+namespace {
+
+constexpr size_t kLogChunk = 64 * 1024;
+
+// Key from the text after "SetApplicationPid", matching what
+// SetApplicationPid.*appkey=(.*?)\s+pid= used to capture: the greedy .*
+// means the last "appkey=" that is followed, after a whitespace run, by
+// "pid="; the key runs up to the first such run.
+bool ParseAppKey(std::string_view line, std::string& key)
+{
+    static constexpr std::string_view kAppKey = "appkey=";
+    static constexpr std::string_view kPid = "pid=";
+    auto isSpace = [](char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v'; };
+    for (size_t at = line.rfind(kAppKey); at != std::string_view::npos;
+         at = at == 0 ? std::string_view::npos : line.rfind(kAppKey, at - 1)) {
+        const size_t begin = at + kAppKey.size();
+        for (size_t p = line.find(kPid, begin); p != std::string_view::npos; p = line.find(kPid, p + 1)) {
+            size_t end = p;
+            while (end > begin && isSpace(line[end - 1])) --end;
+            if (end == p) continue;  // no whitespace before this "pid="
+            key.assign(line.data() + begin, end - begin);
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+
+//-----------------------------------------------------------------------------
+// Purpose: Find app keys in whole lines [begin, end). Scans for the marker
+//          over the block, not line by line; only hits are parsed.
+//-----------------------------------------------------------------------------
+void AppIdMgr::ScanLogText(const char* begin, const char* end)
+{
+    static constexpr std::string_view kMarker = "SetApplicationPid";
+    const std::string_view text(begin, static_cast<size_t>(end - begin));
+    std::string key;
+    for (size_t pos = text.find(kMarker); pos != std::string_view::npos; ) {
+        size_t eol = text.find('\n', pos);
+        if (eol == std::string_view::npos) eol = text.size();
+        const std::string_view rest = text.substr(pos + kMarker.size(), eol - pos - kMarker.size());
+        if (ParseAppKey(rest, key) && excluded_app_keys_.find(key) == excluded_app_keys_.end()) {
+            app_keys_.push_back(key);
+        }
+        pos = text.find(kMarker, eol);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Purpose: Consume whatever vrserver.txt gained since the last call. A new
+//          file identity (rotation) or a file shorter than our offset
+//          (truncation) restarts from byte 0 with no keys.
+//-----------------------------------------------------------------------------
+bool AppIdMgr::ReadLogTail()
+{
+    const std::string logFilePath = steam_path_ + "/logs/vrserver.txt";
+    LogIdentity id;
+    uint64_t size = 0;
+#ifdef _WIN32
+    HANDLE h = CreateFileA(logFilePath.c_str(), GENERIC_READ,
+                           FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (h == INVALID_HANDLE_VALUE) {
+        LOG() << "Failed to open log file: " << logFilePath;
+        return false;
+    }
+    BY_HANDLE_FILE_INFORMATION info{};
+    if (GetFileInformationByHandle(h, &info)) {
+        id.volume = info.dwVolumeSerialNumber;
+        id.file = (static_cast<uint64_t>(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+        size = (static_cast<uint64_t>(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+    }
+#else
+    const int fd = open(logFilePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOG() << "Failed to open log file: " << logFilePath;
+        return false;
+    }
+    struct stat st{};
+    if (fstat(fd, &st) == 0) {
+        id.volume = static_cast<uint64_t>(st.st_dev);
+        id.file = static_cast<uint64_t>(st.st_ino);
+        size = static_cast<uint64_t>(st.st_size);
+    }
+#endif
+
+    if (id != log_id_ || size < log_offset_) {
+        if (log_offset_ != 0) {
+            LOG() << "vrserver.txt was rotated or truncated; rescanning";
+        }
+        log_id_ = id;
+        log_offset_ = 0;
+        log_partial_.clear();
+        app_keys_.clear();
+        keys_reported_ = 0;
+    }
+
+    std::string buf;
+    while (log_offset_ < size) {
+        const size_t want = static_cast<size_t>((std::min<uint64_t>)(kLogChunk, size - log_offset_));
+        buf.assign(log_partial_);
+        const size_t carried = buf.size();
+        buf.resize(carried + want);
+        size_t got = 0;
+#ifdef _WIN32
+        OVERLAPPED ov{};
+        ov.Offset = static_cast<DWORD>(log_offset_);
+        ov.OffsetHigh = static_cast<DWORD>(log_offset_ >> 32);
+        DWORD n = 0;
+        if (ReadFile(h, &buf[carried], static_cast<DWORD>(want), &n, &ov)) got = n;
+#else
+        const ssize_t n = pread(fd, &buf[carried], want, static_cast<off_t>(log_offset_));
+        if (n > 0) got = static_cast<size_t>(n);
+#endif
+        if (got == 0) break;
+        buf.resize(carried + got);
+        log_offset_ += got;
+
+        // Scan complete lines; the tail waits for its newline.
+        const size_t last_nl = buf.rfind('\n');
+        if (last_nl == std::string::npos) {
+            log_partial_ = std::move(buf);
+            continue;
+        }
+        ScanLogText(buf.data(), buf.data() + last_nl + 1);
+        log_partial_.assign(buf, last_nl + 1, std::string::npos);
+    }
+
+#ifdef _WIN32
+    CloseHandle(h);
+#else
+    close(fd);
+#endif
+    return true;
+}
+
+
 //-----------------------------------------------------------------------------
 // Purpose: Parse Game's App ID from VRServer Log
 //-----------------------------------------------------------------------------
@@ -41,28 +186,27 @@ std::vector<std::string> AppIdMgr::GetSteamAppIDs() {
         LOG() << "Steam install path is empty. Cannot read logs.";
         return {};
     }
-
-    std::string logFilePath = steam_path_ + "/logs/vrserver.txt";
-    std::ifstream logFile(logFilePath);
-    if (!logFile) {
-        LOG() << "Failed to open log file: " << logFilePath;
+    if (!ReadLogTail()) {
         return {};
     }
+    keys_reported_ = app_keys_.size();
+    return app_keys_;
+}
 
-    std::regex appkeyRegex(R"(SetApplicationPid.*appkey=(.*?)\s+pid=)");
-    std::smatch match;
-    std::string line;
-    std::vector<std::string> appKeys;
-
-    while (std::getline(logFile, line)) {
-        if (std::regex_search(line, match, appkeyRegex) && match.size() > 1) {
-            std::string key = match[1].str();
-            if (excluded_app_keys_.find(key) == excluded_app_keys_.end()) {
-                appKeys.push_back(key);
-            }
-        }
-    }
 
-    logFile.close();
-    return appKeys;
+//-----------------------------------------------------------------------------
+// Purpose: App IDs logged since the last query
+//-----------------------------------------------------------------------------
+std::vector<std::string> AppIdMgr::GetNewSteamAppIDs() {
+    if (steam_path_.empty()) {
+        LOG() << "Steam install path is empty. Cannot read logs.";
+        return {};
+    }
+    if (!ReadLogTail()) {
+        return {};
+    }
+    std::vector<std::string> fresh(app_keys_.begin() + static_cast<std::ptrdiff_t>(keys_reported_),
+                                   app_keys_.end());
+    keys_reported_ = app_keys_.size();
+    return fresh;
 }
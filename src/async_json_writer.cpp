@@ -0,0 +1,166 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "vrto3dlib/async_json_writer.h"
+#include "vrto3dlib/debug_log.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+
+AsyncJsonWriter::AsyncJsonWriter(std::chrono::milliseconds debounce)
+    : debounce_(debounce)
+{
+}
+
+
+AsyncJsonWriter::~AsyncJsonWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Purpose: Queue `json` for `path`, replacing any save of it still pending
+//-----------------------------------------------------------------------------
+std::shared_future<bool> AsyncJsonWriter::Write(const std::string& path, nlohmann::ordered_json json)
+{
+    std::shared_future<bool> future;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = pending_.find(path);
+        if (it != pending_.end()) {
+            it->second.json = std::move(json);
+            return it->second.future;
+        }
+        Pending p;
+        p.json = std::move(json);
+        p.due = std::chrono::steady_clock::now() + debounce_;
+        p.done = std::make_shared<std::promise<bool>>();
+        p.future = p.done->get_future().share();
+        future = p.future;
+        pending_.emplace(path, std::move(p));
+        if (!worker_.joinable()) {
+            worker_ = std::thread(&AsyncJsonWriter::Run, this);
+        }
+    }
+    cv_.notify_all();
+    return future;
+}
+
+
+//-----------------------------------------------------------------------------
+// Purpose: Pull `path` forward to now and block until its write completes
+//-----------------------------------------------------------------------------
+bool AsyncJsonWriter::Flush(const std::string& path)
+{
+    std::shared_future<bool> future;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = pending_.find(path);
+        if (it != pending_.end()) {
+            it->second.due = std::chrono::steady_clock::time_point::min();
+            future = it->second.future;
+        } else if (in_flight_path_ == path && in_flight_.valid()) {
+            future = in_flight_;
+        } else {
+            return true;
+        }
+    }
+    cv_.notify_all();
+    return future.get();
+}
+
+
+bool AsyncJsonWriter::WriteFileAtomic(const std::string& path, const std::string& text)
+{
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::trunc);
+        if (!file.is_open()) return false;
+        file << text;
+        file.flush();
+        if (!file) {
+            file.close();
+            std::error_code ec;
+            std::filesystem::remove(tmp, ec);
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// Purpose: Worker: write the earliest-due path once its window has passed
+//          (immediately once stopping), one file at a time
+//-----------------------------------------------------------------------------
+void AsyncJsonWriter::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        if (pending_.empty()) {
+            if (stop_) break;
+            cv_.wait(lock);
+            continue;
+        }
+        auto next = pending_.begin();
+        for (auto it = pending_.begin(); it != pending_.end(); ++it) {
+            if (it->second.due < next->second.due) next = it;
+        }
+        if (!stop_ && next->second.due > std::chrono::steady_clock::now()) {
+            cv_.wait_until(lock, next->second.due);
+            continue;
+        }
+
+        const std::string path = next->first;
+        Pending job = std::move(next->second);
+        pending_.erase(next);
+        in_flight_path_ = path;
+        in_flight_ = job.future;
+        lock.unlock();
+
+        bool ok = false;
+        try {
+            ok = WriteFileAtomic(path, job.json.dump(4)); // Pretty-print with an indent of 4 spaces
+        } catch (const nlohmann::json::exception& e) {
+            LOG() << "Failed to serialize " << path << ": " << e.what();
+        }
+        const std::string name = std::filesystem::path(path).filename().string();
+        if (ok) LOG() << "Saved profile: " << name;
+        else    LOG() << "Failed to save profile: " << name;
+        job.done->set_value(ok);
+
+        lock.lock();
+        in_flight_path_.clear();
+        in_flight_ = {};
+    }
+}
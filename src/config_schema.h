@@ -0,0 +1,253 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+// Internal to json_manager.cpp: the one table of top-level config keys. Each
+// row names the JSON key, the StereoDisplayDriverConfiguration member it
+// maps to, its type and default, and which loaders/savers use it. The
+// in-memory default_config_, both loaders, both savers, and the binary
+// profile cache (profile_cache.h) are all driven from it; row order is the
+// canonical key order of default_config.json.
+//
+// user_settings[] is nested and per-row, so it is handled separately.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "vrto3dlib/stereo_config.h"
+
+namespace vrto3d::config_schema {
+
+using Cfg = StereoDisplayDriverConfiguration;
+
+enum class FieldType : uint8_t {
+    Bool,
+    Int,
+    Float,
+    String,
+    StringList,
+    Float3,       // RGB triplet, JSON array of 3 numbers
+    OutputMode,   // enum stored by name (OutputModeFromString / ToString)
+    KeyBind,      // bind name string, parsed into a code + pad flag
+    KeyBindType,  // "toggle"/"hold"/"switch" string plus its numeric form
+};
+
+enum FieldScope : uint8_t {
+    kGlobal          = 1 << 0,  // read by LoadParamsFromJson
+    kProfile         = 1 << 1,  // read by LoadProfileFromJson; default if missing
+    kProfileOptional = 1 << 2,  // read by LoadProfileFromJson; kept if missing
+    kNoProfileSave   = 1 << 3,  // not written by SaveProfileToJson
+};
+
+struct StringListDefault {
+    const char* const* items;
+    size_t count;
+};
+
+struct FieldDesc {
+    union Member {
+        bool Cfg::* b;
+        int32_t Cfg::* i;
+        float Cfg::* f;
+        std::string Cfg::* s;
+        std::vector<std::string> Cfg::* sl;
+        float (Cfg::* f3)[3];
+        OutputMode Cfg::* mode;
+
+        constexpr Member(bool Cfg::* p) : b(p) {}
+        constexpr Member(int32_t Cfg::* p) : i(p) {}
+        constexpr Member(float Cfg::* p) : f(p) {}
+        constexpr Member(std::string Cfg::* p) : s(p) {}
+        constexpr Member(std::vector<std::string> Cfg::* p) : sl(p) {}
+        constexpr Member(float (Cfg::* p)[3]) : f3(p) {}
+        constexpr Member(OutputMode Cfg::* p) : mode(p) {}
+    };
+    union Default {
+        bool b;
+        int32_t i;
+        double f;        // Float, Float3 (all three components)
+        const char* s;   // String, OutputMode, KeyBind, KeyBindType
+        StringListDefault sl;
+
+        constexpr Default(bool v) : b(v) {}
+        constexpr Default(int32_t v) : i(v) {}
+        constexpr Default(double v) : f(v) {}
+        constexpr Default(const char* v) : s(v) {}
+        constexpr Default(StringListDefault v) : sl(v) {}
+    };
+
+    const char* key;
+    FieldType type;
+    uint8_t scope;
+    Member member;
+    Default def;
+    int32_t Cfg::* code = nullptr;  // KeyBind / KeyBindType: parsed value
+    bool Cfg::* xinput = nullptr;   // KeyBind: bind is a pad button mask
+};
+
+constexpr FieldDesc Bool(const char* k, uint8_t sc, bool Cfg::* m, bool d)
+{
+    return {k, FieldType::Bool, sc, m, d};
+}
+constexpr FieldDesc Int(const char* k, uint8_t sc, int32_t Cfg::* m, int32_t d)
+{
+    return {k, FieldType::Int, sc, m, d};
+}
+constexpr FieldDesc Float(const char* k, uint8_t sc, float Cfg::* m, double d)
+{
+    return {k, FieldType::Float, sc, m, d};
+}
+constexpr FieldDesc String(const char* k, uint8_t sc, std::string Cfg::* m, const char* d)
+{
+    return {k, FieldType::String, sc, m, d};
+}
+constexpr FieldDesc StringList(const char* k, uint8_t sc, std::vector<std::string> Cfg::* m,
+                               StringListDefault d)
+{
+    return {k, FieldType::StringList, sc, m, d};
+}
+constexpr FieldDesc Float3(const char* k, uint8_t sc, float (Cfg::* m)[3], double d)
+{
+    return {k, FieldType::Float3, sc, m, d};
+}
+constexpr FieldDesc Mode(const char* k, uint8_t sc, OutputMode Cfg::* m, const char* d)
+{
+    return {k, FieldType::OutputMode, sc, m, d};
+}
+constexpr FieldDesc Bind(const char* k, uint8_t sc, std::string Cfg::* name,
+                         int32_t Cfg::* code, bool Cfg::* xinput, const char* d)
+{
+    return {k, FieldType::KeyBind, sc, name, d, code, xinput};
+}
+constexpr FieldDesc BindType(const char* k, uint8_t sc, std::string Cfg::* name,
+                             int32_t Cfg::* code, const char* d)
+{
+    return {k, FieldType::KeyBindType, sc, name, d, code};
+}
+
+inline constexpr const char* kNoClasses[] = {nullptr};
+inline constexpr const char* kDefaultDenyClasses[] = {"touchpad", "sensor"};
+
+// Global keys also listed kProfileOptional may be overridden per game.
+inline constexpr FieldDesc kFields[] = {
+    Int("display_index", kGlobal, &Cfg::display_index, 0),
+    Mode("output_mode", kGlobal, &Cfg::output_mode, "SbS"),
+    Bool("eye_swap", kGlobal, &Cfg::eye_swap, false),
+    Int("render_width", kGlobal, &Cfg::render_width, 1920),
+    Int("render_height", kGlobal, &Cfg::render_height, 1080),
+    Float("display_frequency", kGlobal, &Cfg::display_frequency, 0.0),
+    Float("hmd_height", kProfile, &Cfg::hmd_height, 1.0),
+    Float("hmd_x", kGlobal, &Cfg::hmd_x, 0.0),
+    Float("hmd_y", kGlobal, &Cfg::hmd_y, 0.0),
+    Float("hmd_yaw", kGlobal, &Cfg::hmd_yaw, 0.0),
+    Float("aspect_ratio", kProfile | kNoProfileSave, &Cfg::aspect_ratio, 1.77778),
+    Float("fov", kProfile, &Cfg::fov, 90.0),
+    Float("depth", kProfile, &Cfg::depth, 0.1),
+    Float("convergence", kProfile, &Cfg::convergence, 1.0),
+    Bool("async_enable", kGlobal | kProfileOptional, &Cfg::async_enable, false),
+    Bool("disable_hotkeys", kGlobal, &Cfg::disable_hotkeys, false),
+    Bool("auto_depth_enabled", kProfileOptional, &Cfg::auto_depth_enabled, false),
+    Float("auto_depth_target_disparity", kProfileOptional, &Cfg::auto_depth_target_disparity, 0.005),
+    Float("auto_depth_smoothing", kProfileOptional, &Cfg::auto_depth_smoothing, 0.08),
+    Bool("dash_enable", kGlobal, &Cfg::dash_enable, false),
+    Bool("auto_focus", kGlobal, &Cfg::auto_focus, true),
+    Bool("auto_exit", kGlobal, &Cfg::auto_exit, false),
+    Bool("hide_cursor", kGlobal | kProfileOptional, &Cfg::hide_cursor, false),
+    Bool("lock_cursor", kGlobal | kProfileOptional, &Cfg::lock_cursor, false),
+    Bool("stereo_cursor", kGlobal | kProfileOptional, &Cfg::stereo_cursor, false),
+    Float("cursor_depth", kGlobal | kProfileOptional, &Cfg::cursor_depth, 0.0),
+    Int("cursor_size", kGlobal | kProfileOptional, &Cfg::cursor_size, 32),
+    Bool("input_coalesce_motion", kGlobal, &Cfg::input_coalesce_motion, true),
+    Int("input_max_rate_hz", kGlobal, &Cfg::input_max_rate_hz, 0),
+    StringList("input_allow_classes", kGlobal, &Cfg::input_allow_classes, {kNoClasses, 0}),
+    StringList("input_deny_classes", kGlobal, &Cfg::input_deny_classes, {kDefaultDenyClasses, 2}),
+    Bool("pitch_enable", kProfile, &Cfg::pitch_enable, false),
+    Bool("yaw_enable", kProfile, &Cfg::yaw_enable, false),
+    Bool("use_open_track", kGlobal, &Cfg::use_open_track, false),
+    Int("open_track_port", kGlobal, &Cfg::open_track_port, 4242),
+    Bool("use_track_filter", kGlobal, &Cfg::use_track_filter, false),
+    Float("trk_flt_rot_sens", kGlobal, &Cfg::trk_flt_rot_sens, 0.5),
+    Float("trk_flt_pos_sens", kGlobal, &Cfg::trk_flt_pos_sens, 0.25),
+    Float("trk_flt_rot_dz", kGlobal, &Cfg::trk_flt_rot_dz, 0.03),
+    Float("trk_flt_pos_dz", kGlobal, &Cfg::trk_flt_pos_dz, 0.02),
+    Float("trk_flt_zoom_smooth", kGlobal, &Cfg::trk_flt_zoom_smooth, 0.0),
+    Float("trk_flt_max_zoom", kGlobal, &Cfg::trk_flt_max_zoom, 10.0),
+    Bool("sr_tracking_enabled", kGlobal, &Cfg::sr_tracking_enabled, true),
+    Float("sr_filter_pos_mincutoff", kGlobal, &Cfg::sr_filter_pos_mincutoff, 0.08),
+    Float("sr_filter_pos_beta", kGlobal, &Cfg::sr_filter_pos_beta, 0.08),
+    Float("sr_filter_rot_mincutoff", kGlobal, &Cfg::sr_filter_rot_mincutoff, 0.12),
+    Float("sr_filter_rot_beta", kGlobal, &Cfg::sr_filter_rot_beta, 0.01),
+    Float("sr_angle_deadzone_deg", kGlobal, &Cfg::sr_angle_deadzone_deg, 0.2),
+    Float("sr_sens_yaw", kGlobal, &Cfg::sr_sens_yaw, 1.0),
+    Float("sr_sens_pitch", kGlobal, &Cfg::sr_sens_pitch, 1.0),
+    Float("sr_sens_roll", kGlobal, &Cfg::sr_sens_roll, 1.0),
+    Float("sr_max_yaw", kGlobal, &Cfg::sr_max_yaw, 70.0),
+    Float("sr_max_pitch", kGlobal, &Cfg::sr_max_pitch, 70.0),
+    Float("sr_max_roll", kGlobal, &Cfg::sr_max_roll, 70.0),
+    String("sr_track_mode", kGlobal, &Cfg::sr_track_mode, "XYZ_YawPitch"),
+    String("launch_script", kGlobal, &Cfg::launch_script, ""),
+    Bind("pose_reset_key", kProfile, &Cfg::pose_reset_str, &Cfg::pose_reset_key, &Cfg::reset_xinput, "Numpad7"),
+    Bind("ctrl_toggle_key", kProfile, &Cfg::ctrl_toggle_str, &Cfg::ctrl_toggle_key, &Cfg::ctrl_xinput, "Numpad8"),
+    BindType("ctrl_toggle_type", kProfile, &Cfg::ctrl_type_str, &Cfg::ctrl_type, "toggle"),
+    Float("pitch_radius", kProfile, &Cfg::pitch_radius, 0.0),
+    Float("ctrl_deadzone", kProfile, &Cfg::ctrl_deadzone, 0.05),
+    Float("ctrl_sensitivity", kProfile, &Cfg::ctrl_sensitivity, 1.0),
+    Bool("shader_enabled", kProfileOptional, &Cfg::shader_enabled, false),
+    Float3("shader_lift", kProfileOptional, &Cfg::shader_lift, 1.0),
+    Float3("shader_gamma", kProfileOptional, &Cfg::shader_gamma, 1.0),
+    Float3("shader_gain", kProfileOptional, &Cfg::shader_gain, 1.0),
+    Float("shader_curve", kProfileOptional, &Cfg::shader_curve, 1.0),
+    Float("shader_curve_offset_low", kProfileOptional, &Cfg::shader_curve_off_low, 0.0),
+    Float("shader_curve_offset_high", kProfileOptional, &Cfg::shader_curve_off_high, 0.0),
+    Float("shader_curve_offset_both", kProfileOptional, &Cfg::shader_curve_off_both, 0.0),
+};
+
+constexpr size_t kFieldCount = sizeof(kFields) / sizeof(kFields[0]);
+
+// Key order of a saved profile, which predates the table: the shader block
+// sits before pitch/ctrl there but after them in default_config_. A profile
+// row missing here is still saved, after these.
+inline constexpr const char* kProfileSaveOrder[] = {
+    "hmd_height", "fov", "depth", "convergence", "async_enable",
+    "auto_depth_enabled", "auto_depth_target_disparity", "auto_depth_smoothing",
+    "hide_cursor", "lock_cursor", "stereo_cursor", "cursor_depth", "cursor_size",
+    "shader_enabled", "shader_lift", "shader_gamma", "shader_gain", "shader_curve",
+    "shader_curve_offset_low", "shader_curve_offset_high", "shader_curve_offset_both",
+    "pitch_enable", "yaw_enable", "pose_reset_key", "ctrl_toggle_key",
+    "ctrl_toggle_type", "pitch_radius", "ctrl_deadzone", "ctrl_sensitivity",
+};
+
+// Index into kFields by key, or kFieldCount if `key` is not a table key.
+inline size_t FindField(std::string_view key)
+{
+    static const std::unordered_map<std::string_view, size_t> index = [] {
+        std::unordered_map<std::string_view, size_t> m;
+        m.reserve(kFieldCount);
+        for (size_t i = 0; i < kFieldCount; ++i) {
+            m.emplace(kFields[i].key, i);
+        }
+        return m;
+    }();
+    const auto it = index.find(key);
+    return it == index.end() ? kFieldCount : it->second;
+}
+
+}  // namespace vrto3d::config_schema
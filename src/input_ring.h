@@ -0,0 +1,223 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+// Internal to the input_state.h backends (linux_input.cpp, win32_input.cpp):
+// the edge-event / typed-text rings and the seqlock that publishes
+// multi-word state to the lock-free getters. Each backend has exactly one
+// writer at a time (its input thread, under the backend's state lock).
+
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "vrto3dlib/input_state.h"
+#include "vrto3dlib/pad_history.h"  // PackPad* / UnpackPad
+
+namespace vrto3d::input::detail {
+
+constexpr size_t kMaxKeyEvents = 256;
+constexpr size_t kMaxTypedBytes = 4096;
+
+//-----------------------------------------------------------------------------
+// Purpose: Fixed-capacity single-producer/single-consumer ring. The producer
+//          is the backend's input thread; the consumer is the OSD input pump.
+//          Neither side locks, and only the consumer moves tail_, so nothing
+//          resets the ring (Stop() included). On overflow the new element is
+//          refused, never an old one.
+//-----------------------------------------------------------------------------
+template <typename T, size_t N>
+class SpscRing {
+    static_assert((N & (N - 1)) == 0, "capacity must be a power of two");
+
+public:
+    // Producer: all-or-nothing push of `count` elements.
+    bool Push(const T* items, size_t count)
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        if (N - (head - tail) < count) {
+            return false;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            buf_[(head + i) & (N - 1)] = items[i];
+        }
+        head_.store(head + count, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: copy up to `max` elements without consuming them.
+    size_t Peek(T* out, size_t max) const
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t head = head_.load(std::memory_order_acquire);
+        const size_t n = (std::min)(head - tail, max);
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = buf_[(tail + i) & (N - 1)];
+        }
+        return n;
+    }
+
+    // Consumer: release `n` elements previously returned by Peek().
+    void Consume(size_t n)
+    {
+        tail_.store(tail_.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    }
+
+    size_t Size() const
+    {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+private:
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+    alignas(64) T buf_[N] = {};
+};
+
+using KeyEventRing = SpscRing<KeyEvent, kMaxKeyEvents>;
+using TypedRing = SpscRing<char, kMaxTypedBytes>;
+
+//-----------------------------------------------------------------------------
+// Purpose: Edge queues plus their drop counters, with the consumer side of
+//          the public DrainKeyEvents / DrainTypedUtf8 / GetInputStats API
+//-----------------------------------------------------------------------------
+struct EdgeQueues {
+    KeyEventRing events;
+    TypedRing typed;
+    std::atomic<uint64_t> events_dropped{0};
+    std::atomic<uint64_t> typed_dropped{0};
+
+    // Producer side.
+    void PushEvent(const KeyEvent& e)
+    {
+        if (!events.Push(&e, 1)) {
+            events_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Whole characters only, so the consumer never sees a split sequence.
+    void PushText(const char* utf8, size_t n)
+    {
+        if (!typed.Push(utf8, n)) {
+            typed_dropped.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+        }
+    }
+
+    int DrainEvents(KeyEvent* out, int max_events)
+    {
+        if (!out || max_events <= 0) {
+            return 0;
+        }
+        const size_t n = events.Peek(out, static_cast<size_t>(max_events));
+        events.Consume(n);
+        return static_cast<int>(n);
+    }
+
+    int DrainText(char* out, int out_size)
+    {
+        if (!out || out_size <= 0) {
+            return 0;
+        }
+        // Peek one byte past the limit to see whether it starts a new character.
+        char peek[kMaxTypedBytes + 1];
+        const size_t limit = (std::min)(static_cast<size_t>(out_size - 1), kMaxTypedBytes);
+        const size_t avail = typed.Peek(peek, limit + 1);
+        size_t n = (std::min)(avail, limit);
+        // Never split a UTF-8 sequence: back up past continuation bytes.
+        while (n > 0 && n < avail &&
+               (static_cast<unsigned char>(peek[n]) & 0xC0) == 0x80) {
+            --n;
+        }
+        std::memcpy(out, peek, n);
+        out[n] = '\0';
+        typed.Consume(n);
+        return static_cast<int>(n);
+    }
+
+    InputStats Stats() const
+    {
+        InputStats stats;
+        stats.key_events_dropped = events_dropped.load(std::memory_order_relaxed);
+        stats.typed_bytes_dropped = typed_dropped.load(std::memory_order_relaxed);
+        return stats;
+    }
+};
+
+//-----------------------------------------------------------------------------
+// Purpose: Single-writer seqlock. Writer critical sections are a handful of
+//          relaxed stores, so readers yield rather than spin on odd.
+//-----------------------------------------------------------------------------
+class SeqLock {
+public:
+    void Begin()
+    {
+        seq_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void End()
+    {
+        seq_.fetch_add(1, std::memory_order_release);
+    }
+
+    template <typename ReadFn>
+    void Read(ReadFn read) const
+    {
+        for (;;) {
+            const uint32_t seq = seq_.load(std::memory_order_acquire);
+            if (seq & 1u) {
+                std::this_thread::yield();
+                continue;
+            }
+            read();
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == seq) {
+                return;
+            }
+        }
+    }
+
+private:
+    std::atomic<uint32_t> seq_{0};
+};
+
+// Expand a VK-indexed 4x64 bitset into InputFrame::keys.
+inline void ExpandVkWords(const uint64_t (&words)[4], std::bitset<256>& keys)
+{
+    keys.reset();
+    for (int w = 0; w < 4; ++w) {
+        for (uint64_t bits = words[w]; bits != 0; bits &= bits - 1) {
+#ifdef _MSC_VER
+            unsigned long bit;
+            _BitScanForward64(&bit, bits);
+#else
+            const int bit = __builtin_ctzll(bits);
+#endif
+            keys.set(w * 64 + static_cast<int>(bit));
+        }
+    }
+}
+
+}  // namespace vrto3d::input::detail
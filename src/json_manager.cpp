@@ -28,12 +28,22 @@
 #include "vrto3dlib/key_codes.h"
 #include "vrto3dlib/linux_helper.hpp"
 #endif
+#include "vrto3dlib/hotkey_eval.hpp"
 #include "vrto3dlib/key_names.h"
+#include "vrto3dlib/trace.hpp"
+#include "config_schema.h"
+#include "key_table.h"
+#include "profile_cache.h"
+#include "profile_index.h"
+#include "profile_watcher.h"
+#include <algorithm>
+#include <bitset>
 #include <fstream>
 #include <filesystem>
 #include <unordered_map>
 #include <iomanip>
 #include <sstream>
+#include <utility>
 
 // Include the nlohmann/json library
 #include <nlohmann/json.hpp>
@@ -160,13 +170,521 @@ static bool ParseBindName(std::string& name, int32_t& code, bool& xinput)
     return false;
 }
 
-JsonManager::JsonManager() {
+//-----------------------------------------------------------------------------
+// Purpose: Size the per-row user_settings vectors for `n` rows and reset the
+//          runtime hotkey state (preset cycle, HOLD/TOGGLE snapshots)
+//-----------------------------------------------------------------------------
+static void ResizeUserRows(StereoDisplayDriverConfiguration& config, size_t n)
+{
+    config.num_user_settings = n;
+    ++config.user_settings_generation;
+    config.user_load_key.resize(n);
+    config.user_key_type.resize(n);
+    config.user_depth.assign(n, std::vector<float>{});
+    config.user_convergence.assign(n, std::vector<float>{});
+    config.user_fov.assign(n, std::vector<float>{});
+    config.user_preset_index.assign(n, 0);
+    config.prev_depth.resize(n);
+    config.prev_convergence.resize(n);
+    config.prev_fov.resize(n);
+    config.was_held.resize(n);
+    config.load_xinput.resize(n);
+    config.sleep_count.resize(n);
+    config.user_load_str.resize(n);
+    config.user_type_str.resize(n);
+}
+
+// Hot-reload: take every per-row user_settings vector from `src`.
+static void CopyUserRows(const StereoDisplayDriverConfiguration& src, StereoDisplayDriverConfiguration& dst)
+{
+    dst.num_user_settings = src.num_user_settings;
+    ++dst.user_settings_generation;
+    dst.user_load_key = src.user_load_key;
+    dst.user_key_type = src.user_key_type;
+    dst.user_depth = src.user_depth;
+    dst.user_convergence = src.user_convergence;
+    dst.user_fov = src.user_fov;
+    dst.user_preset_index = src.user_preset_index;
+    dst.prev_depth = src.prev_depth;
+    dst.prev_convergence = src.prev_convergence;
+    dst.prev_fov = src.prev_fov;
+    dst.was_held = src.was_held;
+    dst.load_xinput = src.load_xinput;
+    dst.sleep_count = src.sleep_count;
+    dst.user_load_str = src.user_load_str;
+    dst.user_type_str = src.user_type_str;
+}
+
+static bool UserRowsEqual(const StereoDisplayDriverConfiguration& a, const StereoDisplayDriverConfiguration& b)
+{
+    return a.num_user_settings == b.num_user_settings &&
+           a.user_load_str == b.user_load_str &&
+           a.user_type_str == b.user_type_str &&
+           a.user_depth == b.user_depth &&
+           a.user_convergence == b.user_convergence &&
+           a.user_fov == b.user_fov;
+}
+
+
+//-----------------------------------------------------------------------------
+// Purpose: Schema-table field helpers (see config_schema.h). Each is a single
+//          switch on the row's type; the JSON value comes from the caller's
+//          one pass over the object, never from a second key lookup.
+//-----------------------------------------------------------------------------
+namespace schema = vrto3d::config_schema;
+
+// Re-derive a key bind's parsed form after its name string changed.
+static void ResolveField(const schema::FieldDesc& d, StereoDisplayDriverConfiguration& c)
+{
+    if (d.type == schema::FieldType::KeyBind) {
+        ParseBindName(c.*d.member.s, c.*d.code, c.*d.xinput);
+    } else if (d.type == schema::FieldType::KeyBindType) {
+        c.*d.code = vrto3d::keys::KeyBindTypeFromName(c.*d.member.s, 0);
+    }
+}
+
+static void AssignDefault(const schema::FieldDesc& d, StereoDisplayDriverConfiguration& c)
+{
+    switch (d.type) {
+    case schema::FieldType::Bool:  c.*d.member.b = d.def.b; break;
+    case schema::FieldType::Int:   c.*d.member.i = d.def.i; break;
+    case schema::FieldType::Float: c.*d.member.f = static_cast<float>(d.def.f); break;
+    case schema::FieldType::String:
+    case schema::FieldType::KeyBind:
+    case schema::FieldType::KeyBindType:
+        c.*d.member.s = d.def.s;
+        break;
+    case schema::FieldType::StringList:
+        (c.*d.member.sl).assign(d.def.sl.items, d.def.sl.items + d.def.sl.count);
+        break;
+    case schema::FieldType::Float3:
+        for (float& v : c.*d.member.f3) v = static_cast<float>(d.def.f);
+        break;
+    case schema::FieldType::OutputMode:
+        c.*d.member.mode = OutputModeFromString(d.def.s);
+        break;
+    }
+    ResolveField(d, c);
+}
+
+// False when `v` has the wrong type for the row (caller applies the default).
+static bool ReadField(const schema::FieldDesc& d, const nlohmann::json& v,
+                      StereoDisplayDriverConfiguration& c)
+{
+    if (v.is_null()) return false;
+    try {
+        switch (d.type) {
+        case schema::FieldType::Bool:  c.*d.member.b = v.get<bool>(); break;
+        case schema::FieldType::Int:   c.*d.member.i = v.get<int32_t>(); break;
+        case schema::FieldType::Float: c.*d.member.f = v.get<float>(); break;
+        case schema::FieldType::String:
+        case schema::FieldType::KeyBind:
+        case schema::FieldType::KeyBindType:
+            c.*d.member.s = v.get<std::string>();
+            break;
+        case schema::FieldType::StringList:
+            c.*d.member.sl = v.get<std::vector<std::string>>();
+            break;
+        case schema::FieldType::Float3: {
+            if (!v.is_array() || v.size() < 3) return false;
+            float rgb[3] = {v[0].get<float>(), v[1].get<float>(), v[2].get<float>()};
+            std::copy(rgb, rgb + 3, c.*d.member.f3);
+            break;
+        }
+        case schema::FieldType::OutputMode:
+            c.*d.member.mode = OutputModeFromString(v.get<std::string>());
+            break;
+        }
+    } catch (const nlohmann::json::exception& e) {
+        LOG() << "Config key \"" << d.key << "\" wrong type (" << e.what() << "); using default";
+        return false;
+    }
+    ResolveField(d, c);
+    return true;
+}
+
+template <typename Json>
+static void EmitField(const schema::FieldDesc& d, const StereoDisplayDriverConfiguration& c, Json& out)
+{
+    Json& v = out[d.key];
+    switch (d.type) {
+    case schema::FieldType::Bool:  v = c.*d.member.b; break;
+    case schema::FieldType::Int:   v = c.*d.member.i; break;
+    case schema::FieldType::Float: v = c.*d.member.f; break;
+    case schema::FieldType::String:
+    case schema::FieldType::KeyBind:
+    case schema::FieldType::KeyBindType:
+        v = c.*d.member.s;
+        break;
+    case schema::FieldType::StringList: v = c.*d.member.sl; break;
+    case schema::FieldType::Float3: {
+        const float (&rgb)[3] = c.*d.member.f3;
+        v = {rgb[0], rgb[1], rgb[2]};
+        break;
+    }
+    case schema::FieldType::OutputMode: v = OutputModeToString(c.*d.member.mode); break;
+    }
+}
+
+static void EmitDefault(const schema::FieldDesc& d, nlohmann::ordered_json& out)
+{
+    nlohmann::ordered_json& v = out[d.key];
+    switch (d.type) {
+    case schema::FieldType::Bool:  v = d.def.b; break;
+    case schema::FieldType::Int:   v = d.def.i; break;
+    case schema::FieldType::Float: v = d.def.f; break;
+    case schema::FieldType::String:
+    case schema::FieldType::OutputMode:
+    case schema::FieldType::KeyBind:
+    case schema::FieldType::KeyBindType:
+        v = d.def.s;
+        break;
+    case schema::FieldType::StringList:
+        v = nlohmann::ordered_json::array();
+        for (size_t i = 0; i < d.def.sl.count; ++i) v.push_back(d.def.sl.items[i]);
+        break;
+    case schema::FieldType::Float3: v = {d.def.f, d.def.f, d.def.f}; break;
+    }
+}
+
+// Hot-reload diff: compare the stored form (bind names, not parsed codes).
+static bool FieldEqual(const schema::FieldDesc& d, const StereoDisplayDriverConfiguration& a,
+                       const StereoDisplayDriverConfiguration& b)
+{
+    switch (d.type) {
+    case schema::FieldType::Bool:  return a.*d.member.b == b.*d.member.b;
+    case schema::FieldType::Int:   return a.*d.member.i == b.*d.member.i;
+    case schema::FieldType::Float: return a.*d.member.f == b.*d.member.f;
+    case schema::FieldType::String:
+    case schema::FieldType::KeyBind:
+    case schema::FieldType::KeyBindType:
+        return a.*d.member.s == b.*d.member.s;
+    case schema::FieldType::StringList: return a.*d.member.sl == b.*d.member.sl;
+    case schema::FieldType::Float3:
+        return std::equal(a.*d.member.f3, a.*d.member.f3 + 3, b.*d.member.f3);
+    case schema::FieldType::OutputMode: return a.*d.member.mode == b.*d.member.mode;
+    }
+    return true;
+}
+
+static void CopyField(const schema::FieldDesc& d, const StereoDisplayDriverConfiguration& src,
+                      StereoDisplayDriverConfiguration& dst)
+{
+    switch (d.type) {
+    case schema::FieldType::Bool:  dst.*d.member.b = src.*d.member.b; break;
+    case schema::FieldType::Int:   dst.*d.member.i = src.*d.member.i; break;
+    case schema::FieldType::Float: dst.*d.member.f = src.*d.member.f; break;
+    case schema::FieldType::String: dst.*d.member.s = src.*d.member.s; break;
+    case schema::FieldType::StringList: dst.*d.member.sl = src.*d.member.sl; break;
+    case schema::FieldType::Float3:
+        std::copy(src.*d.member.f3, src.*d.member.f3 + 3, dst.*d.member.f3);
+        break;
+    case schema::FieldType::OutputMode: dst.*d.member.mode = src.*d.member.mode; break;
+    case schema::FieldType::KeyBind:
+        dst.*d.member.s = src.*d.member.s;
+        dst.*d.code = src.*d.code;
+        dst.*d.xinput = src.*d.xinput;
+        break;
+    case schema::FieldType::KeyBindType:
+        dst.*d.member.s = src.*d.member.s;
+        dst.*d.code = src.*d.code;
+        break;
+    }
+}
+
+static uint32_t ChangeGroup(const schema::FieldDesc& d)
+{
+    const std::string_view k = d.key;
+    if (k == "depth" || k == "convergence")                       return kChangeDepthConv;
+    if (k == "fov" || k == "hmd_height" || k == "aspect_ratio")   return kChangeProjection;
+    if (k.compare(0, 7, "shader_") == 0)                          return kChangeShader;
+    if (d.type == schema::FieldType::KeyBind ||
+        d.type == schema::FieldType::KeyBindType)                 return kChangeHotkeys;
+    if (k.find("cursor") != std::string_view::npos)               return kChangeCursor;
+    return kChangeOther;
+}
+
+enum class LoadPass { Params, Profile };
+
+static bool InPass(const schema::FieldDesc& d, LoadPass pass)
+{
+    return pass == LoadPass::Params
+        ? (d.scope & schema::kGlobal) != 0
+        : (d.scope & (schema::kProfile | schema::kProfileOptional)) != 0;
+}
+
+static bool IsOptional(const schema::FieldDesc& d, LoadPass pass)
+{
+    return pass == LoadPass::Profile && !(d.scope & schema::kProfile);
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: One pass over the top-level JSON object: each key is hashed once
+//          to find its row, then rows the pass needs but the file lacks get
+//          their default (or, for kProfileOptional, keep the current value)
+//-----------------------------------------------------------------------------
+static void LoadFields(const nlohmann::json& json, StereoDisplayDriverConfiguration& c, LoadPass pass)
+{
+    std::bitset<schema::kFieldCount> seen;
+    for (auto it = json.begin(); it != json.end(); ++it) {
+        const size_t idx = schema::FindField(it.key());
+        if (idx == schema::kFieldCount) continue;
+        const schema::FieldDesc& d = schema::kFields[idx];
+        if (!InPass(d, pass)) continue;
+        seen.set(idx);
+        if (!ReadField(d, it.value(), c)) {
+            // A malformed RGB triplet leaves the current value, as before.
+            if (d.type != schema::FieldType::Float3) AssignDefault(d, c);
+        }
+    }
+    for (size_t i = 0; i < schema::kFieldCount; ++i) {
+        const schema::FieldDesc& d = schema::kFields[i];
+        if (!seen.test(i) && InPass(d, pass) && !IsOptional(d, pass)) {
+            AssignDefault(d, c);
+        }
+    }
+}
+
+// In-memory default_config_: every table row in order, then user_settings.
+static nlohmann::ordered_json BuildDefaultConfig()
+{
+    nlohmann::ordered_json j;
+    for (const auto& d : schema::kFields) {
+        EmitDefault(d, j);
+    }
+    j["user_settings"] = {
+        {
+            {"user_load_key", "Numpad1"},
+            {"user_key_type", "switch"},
+            {"user_depth", 0.1},
+            {"user_convergence", 1.0}
+        },
+        {
+            {"user_load_key", "Pad_Guide"},
+            {"user_key_type", "toggle"},
+            {"user_depth", 0.065},
+            {"user_convergence", 1.0}
+        },
+        {
+            {"user_load_key", "Numpad3"},
+            {"user_key_type", "hold"},
+            {"user_depth", 0.065},
+            {"user_convergence", 1.0},
+            {"user_fov", 50.0}
+        }
+    };
+    return j;
+}
+
+// user_settings as saved: scalar form for single-preset rows (the legacy file
+// format), arrays for multi-preset cycles.
+static nlohmann::ordered_json EmitUserSettings(const StereoDisplayDriverConfiguration& config)
+{
+    auto writePreset = [](nlohmann::ordered_json& obj, const char* key,
+                          const std::vector<float>& vals) {
+        if (vals.size() == 1) obj[key] = vals[0];
+        else                  obj[key] = vals;
+    };
+    nlohmann::ordered_json arr = nlohmann::ordered_json::array();
+    for (size_t i = 0; i < config.num_user_settings; ++i) {
+        nlohmann::ordered_json u;
+        u["user_load_key"]    = config.user_load_str[i];
+        u["user_key_type"]    = config.user_type_str[i];
+        writePreset(u, "user_depth",       config.user_depth[i]);
+        writePreset(u, "user_convergence", config.user_convergence[i]);
+        writePreset(u, "user_fov",         config.user_fov[i]);
+        arr.push_back(u);
+    }
+    return arr;
+}
+
+// Derived state LoadProfileFromJson sets after the fields (both load paths).
+static void FinishProfileLoad(StereoDisplayDriverConfiguration& config)
+{
+    config.pitch_set = config.pitch_enable;
+    config.yaw_set = config.yaw_enable;
+    config.pose_reset = true;
+    vrto3d::CompileHotkeyTable(config);
+}
+
+
+//-----------------------------------------------------------------------------
+// Purpose: Binary profile cache visitors (see profile_cache.h), driven by the
+//          same table: a row's cached form is its member plus, for key
+//          binds, the parsed code/pad flag
+//-----------------------------------------------------------------------------
+template <typename IO>
+static void VisitField(IO& io, const schema::FieldDesc& d, StereoDisplayDriverConfiguration& c,
+                       bool optional)
+{
+    auto field = [&](auto& member) {
+        if (optional) io.Opt(d.key, member);
+        else          io(d.key, member);
+    };
+    switch (d.type) {
+    case schema::FieldType::Bool:       field(c.*d.member.b); break;
+    case schema::FieldType::Int:        field(c.*d.member.i); break;
+    case schema::FieldType::Float:      field(c.*d.member.f); break;
+    case schema::FieldType::String:     field(c.*d.member.s); break;
+    case schema::FieldType::StringList: field(c.*d.member.sl); break;
+    case schema::FieldType::Float3:     field(c.*d.member.f3); break;
+    case schema::FieldType::OutputMode: field(c.*d.member.mode); break;
+    case schema::FieldType::KeyBind:
+        field(c.*d.member.s);
+        io(d.key, c.*d.code);
+        io(d.key, c.*d.xinput);
+        break;
+    case schema::FieldType::KeyBindType:
+        field(c.*d.member.s);
+        io(d.key, c.*d.code);
+        break;
+    }
+}
+
+template <typename IO>
+static void VisitParamsFields(IO& io, StereoDisplayDriverConfiguration& c)
+{
+    for (const auto& d : schema::kFields) {
+        if (InPass(d, LoadPass::Params)) VisitField(io, d, c, false);
+    }
+}
+
+template <typename IO>
+static void VisitProfileFields(IO& io, StereoDisplayDriverConfiguration& c)
+{
+    for (const auto& d : schema::kFields) {
+        if (InPass(d, LoadPass::Profile)) VisitField(io, d, c, IsOptional(d, LoadPass::Profile));
+    }
+
+    size_t rows = c.num_user_settings;
+    io.Count("user_settings", rows);
+    if constexpr (IO::kDecoding) {
+        ResizeUserRows(c, rows);
+    }
+    for (size_t i = 0; i < rows; ++i) {
+        bool xinput = c.load_xinput[i];  // vector<bool>: no element reference
+        io("user_load_key", c.user_load_str[i]);
+        io("user_load_code", c.user_load_key[i]);
+        io("load_xinput", xinput);
+        io("user_key_type", c.user_type_str[i]);
+        io("user_key_code", c.user_key_type[i]);
+        io("user_depth", c.user_depth[i]);
+        io("user_convergence", c.user_convergence[i]);
+        io("user_fov", c.user_fov[i]);
+        c.load_xinput[i] = xinput;
+    }
+}
+
+static const auto kVisitParams = [](auto& io, StereoDisplayDriverConfiguration& c) {
+    VisitParamsFields(io, c);
+};
+static const auto kVisitProfile = [](auto& io, StereoDisplayDriverConfiguration& c) {
+    VisitProfileFields(io, c);
+};
+
+
+//-----------------------------------------------------------------------------
+// Purpose: Schema hash for one cache kind: its field names and types, the
+//          in-memory defaults every missing JSON key falls back to, and the
+//          key table the cached bind codes were parsed with
+//-----------------------------------------------------------------------------
+template <typename VisitFn>
+static uint64_t CacheSchema(const char* kind, VisitFn visit, uint64_t defaults_hash)
+{
+    vrto3d::profile_cache::SchemaHasher hasher(kind);
+    StereoDisplayDriverConfiguration probe;
+    ResizeUserRows(probe, 1);  // so the per-row fields are hashed too
+    visit(hasher, probe);
+    const uint64_t keys_hash = vrto3d::keys::table::kTablesHash;
+    const uint64_t hash = vrto3d::profile_cache::Fnv1a(
+        reinterpret_cast<const char*>(&defaults_hash), sizeof(defaults_hash), hasher.Hash());
+    return vrto3d::profile_cache::Fnv1a(reinterpret_cast<const char*>(&keys_hash),
+                                        sizeof(keys_hash), hash);
+}
+
+
+//-----------------------------------------------------------------------------
+// Purpose: Fill `config` from a cache payload, all or nothing
+//-----------------------------------------------------------------------------
+template <typename VisitFn>
+static bool DecodeCached(const std::string& payload, StereoDisplayDriverConfiguration& config,
+                         VisitFn visit)
+{
+    StereoDisplayDriverConfiguration scratch = config;
+    vrto3d::profile_cache::Reader reader(payload.data(), payload.size());
+    visit(reader, scratch);
+    if (!reader.Done()) {
+        return false;
+    }
+    config = std::move(scratch);
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// Purpose: Fill `config` from a current cache file; `payload` keeps the bytes
+//-----------------------------------------------------------------------------
+template <typename VisitFn>
+static bool LoadFromCache(const std::string& cachePath, uint64_t schema,
+                          const vrto3d::profile_cache::FileStamp& stamp,
+                          StereoDisplayDriverConfiguration& config, VisitFn visit,
+                          std::string& payload)
+{
+    if (!vrto3d::profile_cache::Load(cachePath, schema, stamp, payload)) {
+        return false;
+    }
+    if (!DecodeCached(payload, config, visit)) {
+        LOG() << "Profile cache " << cachePath << " is corrupt; reparsing JSON";
+        payload.clear();
+        return false;
+    }
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// Purpose: Record what a JSON load just produced, keyed to the source stamp
+//          taken before the file was read. Returns the payload.
+//-----------------------------------------------------------------------------
+template <typename VisitFn>
+static std::string StoreToCache(const std::string& cachePath, uint64_t schema,
+                                const vrto3d::profile_cache::FileStamp& stamp,
+                                const nlohmann::json& source,
+                                StereoDisplayDriverConfiguration& config, VisitFn visit)
+{
+    vrto3d::profile_cache::Writer writer(source);
+    visit(writer, config);
+    vrto3d::profile_cache::Store(cachePath, schema, stamp, writer.Bytes());
+    return writer.Bytes();
+}
+
+
+JsonManager::JsonManager()
+    : default_config_(BuildDefaultConfig()),
+      index_(std::make_unique<vrto3d::ProfileIndex>())
+{
     vrto3dFolder = GetSteamInstallPath();
     if (vrto3dFolder != "")
     {
         vrto3dFolder += "/config/vrto3d";
         createFolderIfNotExist(vrto3dFolder);
     }
+
+    const uint64_t defaults_hash = vrto3d::profile_cache::Fnv1a(default_config_.dump());
+    params_schema_ = CacheSchema("params", kVisitParams, defaults_hash);
+    profile_schema_ = CacheSchema("profile", kVisitProfile, defaults_hash);
+}
+
+
+JsonManager::~JsonManager() = default;
+
+
+//-----------------------------------------------------------------------------
+// Purpose: Path of the binary cache of vrto3dFolder/fileName for one loader
+//-----------------------------------------------------------------------------
+std::string JsonManager::cachePath(const std::string& fileName, const char* kind) const
+{
+    return vrto3dFolder + "/" + fileName + "." + kind + ".cache";
 }
 
 
@@ -181,19 +699,21 @@ void JsonManager::createFolderIfNotExist(const std::string& path) {
 
 
 //-----------------------------------------------------------------------------
-// Purpose: Write a JSON to Steam/config/vrto3d
+// Purpose: Queue a JSON write to Steam/config/vrto3d. Serialization and the
+//          temp-file + rename happen on the writer thread; repeated saves of
+//          one file within the debounce window coalesce into one write.
 //-----------------------------------------------------------------------------
-void JsonManager::writeJsonToFile(const std::string& fileName, const nlohmann::ordered_json& jsonData) {
-    std::string filePath = vrto3dFolder + "/" + fileName;
-    std::ofstream file(filePath);
-    if (file.is_open()) {
-        file << jsonData.dump(4); // Pretty-print the JSON with an indent of 4 spaces
-        file.close();
-        LOG() << "Saved profile: " << fileName;
-    }
-    else {
-        LOG() << "Failed to save profile: " << fileName;
+std::shared_future<bool> JsonManager::writeJsonToFile(const std::string& fileName, nlohmann::ordered_json jsonData) {
+    {
+        std::lock_guard<std::mutex> lock(index_mutex_);
+        index_->MarkStale(fileName);
     }
+    return writer_.Write(vrto3dFolder + "/" + fileName, std::move(jsonData));
+}
+
+
+bool JsonManager::flushPendingWrite(const std::string& fileName) {
+    return writer_.Flush(vrto3dFolder + "/" + fileName);
 }
 
 
@@ -278,9 +798,14 @@ std::vector<std::string> JsonManager::split(const std::string& str, char delimit
 //-----------------------------------------------------------------------------
 void JsonManager::EnsureDefaultConfigExists()
 {
+    flushPendingWrite(DEF_CFG);
     auto writeDefaults = [&](const char* reason) {
         std::string filePath = vrto3dFolder + "/" + DEF_CFG;
         LOG() << DEF_CFG << ": " << reason << " — writing fresh defaults";
+        {
+            std::lock_guard<std::mutex> lock(index_mutex_);
+            index_->MarkStale(DEF_CFG);
+        }
         std::ofstream file(filePath);
         if (file.is_open()) {
             file << default_config_.dump(4);
@@ -297,6 +822,14 @@ void JsonManager::EnsureDefaultConfigExists()
         return;
     }
 
+    // A current params cache means the file hasn't changed since a load with
+    // these same defaults, i.e. since the last time it was filled in here.
+    if (vrto3d::profile_cache::IsCurrent(cachePath(DEF_CFG, "params"), params_schema_,
+                                         vrto3d::profile_cache::StatFile(filePath))) {
+        LOG() << "Default config unchanged since last load; skipping key check";
+        return;
+    }
+
     LOG() << "Default config already exists. Checking for missing/default keys...";
     nlohmann::json existing_json = readJsonFromFile(DEF_CFG);
 
@@ -307,34 +840,19 @@ void JsonManager::EnsureDefaultConfigExists()
         return;
     }
 
+    // Only rewrite when filling in changed something: an unconditional write
+    // bumps the mtime and would invalidate the profile caches every launch.
     nlohmann::ordered_json merged_json = reorderFillJson(existing_json);
-    writeJsonToFile(DEF_CFG, merged_json);
-    LOG() << "Updated config written with defaults filled in";
-}
-
-
-//-----------------------------------------------------------------------------
-// Purpose: Get a value from jsonConfig or fallback to defaultConfig
-//-----------------------------------------------------------------------------
-template <typename T>
-T JsonManager::getValue(const nlohmann::json& jsonConfig, const std::string& key) {
-    if (jsonConfig.contains(key) && !jsonConfig[key].is_null()) {
-        try {
-            return jsonConfig[key].get<T>();
-        } catch (const nlohmann::json::exception& e) {
-            LOG() << "getValue: key \"" << key << "\" wrong type ("
-                  << e.what() << "); using default";
-        }
-    }
-    // Guard the fallback too: if the key was never added to default_config_,
-    // operator[] would insert null and get<T>() would throw straight out of
-    // the caller's entire load, silently defaulting every later key. Fail
-    // soft on just this key and make the omission loud in the log.
-    if (!default_config_.contains(key)) {
-        LOG() << "getValue: key \"" << key << "\" missing from default_config_ - add it!";
-        return T{};
+    std::ifstream current(filePath);
+    const std::string current_text((std::istreambuf_iterator<char>(current)),
+                                   std::istreambuf_iterator<char>());
+    current.close();
+    if (current_text == merged_json.dump(4)) {
+        LOG() << "Default config already complete";
+        return;
     }
-    return default_config_[key].get<T>();
+    writeJsonToFile(DEF_CFG, std::move(merged_json));
+    LOG() << "Updated config queued with defaults filled in";
 }
 
 
@@ -343,9 +861,21 @@ T JsonManager::getValue(const nlohmann::json& jsonConfig, const std::string& key
 //-----------------------------------------------------------------------------
 void JsonManager::LoadParamsFromJson(StereoDisplayDriverConfiguration& config)
 {
+    VRTO3D_TRACE_ZONE("json.LoadParams");
+    flushPendingWrite(DEF_CFG);
+    const std::string sourcePath = vrto3dFolder + "/" + DEF_CFG;
+    const std::string cacheFile = cachePath(DEF_CFG, "params");
+    auto stamp = vrto3d::profile_cache::StatFile(sourcePath);
+    std::string payload;
+    if (LoadFromCache(cacheFile, params_schema_, stamp, config, kVisitParams, payload)) {
+        config.sleep_count_max = (int)(floor(1600.0 / (1000.0 / config.display_frequency)));
+        return;
+    }
+
     try {
         // Read the JSON configuration from the file
         nlohmann::json jsonConfig = readJsonFromFile(DEF_CFG);
+        bool fromFile = true;
 
         // If the file was missing/empty/corrupt, readJsonFromFile returned {}.
         // Recreate it from the in-memory defaults so subsequent loads, the
@@ -355,58 +885,21 @@ void JsonManager::LoadParamsFromJson(StereoDisplayDriverConfiguration& config)
             LOG() << "LoadParamsFromJson: " << DEF_CFG
                   << " missing/empty/corrupt — regenerating from defaults";
             std::string filePath = vrto3dFolder + "/" + DEF_CFG;
+            {
+                std::lock_guard<std::mutex> lock(index_mutex_);
+                index_->MarkStale(DEF_CFG);
+            }
             std::ofstream file(filePath);
             if (file.is_open()) {
                 file << default_config_.dump(4);
                 file.close();
             }
             jsonConfig = default_config_;  // continue with in-memory defaults
+            fromFile = false;
         }
 
-        // Load values directly from the base level of the JSON
-        config.display_index = getValue<int>(jsonConfig, "display_index");
-        config.output_mode = OutputModeFromString(getValue<std::string>(jsonConfig, "output_mode"));
-        config.eye_swap = getValue<bool>(jsonConfig, "eye_swap");
-        config.render_width = getValue<int>(jsonConfig, "render_width");
-        config.render_height = getValue<int>(jsonConfig, "render_height");
-        config.display_frequency = getValue<float>(jsonConfig, "display_frequency");
-
-        config.hmd_x = getValue<float>(jsonConfig, "hmd_x");
-        config.hmd_y = getValue<float>(jsonConfig, "hmd_y");
-        config.hmd_yaw = getValue<float>(jsonConfig, "hmd_yaw");
-
-        config.async_enable = getValue<bool>(jsonConfig, "async_enable");
-        config.disable_hotkeys = getValue<bool>(jsonConfig, "disable_hotkeys");
-        config.dash_enable = getValue<bool>(jsonConfig, "dash_enable");
-        config.auto_focus = getValue<bool>(jsonConfig, "auto_focus");
-        config.auto_exit = getValue<bool>(jsonConfig, "auto_exit");
-        config.hide_cursor = getValue<bool>(jsonConfig, "hide_cursor");
-        config.lock_cursor = getValue<bool>(jsonConfig, "lock_cursor");
-        config.stereo_cursor = getValue<bool>(jsonConfig, "stereo_cursor");
-        config.cursor_depth = getValue<float>(jsonConfig, "cursor_depth");
-        config.cursor_size = getValue<int>(jsonConfig, "cursor_size");
-        config.use_open_track = getValue<bool>(jsonConfig, "use_open_track");
-        config.open_track_port = getValue<int>(jsonConfig, "open_track_port");
-        config.use_track_filter = getValue<bool>(jsonConfig, "use_track_filter");
-        config.trk_flt_rot_sens = getValue<float>(jsonConfig, "trk_flt_rot_sens");
-        config.trk_flt_pos_sens = getValue<float>(jsonConfig, "trk_flt_pos_sens");
-        config.trk_flt_rot_dz = getValue<float>(jsonConfig, "trk_flt_rot_dz");
-        config.trk_flt_pos_dz = getValue<float>(jsonConfig, "trk_flt_pos_dz");
-        config.trk_flt_zoom_smooth = getValue<float>(jsonConfig, "trk_flt_zoom_smooth");
-        config.trk_flt_max_zoom = getValue<float>(jsonConfig, "trk_flt_max_zoom");
-        config.sr_tracking_enabled     = getValue<bool>(jsonConfig, "sr_tracking_enabled");
-        config.sr_filter_pos_mincutoff = getValue<float>(jsonConfig, "sr_filter_pos_mincutoff");
-        config.sr_filter_pos_beta      = getValue<float>(jsonConfig, "sr_filter_pos_beta");
-        config.sr_filter_rot_mincutoff = getValue<float>(jsonConfig, "sr_filter_rot_mincutoff");
-        config.sr_filter_rot_beta      = getValue<float>(jsonConfig, "sr_filter_rot_beta");
-        config.sr_angle_deadzone_deg   = getValue<float>(jsonConfig, "sr_angle_deadzone_deg");
-        config.sr_sens_yaw             = getValue<float>(jsonConfig, "sr_sens_yaw");
-        config.sr_sens_pitch           = getValue<float>(jsonConfig, "sr_sens_pitch");
-        config.sr_sens_roll            = getValue<float>(jsonConfig, "sr_sens_roll");
-        config.sr_max_yaw              = getValue<float>(jsonConfig, "sr_max_yaw");
-        config.sr_max_pitch            = getValue<float>(jsonConfig, "sr_max_pitch");
-        config.sr_max_roll             = getValue<float>(jsonConfig, "sr_max_roll");
-        config.sr_track_mode           = getValue<std::string>(jsonConfig, "sr_track_mode");
+        // Driver-wide keys, one pass over the object (config_schema.h)
+        LoadFields(jsonConfig, config, LoadPass::Params);
 
         // LeiaSR + OpenTrack: force the consumer-side AHRS filter on. The SR
         // pipeline already smooths upstream, but the receiver expects filtered
@@ -418,11 +911,16 @@ void JsonManager::LoadParamsFromJson(StereoDisplayDriverConfiguration& config)
 
             nlohmann::ordered_json merged = reorderFillJson(jsonConfig);
             merged["use_track_filter"] = true;
-            writeJsonToFile(DEF_CFG, merged);
+            writeJsonToFile(DEF_CFG, std::move(merged));
+            flushPendingWrite(DEF_CFG);  // the cache is keyed to the new stamp
+            stamp = vrto3d::profile_cache::StatFile(sourcePath);
         }
-        config.launch_script = getValue<std::string>(jsonConfig, "launch_script");
 
         config.sleep_count_max = (int)(floor(1600.0 / (1000.0 / config.display_frequency)));
+
+        if (fromFile) {
+            StoreToCache(cacheFile, params_schema_, stamp, jsonConfig, config, kVisitParams);
+        }
     }
     catch (const nlohmann::json::exception& e) {
         LOG() << "Error reading default_config.json: " << e.what();
@@ -435,14 +933,57 @@ void JsonManager::LoadParamsFromJson(StereoDisplayDriverConfiguration& config)
 //-----------------------------------------------------------------------------
 bool JsonManager::LoadProfileFromJson(const std::string& filename, StereoDisplayDriverConfiguration& config)
 {
+    VRTO3D_TRACE_ZONE("json.LoadProfile");
+    flushPendingWrite(filename);  // a just-saved profile reloads what was saved
+    const std::string cacheFile = cachePath(filename, "profile");
+
+    // A trusted index answers "no such profile" without touching the disk;
+    // otherwise the entry is re-stat'ed. Either way a payload recorded for
+    // the current stamp decodes from memory. The entry is copied out so the
+    // decode and any parse below run without the index lock.
+    vrto3d::profile_cache::FileStamp stamp{};
+    std::string memory_payload;
+    {
+        std::lock_guard<std::mutex> lock(index_mutex_);
+        syncProfileIndex();
+        const vrto3d::ProfileIndex::Entry* entry = nullptr;
+        if (indexTrusted(filename)) {
+            entry = index_->Find(filename);
+            if (!entry && filename != DEF_CFG) {
+                LOG() << "No profile for " << filename;
+                return false;
+            }
+        } else {
+            entry = index_->Refresh(vrto3dFolder, filename);
+        }
+        if (entry) {
+            stamp = entry->stamp;
+            memory_payload = entry->payload;
+        }
+    }
+    if (!memory_payload.empty() && DecodeCached(memory_payload, config, kVisitProfile)) {
+        VRTO3D_TRACE_COUNT("json.profile_memory_hits", 1);
+        FinishProfileLoad(config);
+        return true;
+    }
+    std::string payload;
+    if (LoadFromCache(cacheFile, profile_schema_, stamp, config, kVisitProfile, payload)) {
+        VRTO3D_TRACE_COUNT("json.profile_cache_hits", 1);
+        std::lock_guard<std::mutex> lock(index_mutex_);
+        index_->SetPayload(filename, stamp, std::move(payload));
+        FinishProfileLoad(config);
+        return true;
+    }
+
     try {
         // Read the JSON configuration from the file
+        VRTO3D_TRACE_COUNT("json.profile_parses", 1);
         nlohmann::json jsonConfig = readJsonFromFile(filename);
+        bool fromFile = true;
 
         // readJsonFromFile returns {} for missing, empty, or corrupt files.
         // For game profiles that's a "no profile" signal; for default_config
-        // we fall through with an empty json so getValue<>() pulls every key
-        // from default_config_.
+        // we fall through with the in-memory defaults.
         if ((jsonConfig.is_null() || !jsonConfig.is_object() || jsonConfig.empty())
             && filename != DEF_CFG) {
             LOG() << "No profile (or unreadable) for " << filename;
@@ -452,93 +993,13 @@ bool JsonManager::LoadProfileFromJson(const std::string& filename, StereoDisplay
             LOG() << "LoadProfileFromJson: " << filename
                   << " missing/empty/corrupt — using in-memory defaults";
             jsonConfig = default_config_;
+            fromFile = false;
         }
 
-        // Profile settings
-        config.hmd_height = getValue<float>(jsonConfig, "hmd_height");
-        config.aspect_ratio = getValue<float>(jsonConfig, "aspect_ratio");
-        config.fov = getValue<float>(jsonConfig, "fov");
-        config.depth = getValue<float>(jsonConfig, "depth");
-        config.convergence = getValue<float>(jsonConfig, "convergence");
-        if (jsonConfig.contains("async_enable")) {
-            config.async_enable = getValue<bool>(jsonConfig, "async_enable");
-        }
-        if (jsonConfig.contains("auto_depth_enabled")) {
-            config.auto_depth_enabled = getValue<bool>(jsonConfig, "auto_depth_enabled");
-        }
-        if (jsonConfig.contains("auto_depth_target_disparity")) {
-            config.auto_depth_target_disparity = getValue<float>(jsonConfig, "auto_depth_target_disparity");
-        }
-        if (jsonConfig.contains("auto_depth_smoothing")) {
-            config.auto_depth_smoothing = getValue<float>(jsonConfig, "auto_depth_smoothing");
-        }
-
-        // Cursor controls — guarded so older profiles without the keys keep
-        // the current (default-config) values.
-        if (jsonConfig.contains("hide_cursor")) {
-            config.hide_cursor = getValue<bool>(jsonConfig, "hide_cursor");
-        }
-        if (jsonConfig.contains("lock_cursor")) {
-            config.lock_cursor = getValue<bool>(jsonConfig, "lock_cursor");
-        }
-        if (jsonConfig.contains("stereo_cursor")) {
-            config.stereo_cursor = getValue<bool>(jsonConfig, "stereo_cursor");
-        }
-        if (jsonConfig.contains("cursor_depth")) {
-            config.cursor_depth = getValue<float>(jsonConfig, "cursor_depth");
-        }
-        if (jsonConfig.contains("cursor_size")) {
-            config.cursor_size = getValue<int>(jsonConfig, "cursor_size");
-        }
-
-        // Display-correction shader pass — all keys guarded so older profiles
-        // without them still load cleanly with pass-through defaults.
-        if (jsonConfig.contains("shader_enabled")) {
-            config.shader_enabled = getValue<bool>(jsonConfig, "shader_enabled");
-        }
-        auto loadShaderTriplet = [&](const char* key, float (&dst)[3]) {
-            if (jsonConfig.contains(key) && jsonConfig[key].is_array()
-                && jsonConfig[key].size() >= 3) {
-                dst[0] = jsonConfig[key][0].get<float>();
-                dst[1] = jsonConfig[key][1].get<float>();
-                dst[2] = jsonConfig[key][2].get<float>();
-            }
-        };
-        loadShaderTriplet("shader_lift",  config.shader_lift);
-        loadShaderTriplet("shader_gamma", config.shader_gamma);
-        loadShaderTriplet("shader_gain",  config.shader_gain);
-        if (jsonConfig.contains("shader_curve")) {
-            config.shader_curve = getValue<float>(jsonConfig, "shader_curve");
-        }
-        if (jsonConfig.contains("shader_curve_offset_low")) {
-            config.shader_curve_off_low = getValue<float>(jsonConfig, "shader_curve_offset_low");
-        }
-        if (jsonConfig.contains("shader_curve_offset_high")) {
-            config.shader_curve_off_high = getValue<float>(jsonConfig, "shader_curve_offset_high");
-        }
-        if (jsonConfig.contains("shader_curve_offset_both")) {
-            config.shader_curve_off_both = getValue<float>(jsonConfig, "shader_curve_offset_both");
-        }
-
-        // Controller settings
-        config.pitch_enable = getValue<bool>(jsonConfig, "pitch_enable");
-        config.pitch_set = config.pitch_enable;
-        config.yaw_enable = getValue<bool>(jsonConfig, "yaw_enable");
-        config.yaw_set = config.yaw_enable;
-
-        config.pose_reset_str = getValue<std::string>(jsonConfig, "pose_reset_key");
-        ParseBindName(config.pose_reset_str, config.pose_reset_key, config.reset_xinput);
-        config.pose_reset = true;
-
-        config.ctrl_toggle_str = getValue<std::string>(jsonConfig, "ctrl_toggle_key");
-        ParseBindName(config.ctrl_toggle_str, config.ctrl_toggle_key, config.ctrl_xinput);
-
-        config.ctrl_type_str = getValue<std::string>(jsonConfig, "ctrl_toggle_type");
-        config.ctrl_type = vrto3d::keys::KeyBindTypeFromName(config.ctrl_type_str, 0);
-
-        config.pitch_radius = getValue<float>(jsonConfig, "pitch_radius");
-        config.ctrl_deadzone = getValue<float>(jsonConfig, "ctrl_deadzone");
-        config.ctrl_sensitivity = getValue<float>(jsonConfig, "ctrl_sensitivity");
+        // Per-profile keys, one pass over the object (config_schema.h).
+        // kProfileOptional keys keep their current (driver-wide) value when
+        // an older profile lacks them.
+        LoadFields(jsonConfig, config, LoadPass::Profile);
 
         // Read user binds from user_settings array, falling back to defaults if missing or empty
         nlohmann::json user_settings_array;
@@ -548,21 +1009,7 @@ bool JsonManager::LoadProfileFromJson(const std::string& filename, StereoDisplay
             user_settings_array = default_config_.at("user_settings");
 
         // Resize vectors based on the size of the user_settings array
-        config.num_user_settings = user_settings_array.size();
-        config.user_load_key.resize(config.num_user_settings);
-        config.user_key_type.resize(config.num_user_settings);
-        config.user_depth.assign(config.num_user_settings, std::vector<float>{});
-        config.user_convergence.assign(config.num_user_settings, std::vector<float>{});
-        config.user_fov.assign(config.num_user_settings, std::vector<float>{});
-        config.user_preset_index.assign(config.num_user_settings, 0);
-        config.prev_depth.resize(config.num_user_settings);
-        config.prev_convergence.resize(config.num_user_settings);
-        config.prev_fov.resize(config.num_user_settings);
-        config.was_held.resize(config.num_user_settings);
-        config.load_xinput.resize(config.num_user_settings);
-        config.sleep_count.resize(config.num_user_settings);
-        config.user_load_str.resize(config.num_user_settings);
-        config.user_type_str.resize(config.num_user_settings);
+        ResizeUserRows(config, user_settings_array.size());
 
         for (size_t i = 0; i < config.num_user_settings; ++i) {
             const auto& user_setting = user_settings_array.at(i);
@@ -611,6 +1058,14 @@ bool JsonManager::LoadProfileFromJson(const std::string& filename, StereoDisplay
             while (config.user_fov[i].size()         < n) config.user_fov[i].push_back(config.fov);
             config.user_preset_index[i] = 0;
         }
+        FinishProfileLoad(config);
+
+        if (fromFile) {
+            std::string stored = StoreToCache(cacheFile, profile_schema_, stamp, jsonConfig, config,
+                                              kVisitProfile);
+            std::lock_guard<std::mutex> lock(index_mutex_);
+            index_->SetPayload(filename, stamp, std::move(stored));
+        }
 
     }
     catch (const nlohmann::json::exception& e) {
@@ -625,192 +1080,176 @@ bool JsonManager::LoadProfileFromJson(const std::string& filename, StereoDisplay
 //-----------------------------------------------------------------------------
 // Purpose: Save Game Specific Settings to Steam\config\vrto3d\app_name_config.json
 //-----------------------------------------------------------------------------
-void JsonManager::SaveProfileToJson(const std::string& filename, StereoDisplayDriverConfiguration& config)
+std::shared_future<bool> JsonManager::SaveProfileToJson(const std::string& filename, StereoDisplayDriverConfiguration& config)
 {
-    // Create a JSON object to hold all the configuration data
-    nlohmann::ordered_json jsonConfig;
-
-    // Populate the JSON object with settings
-    jsonConfig["hmd_height"] = config.hmd_height;
-    jsonConfig["fov"] = config.fov;
-    jsonConfig["depth"] = config.depth;
-    jsonConfig["convergence"] = config.convergence;
-    jsonConfig["async_enable"] = config.async_enable;
-    jsonConfig["auto_depth_enabled"] = config.auto_depth_enabled;
-    jsonConfig["auto_depth_target_disparity"] = config.auto_depth_target_disparity;
-    jsonConfig["auto_depth_smoothing"] = config.auto_depth_smoothing;
-    jsonConfig["hide_cursor"] = config.hide_cursor;
-    jsonConfig["lock_cursor"] = config.lock_cursor;
-    jsonConfig["stereo_cursor"] = config.stereo_cursor;
-    jsonConfig["cursor_depth"] = config.cursor_depth;
-    jsonConfig["cursor_size"] = config.cursor_size;
-    jsonConfig["shader_enabled"] = config.shader_enabled;
-    jsonConfig["shader_lift"]  = { config.shader_lift[0],  config.shader_lift[1],  config.shader_lift[2]  };
-    jsonConfig["shader_gamma"] = { config.shader_gamma[0], config.shader_gamma[1], config.shader_gamma[2] };
-    jsonConfig["shader_gain"]  = { config.shader_gain[0],  config.shader_gain[1],  config.shader_gain[2]  };
-    jsonConfig["shader_curve"] = config.shader_curve;
-    jsonConfig["shader_curve_offset_low"]  = config.shader_curve_off_low;
-    jsonConfig["shader_curve_offset_high"] = config.shader_curve_off_high;
-    jsonConfig["shader_curve_offset_both"] = config.shader_curve_off_both;
-    jsonConfig["pitch_enable"] = config.pitch_enable;
-    jsonConfig["yaw_enable"] = config.yaw_enable;
-    jsonConfig["pose_reset_key"] = config.pose_reset_str;
-    jsonConfig["ctrl_toggle_key"] = config.ctrl_toggle_str;
-    jsonConfig["ctrl_toggle_type"] = config.ctrl_type_str;
-    jsonConfig["pitch_radius"] = config.pitch_radius;
-    jsonConfig["ctrl_deadzone"] = config.ctrl_deadzone;
-    jsonConfig["ctrl_sensitivity"] = config.ctrl_sensitivity;
-
-    // Store user settings as an array, falling back to defaults if none are set.
-    // Each preset value is written as a scalar when only one entry exists
-    // (preserves legacy file format) or as an array for multi-preset cycles.
-    auto writePreset = [](nlohmann::ordered_json& obj, const char* key,
-                          const std::vector<float>& vals) {
-        if (vals.size() == 1) obj[key] = vals[0];
-        else                  obj[key] = vals;
+    // Every per-profile table row in the historical profile order, then
+    // user_settings (falling back to the defaults if none are set).
+    const auto saved = [](const schema::FieldDesc& d) {
+        return InPass(d, LoadPass::Profile) && !(d.scope & schema::kNoProfileSave);
     };
-    if (config.num_user_settings > 0) {
-        for (size_t i = 0; i < config.num_user_settings; i++) {
-            nlohmann::ordered_json userSettings;
-            userSettings["user_load_key"]   = config.user_load_str[i];
-            userSettings["user_key_type"]   = config.user_type_str[i];
-            writePreset(userSettings, "user_depth",       config.user_depth[i]);
-            writePreset(userSettings, "user_convergence", config.user_convergence[i]);
-            writePreset(userSettings, "user_fov",         config.user_fov[i]);
-            jsonConfig["user_settings"].push_back(userSettings);
+    nlohmann::ordered_json jsonConfig;
+    for (const char* key : schema::kProfileSaveOrder) {
+        const size_t i = schema::FindField(key);
+        if (i < schema::kFieldCount && saved(schema::kFields[i])) {
+            EmitField(schema::kFields[i], config, jsonConfig);
         }
     }
-    else {
-        jsonConfig["user_settings"] = default_config_.at("user_settings");
+    for (const auto& d : schema::kFields) {
+        if (saved(d) && !jsonConfig.contains(d.key)) {
+            EmitField(d, config, jsonConfig);
+        }
     }
+    jsonConfig["user_settings"] = config.num_user_settings > 0
+        ? EmitUserSettings(config) : default_config_.at("user_settings");
 
-    writeJsonToFile(filename, jsonConfig);
+    return writeJsonToFile(filename, std::move(jsonConfig));
 }
 
 
 //-----------------------------------------------------------------------------
 // Purpose: Save the FULL configuration (all driver-wide + per-profile keys)
-//          to a JSON file. Mirrors the union of keys read by
-//          LoadParamsFromJson + LoadProfileFromJson so saved output round-trips
-//          cleanly. Use this for "Save default_config.json".
+//          to a JSON file: every table row, so saved output round-trips
+//          through LoadParamsFromJson + LoadProfileFromJson and stays in
+//          canonical default_config_ order. Use this for "Save
+//          default_config.json".
 //-----------------------------------------------------------------------------
-void JsonManager::SaveFullConfigToJson(const std::string& filename, StereoDisplayDriverConfiguration& config)
+std::shared_future<bool> JsonManager::SaveFullConfigToJson(const std::string& filename, StereoDisplayDriverConfiguration& config)
 {
     nlohmann::ordered_json j;
+    for (const auto& d : schema::kFields) {
+        EmitField(d, config, j);
+    }
+    j["user_settings"] = config.num_user_settings > 0
+        ? EmitUserSettings(config) : default_config_.at("user_settings");
 
-    // Display / output
-    j["display_index"]   = config.display_index;
-    j["output_mode"]     = OutputModeToString(config.output_mode);
-    j["eye_swap"]        = config.eye_swap;
-    j["render_width"]    = config.render_width;
-    j["render_height"]   = config.render_height;
-    j["display_frequency"] = config.display_frequency;
-
-    // HMD pose
-    j["hmd_height"]      = config.hmd_height;
-    j["hmd_x"]           = config.hmd_x;
-    j["hmd_y"]           = config.hmd_y;
-    j["hmd_yaw"]         = config.hmd_yaw;
-
-    // Stereo
-    j["aspect_ratio"]    = config.aspect_ratio;
-    j["fov"]             = config.fov;
-    j["depth"]           = config.depth;
-    j["convergence"]     = config.convergence;
-    j["async_enable"]    = config.async_enable;
-    j["auto_depth_enabled"]          = config.auto_depth_enabled;
-    j["auto_depth_target_disparity"] = config.auto_depth_target_disparity;
-    j["auto_depth_smoothing"]        = config.auto_depth_smoothing;
-
-    // Display-correction shader pass
-    j["shader_enabled"]              = config.shader_enabled;
-    j["shader_lift"]                 = { config.shader_lift[0],  config.shader_lift[1],  config.shader_lift[2]  };
-    j["shader_gamma"]                = { config.shader_gamma[0], config.shader_gamma[1], config.shader_gamma[2] };
-    j["shader_gain"]                 = { config.shader_gain[0],  config.shader_gain[1],  config.shader_gain[2]  };
-    j["shader_curve"]                = config.shader_curve;
-    j["shader_curve_offset_low"]     = config.shader_curve_off_low;
-    j["shader_curve_offset_high"]    = config.shader_curve_off_high;
-    j["shader_curve_offset_both"]    = config.shader_curve_off_both;
-
-    // Misc / system
-    j["disable_hotkeys"] = config.disable_hotkeys;
-    j["dash_enable"]     = config.dash_enable;
-    j["auto_focus"]      = config.auto_focus;
-    j["auto_exit"]       = config.auto_exit;
-    j["hide_cursor"]     = config.hide_cursor;
-    j["lock_cursor"]     = config.lock_cursor;
-    j["stereo_cursor"]   = config.stereo_cursor;
-    j["cursor_depth"]    = config.cursor_depth;
-    j["cursor_size"]     = config.cursor_size;
-
-    // Controller / tracking inputs
-    j["pitch_enable"]    = config.pitch_enable;
-    j["yaw_enable"]      = config.yaw_enable;
-    j["use_open_track"]  = config.use_open_track;
-    j["open_track_port"] = config.open_track_port;
-
-    // Track filter
-    j["use_track_filter"]    = config.use_track_filter;
-    j["trk_flt_rot_sens"]    = config.trk_flt_rot_sens;
-    j["trk_flt_pos_sens"]    = config.trk_flt_pos_sens;
-    j["trk_flt_rot_dz"]      = config.trk_flt_rot_dz;
-    j["trk_flt_pos_dz"]      = config.trk_flt_pos_dz;
-    j["trk_flt_zoom_smooth"] = config.trk_flt_zoom_smooth;
-    j["trk_flt_max_zoom"]    = config.trk_flt_max_zoom;
-
-    // LeiaSR head tracking
-    j["sr_tracking_enabled"]     = config.sr_tracking_enabled;
-    j["sr_filter_pos_mincutoff"] = config.sr_filter_pos_mincutoff;
-    j["sr_filter_pos_beta"]      = config.sr_filter_pos_beta;
-    j["sr_filter_rot_mincutoff"] = config.sr_filter_rot_mincutoff;
-    j["sr_filter_rot_beta"]      = config.sr_filter_rot_beta;
-    j["sr_angle_deadzone_deg"]   = config.sr_angle_deadzone_deg;
-    j["sr_sens_yaw"]             = config.sr_sens_yaw;
-    j["sr_sens_pitch"]           = config.sr_sens_pitch;
-    j["sr_sens_roll"]            = config.sr_sens_roll;
-    j["sr_max_yaw"]              = config.sr_max_yaw;
-    j["sr_max_pitch"]            = config.sr_max_pitch;
-    j["sr_max_roll"]             = config.sr_max_roll;
-    j["sr_track_mode"]           = config.sr_track_mode;
-
-    // Scripting
-    j["launch_script"]   = config.launch_script;
-
-    // Controller key bindings (string form is what the JSON stores)
-    j["pose_reset_key"]  = config.pose_reset_str;
-    j["ctrl_toggle_key"] = config.ctrl_toggle_str;
-    j["ctrl_toggle_type"]= config.ctrl_type_str;
-    j["pitch_radius"]    = config.pitch_radius;
-    j["ctrl_deadzone"]   = config.ctrl_deadzone;
-    j["ctrl_sensitivity"]= config.ctrl_sensitivity;
-
-    // user_settings array — write whatever's live, fall back to defaults if
-    // none configured. Scalar form for single-preset rows, array for cycles.
-    auto writePreset = [](nlohmann::ordered_json& obj, const char* key,
-                          const std::vector<float>& vals) {
-        if (vals.size() == 1) obj[key] = vals[0];
-        else                  obj[key] = vals;
-    };
-    if (config.num_user_settings > 0) {
-        nlohmann::ordered_json arr = nlohmann::ordered_json::array();
-        for (size_t i = 0; i < config.num_user_settings; ++i) {
-            nlohmann::ordered_json u;
-            u["user_load_key"]    = config.user_load_str[i];
-            u["user_key_type"]    = config.user_type_str[i];
-            writePreset(u, "user_depth",       config.user_depth[i]);
-            writePreset(u, "user_convergence", config.user_convergence[i]);
-            writePreset(u, "user_fov",         config.user_fov[i]);
-            arr.push_back(u);
+    return writeJsonToFile(filename, std::move(j));
+}
+
+
+//-----------------------------------------------------------------------------
+// Purpose: Start reporting edits to the files in vrto3dFolder
+//-----------------------------------------------------------------------------
+bool JsonManager::StartProfileWatch()
+{
+    if (vrto3dFolder.empty()) return false;
+    if (!watcher_) {
+        watcher_ = std::make_unique<ProfileWatcher>(vrto3dFolder);
+    }
+    if (!watcher_->Start()) {
+        watcher_.reset();
+        return false;
+    }
+    // Scan after the watch is armed so no change slips between the two.
+    std::lock_guard<std::mutex> lock(index_mutex_);
+    index_->Build(vrto3dFolder);
+    LOG() << "Watching " << vrto3dFolder << " for profile changes";
+    return true;
+}
+
+
+std::vector<std::string> JsonManager::TakeChangedProfiles()
+{
+    std::lock_guard<std::mutex> lock(index_mutex_);
+    syncProfileIndex();
+    return std::exchange(changed_profiles_, {});
+}
+
+
+//-----------------------------------------------------------------------------
+// Purpose: Fold settled watcher events into the profile index. Caller holds
+//          index_mutex_.
+//-----------------------------------------------------------------------------
+void JsonManager::syncProfileIndex()
+{
+    if (!watcher_) return;
+    for (auto& name : watcher_->TakeSettled()) {
+        index_->Refresh(vrto3dFolder, name);
+        if (std::find(changed_profiles_.begin(), changed_profiles_.end(), name) == changed_profiles_.end()) {
+            changed_profiles_.push_back(std::move(name));
         }
-        j["user_settings"] = arr;
-    } else {
-        j["user_settings"] = default_config_.at("user_settings");
+    }
+}
+
+
+// The index is authoritative for `fileName` only while the watch is running
+// and neither we nor an unsettled event have touched the file since. Once the
+// watcher thread has died, every lookup goes back to the disk. Caller holds
+// index_mutex_.
+bool JsonManager::indexTrusted(const std::string& fileName)
+{
+    return watcher_ && watcher_->Running() && index_->Complete() && !index_->IsStale(fileName) &&
+           !watcher_->Pending(fileName);
+}
+
+
+bool JsonManager::HasProfile(const std::string& filename)
+{
+    // Like a load: a save still in the writer's debounce window must count,
+    // and the index could drop its stale mark before the file reaches disk.
+    flushPendingWrite(filename);
+    std::lock_guard<std::mutex> lock(index_mutex_);
+    syncProfileIndex();
+    if (indexTrusted(filename)) {
+        return index_->Find(filename) != nullptr;
+    }
+    return index_->Refresh(vrto3dFolder, filename) != nullptr;
+}
+
+
+//-----------------------------------------------------------------------------
+// Purpose: Reparse one profile over a copy of `live` and list the per-profile
+//          fields that differ. False when there is nothing to apply (no
+//          change, or the file doesn't parse yet).
+//-----------------------------------------------------------------------------
+bool JsonManager::DiffProfile(const std::string& filename, const StereoDisplayDriverConfiguration& live,
+                              ProfileChangeSet& changes)
+{
+    changes = ProfileChangeSet{};
+    changes.file = filename;
+    std::error_code ec;
+    if (!std::filesystem::exists(vrto3dFolder + "/" + filename, ec)) {
+        changes.removed = true;
+        return true;
     }
 
-    // Re-key in canonical default_config_ order so the file stays diff-friendly
-    // and any keys we forgot above get backfilled from the defaults.
-    nlohmann::ordered_json merged = reorderFillJson(j);
-    writeJsonToFile(filename, merged);
+    changes.profile = live;
+    if (!LoadProfileFromJson(filename, changes.profile)) {
+        return false;
+    }
+    for (const auto& d : schema::kFields) {
+        if (InPass(d, LoadPass::Profile) && !FieldEqual(d, live, changes.profile)) {
+            changes.keys.push_back(d.key);
+            changes.groups |= ChangeGroup(d);
+        }
+    }
+    if (!UserRowsEqual(live, changes.profile)) {
+        changes.keys.push_back("user_settings");
+        changes.groups |= kChangeHotkeys;
+    }
+    return !changes.keys.empty();
 }
 
 
+//-----------------------------------------------------------------------------
+// Purpose: Copy just the changed fields into the live configuration. Runtime
+//          state of untouched fields (pose, hotkey cycle) is left alone.
+//-----------------------------------------------------------------------------
+void JsonManager::ApplyProfileChanges(const ProfileChangeSet& changes, StereoDisplayDriverConfiguration& live)
+{
+    for (const char* key : changes.keys) {
+        const size_t idx = schema::FindField(key);
+        if (idx == schema::kFieldCount) {  // "user_settings"
+            CopyUserRows(changes.profile, live);
+            vrto3d::CompileHotkeyTable(live);
+            continue;
+        }
+        CopyField(schema::kFields[idx], changes.profile, live);
+        // As on a full load, the enable flag resets its runtime toggle.
+        const std::string_view k = key;
+        if (k == "pitch_enable") live.pitch_set = live.pitch_enable;
+        if (k == "yaw_enable")   live.yaw_set = live.yaw_enable;
+    }
+    if (!changes.keys.empty()) {
+        LOG() << "Applied " << changes.keys.size() << " changed setting(s) from " << changes.file;
+    }
+}
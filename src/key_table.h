@@ -0,0 +1,358 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+// Internal to key_names.cpp, linux_input.cpp and json_manager.cpp (its cache
+// schema hash): the one table of key codes.
+// Each row gives a VK code's portable name, its legacy "VK_*" spelling and,
+// on Linux, its evdev code; rows without names are VKs only the input
+// backend translates (sided modifiers, OEM punctuation). Every lookup is
+// generated from it at compile time: sorted name indexes (binary search),
+// VK -> name, and the VK <-> evdev arrays, so nothing is built on first use
+// and nothing is allocated.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+#include "vrto3dlib/key_codes.h"
+
+#ifdef __linux__
+#include <linux/input-event-codes.h>
+#define EV(code) code
+#else
+#define EV(code) 0
+#endif
+
+namespace vrto3d::keys::table {
+
+struct KeyRow {
+    int vk;
+    const char* name;    // portable spelling, nullptr = not nameable
+    const char* legacy;  // pre-portable spelling, nullptr = none
+    int ev;              // evdev code, 0 = none (or not Linux)
+};
+
+inline constexpr KeyRow kKeys[] = {
+    {VK_LBUTTON,    "Mouse_Left",       "VK_LMOUSE",    EV(BTN_LEFT)},
+    {VK_RBUTTON,    "Mouse_Right",      "VK_RMOUSE",    EV(BTN_RIGHT)},
+    {VK_MBUTTON,    "Mouse_Middle",     "VK_MMOUSE",    EV(BTN_MIDDLE)},
+    {VK_XBUTTON1,   "Mouse_4",          "VK_MOUSE4",    EV(BTN_SIDE)},
+    {VK_XBUTTON2,   "Mouse_5",          "VK_MOUSE5",    EV(BTN_EXTRA)},
+    {VK_BACK,       "Key_Backspace",    "VK_BACKSPACE", EV(KEY_BACKSPACE)},
+    {VK_TAB,        "Key_Tab",          "VK_TAB",       EV(KEY_TAB)},
+    {VK_RETURN,     "Key_Enter",        "VK_RETURN",    EV(KEY_ENTER)},
+    {VK_SHIFT,      "Key_Shift",        "VK_SHIFT",     0},
+    {VK_CONTROL,    "Key_Ctrl",         "VK_CONTROL",   0},
+    {VK_MENU,       "Key_Alt",          "VK_MENU",      0},
+    {VK_PAUSE,      "Key_Pause",        "VK_PAUSE",     EV(KEY_PAUSE)},
+    {VK_CAPITAL,    "Key_CapsLock",     "VK_CAPS",      EV(KEY_CAPSLOCK)},
+    {VK_ESCAPE,     "Key_Escape",       "VK_ESCAPE",    EV(KEY_ESC)},
+    {VK_SPACE,      "Key_Space",        "VK_SPACE",     EV(KEY_SPACE)},
+    {VK_PRIOR,      "Key_PageUp",       "VK_PGUP",      EV(KEY_PAGEUP)},
+    {VK_NEXT,       "Key_PageDown",     "VK_PGDWN",     EV(KEY_PAGEDOWN)},
+    {VK_END,        "Key_End",          "VK_END",       EV(KEY_END)},
+    {VK_HOME,       "Key_Home",         "VK_HOME",      EV(KEY_HOME)},
+    {VK_LEFT,       "Key_Left",         "VK_LEFT",      EV(KEY_LEFT)},
+    {VK_UP,         "Key_Up",           "VK_UP",        EV(KEY_UP)},
+    {VK_RIGHT,      "Key_Right",        "VK_RIGHT",     EV(KEY_RIGHT)},
+    {VK_DOWN,       "Key_Down",         "VK_DOWN",      EV(KEY_DOWN)},
+    {VK_SNAPSHOT,   "Key_PrintScreen",  "VK_SNAPSHOT",  EV(KEY_SYSRQ)},
+    {VK_INSERT,     "Key_Insert",       "VK_INSERT",    EV(KEY_INSERT)},
+    {VK_DELETE,     "Key_Delete",       "VK_DELETE",    EV(KEY_DELETE)},
+    {'0',           "Key_0",            "VK_0",         EV(KEY_0)},
+    {'1',           "Key_1",            "VK_1",         EV(KEY_1)},
+    {'2',           "Key_2",            "VK_2",         EV(KEY_2)},
+    {'3',           "Key_3",            "VK_3",         EV(KEY_3)},
+    {'4',           "Key_4",            "VK_4",         EV(KEY_4)},
+    {'5',           "Key_5",            "VK_5",         EV(KEY_5)},
+    {'6',           "Key_6",            "VK_6",         EV(KEY_6)},
+    {'7',           "Key_7",            "VK_7",         EV(KEY_7)},
+    {'8',           "Key_8",            "VK_8",         EV(KEY_8)},
+    {'9',           "Key_9",            "VK_9",         EV(KEY_9)},
+    {'A',           "Key_A",            "VK_A",         EV(KEY_A)},
+    {'B',           "Key_B",            "VK_B",         EV(KEY_B)},
+    {'C',           "Key_C",            "VK_C",         EV(KEY_C)},
+    {'D',           "Key_D",            "VK_D",         EV(KEY_D)},
+    {'E',           "Key_E",            "VK_E",         EV(KEY_E)},
+    {'F',           "Key_F",            "VK_F",         EV(KEY_F)},
+    {'G',           "Key_G",            "VK_G",         EV(KEY_G)},
+    {'H',           "Key_H",            "VK_H",         EV(KEY_H)},
+    {'I',           "Key_I",            "VK_I",         EV(KEY_I)},
+    {'J',           "Key_J",            "VK_J",         EV(KEY_J)},
+    {'K',           "Key_K",            "VK_K",         EV(KEY_K)},
+    {'L',           "Key_L",            "VK_L",         EV(KEY_L)},
+    {'M',           "Key_M",            "VK_M",         EV(KEY_M)},
+    {'N',           "Key_N",            "VK_N",         EV(KEY_N)},
+    {'O',           "Key_O",            "VK_O",         EV(KEY_O)},
+    {'P',           "Key_P",            "VK_P",         EV(KEY_P)},
+    {'Q',           "Key_Q",            "VK_Q",         EV(KEY_Q)},
+    {'R',           "Key_R",            "VK_R",         EV(KEY_R)},
+    {'S',           "Key_S",            "VK_S",         EV(KEY_S)},
+    {'T',           "Key_T",            "VK_T",         EV(KEY_T)},
+    {'U',           "Key_U",            "VK_U",         EV(KEY_U)},
+    {'V',           "Key_V",            "VK_V",         EV(KEY_V)},
+    {'W',           "Key_W",            "VK_W",         EV(KEY_W)},
+    {'X',           "Key_X",            "VK_X",         EV(KEY_X)},
+    {'Y',           "Key_Y",            "VK_Y",         EV(KEY_Y)},
+    {'Z',           "Key_Z",            "VK_Z",         EV(KEY_Z)},
+    {VK_LWIN,       nullptr,            nullptr,        EV(KEY_LEFTMETA)},
+    {VK_RWIN,       nullptr,            nullptr,        EV(KEY_RIGHTMETA)},
+    {VK_NUMPAD0,    "Numpad0",          "VK_NUMPAD0",   EV(KEY_KP0)},
+    {VK_NUMPAD1,    "Numpad1",          "VK_NUMPAD1",   EV(KEY_KP1)},
+    {VK_NUMPAD2,    "Numpad2",          "VK_NUMPAD2",   EV(KEY_KP2)},
+    {VK_NUMPAD3,    "Numpad3",          "VK_NUMPAD3",   EV(KEY_KP3)},
+    {VK_NUMPAD4,    "Numpad4",          "VK_NUMPAD4",   EV(KEY_KP4)},
+    {VK_NUMPAD5,    "Numpad5",          "VK_NUMPAD5",   EV(KEY_KP5)},
+    {VK_NUMPAD6,    "Numpad6",          "VK_NUMPAD6",   EV(KEY_KP6)},
+    {VK_NUMPAD7,    "Numpad7",          "VK_NUMPAD7",   EV(KEY_KP7)},
+    {VK_NUMPAD8,    "Numpad8",          "VK_NUMPAD8",   EV(KEY_KP8)},
+    {VK_NUMPAD9,    "Numpad9",          "VK_NUMPAD9",   EV(KEY_KP9)},
+    {VK_MULTIPLY,   "NumpadMultiply",   "VK_MULTIPLY",  EV(KEY_KPASTERISK)},
+    {VK_ADD,        "NumpadAdd",        "VK_ADD",       EV(KEY_KPPLUS)},
+    {VK_SUBTRACT,   "NumpadSubtract",   "VK_SUBTRACT",  EV(KEY_KPMINUS)},
+    {VK_DECIMAL,    "NumpadDecimal",    "VK_DECIMAL",   EV(KEY_KPDOT)},
+    {VK_DIVIDE,     "NumpadDivide",     "VK_DIVIDE",    EV(KEY_KPSLASH)},
+    {VK_F1,         "Key_F1",           "VK_F1",        EV(KEY_F1)},
+    {VK_F2,         "Key_F2",           "VK_F2",        EV(KEY_F2)},
+    {VK_F3,         "Key_F3",           "VK_F3",        EV(KEY_F3)},
+    {VK_F4,         "Key_F4",           "VK_F4",        EV(KEY_F4)},
+    {VK_F5,         "Key_F5",           "VK_F5",        EV(KEY_F5)},
+    {VK_F6,         "Key_F6",           "VK_F6",        EV(KEY_F6)},
+    {VK_F7,         "Key_F7",           "VK_F7",        EV(KEY_F7)},
+    {VK_F8,         "Key_F8",           "VK_F8",        EV(KEY_F8)},
+    {VK_F9,         "Key_F9",           "VK_F9",        EV(KEY_F9)},
+    {VK_F10,        "Key_F10",          "VK_F10",       EV(KEY_F10)},
+    {VK_F11,        "Key_F11",          "VK_F11",       EV(KEY_F11)},
+    {VK_F12,        "Key_F12",          "VK_F12",       EV(KEY_F12)},
+    {VK_F13,        "Key_F13",          "VK_F13",       EV(KEY_F13)},
+    {VK_F14,        "Key_F14",          "VK_F14",       EV(KEY_F14)},
+    {VK_F15,        "Key_F15",          "VK_F15",       EV(KEY_F15)},
+    {VK_F16,        "Key_F16",          "VK_F16",       EV(KEY_F16)},
+    {VK_F17,        "Key_F17",          "VK_F17",       EV(KEY_F17)},
+    {VK_F18,        "Key_F18",          "VK_F18",       EV(KEY_F18)},
+    {VK_F19,        "Key_F19",          "VK_F19",       EV(KEY_F19)},
+    {VK_F20,        "Key_F20",          "VK_F20",       EV(KEY_F20)},
+    {VK_F21,        "Key_F21",          "VK_F21",       EV(KEY_F21)},
+    {VK_F22,        "Key_F22",          "VK_F22",       EV(KEY_F22)},
+    {VK_F23,        "Key_F23",          "VK_F23",       EV(KEY_F23)},
+    {VK_F24,        "Key_F24",          "VK_F24",       EV(KEY_F24)},
+    {VK_LSHIFT,     nullptr,            nullptr,        EV(KEY_LEFTSHIFT)},
+    {VK_RSHIFT,     nullptr,            nullptr,        EV(KEY_RIGHTSHIFT)},
+    {VK_LCONTROL,   nullptr,            nullptr,        EV(KEY_LEFTCTRL)},
+    {VK_RCONTROL,   nullptr,            nullptr,        EV(KEY_RIGHTCTRL)},
+    {VK_LMENU,      nullptr,            nullptr,        EV(KEY_LEFTALT)},
+    {VK_RMENU,      nullptr,            nullptr,        EV(KEY_RIGHTALT)},
+    {VK_OEM_1,      nullptr,            nullptr,        EV(KEY_SEMICOLON)},
+    {VK_OEM_PLUS,   "Key_Equals",       "VK_OEM_PLUS",  EV(KEY_EQUAL)},
+    {VK_OEM_COMMA,  nullptr,            nullptr,        EV(KEY_COMMA)},
+    {VK_OEM_MINUS,  "Key_Minus",        "VK_OEM_MINUS", EV(KEY_MINUS)},
+    {VK_OEM_PERIOD, nullptr,            nullptr,        EV(KEY_DOT)},
+    {VK_OEM_2,      nullptr,            nullptr,        EV(KEY_SLASH)},
+    {VK_OEM_3,      nullptr,            nullptr,        EV(KEY_GRAVE)},
+    {VK_OEM_4,      "Key_LeftBracket",  "VK_LBRACKET",  EV(KEY_LEFTBRACE)},
+    {VK_OEM_5,      nullptr,            nullptr,        EV(KEY_BACKSLASH)},
+    {VK_OEM_6,      "Key_RightBracket", "VK_RBRACKET",  EV(KEY_RIGHTBRACE)},
+    {VK_OEM_7,      nullptr,            nullptr,        EV(KEY_APOSTROPHE)},
+};
+
+struct PadRow {
+    int bits;
+    const char* name;
+    const char* legacy;
+};
+
+inline constexpr PadRow kPads[] = {
+    {XINPUT_GAMEPAD_A,              "Pad_A",         "XINPUT_GAMEPAD_A"},
+    {XINPUT_GAMEPAD_B,              "Pad_B",         "XINPUT_GAMEPAD_B"},
+    {XINPUT_GAMEPAD_X,              "Pad_X",         "XINPUT_GAMEPAD_X"},
+    {XINPUT_GAMEPAD_Y,              "Pad_Y",         "XINPUT_GAMEPAD_Y"},
+    {XINPUT_GAMEPAD_LEFT_SHOULDER,  "Pad_LB",        "XINPUT_GAMEPAD_LEFT_SHOULDER"},
+    {XINPUT_GAMEPAD_RIGHT_SHOULDER, "Pad_RB",        "XINPUT_GAMEPAD_RIGHT_SHOULDER"},
+    {XINPUT_GAMEPAD_LEFT_TRIGGER,   "Pad_LT",        "XINPUT_GAMEPAD_LEFT_TRIGGER"},
+    {XINPUT_GAMEPAD_RIGHT_TRIGGER,  "Pad_RT",        "XINPUT_GAMEPAD_RIGHT_TRIGGER"},
+    {XINPUT_GAMEPAD_START,          "Pad_Start",     "XINPUT_GAMEPAD_START"},
+    {XINPUT_GAMEPAD_BACK,           "Pad_Back",      "XINPUT_GAMEPAD_BACK"},
+    {XINPUT_GAMEPAD_GUIDE,          "Pad_Guide",     "XINPUT_GAMEPAD_GUIDE"},
+    {XINPUT_GAMEPAD_LEFT_THUMB,     "Pad_LS",        "XINPUT_GAMEPAD_LEFT_THUMB"},
+    {XINPUT_GAMEPAD_RIGHT_THUMB,    "Pad_RS",        "XINPUT_GAMEPAD_RIGHT_THUMB"},
+    {XINPUT_GAMEPAD_DPAD_UP,        "Pad_DPadUp",    "XINPUT_GAMEPAD_DPAD_UP"},
+    {XINPUT_GAMEPAD_DPAD_DOWN,      "Pad_DPadDown",  "XINPUT_GAMEPAD_DPAD_DOWN"},
+    {XINPUT_GAMEPAD_DPAD_LEFT,      "Pad_DPadLeft",  "XINPUT_GAMEPAD_DPAD_LEFT"},
+    {XINPUT_GAMEPAD_DPAD_RIGHT,     "Pad_DPadRight", "XINPUT_GAMEPAD_DPAD_RIGHT"},
+};
+
+#undef EV
+
+struct NameEntry {
+    std::string_view name;
+    int code;
+};
+
+template <typename Row, size_t N>
+constexpr size_t CountNames(const Row (&rows)[N])
+{
+    size_t n = 0;
+    for (const Row& row : rows) {
+        n += (row.name ? 1 : 0) + (row.legacy ? 1 : 0);
+    }
+    return n;
+}
+
+template <typename Row>
+constexpr int CodeOf(const Row& row)
+{
+    if constexpr (std::is_same_v<Row, KeyRow>) {
+        return row.vk;
+    } else {
+        return row.bits;
+    }
+}
+
+// Portable and legacy spellings of every row, sorted by name. The two
+// vocabularies are disjoint, so one index serves both.
+template <size_t Count, typename Row, size_t N>
+constexpr std::array<NameEntry, Count> SortedNames(const Row (&rows)[N])
+{
+    std::array<NameEntry, Count> out{};
+    size_t n = 0;
+    for (const Row& row : rows) {
+        if (row.name) out[n++] = {row.name, CodeOf(row)};
+        if (row.legacy) out[n++] = {row.legacy, CodeOf(row)};
+    }
+    for (size_t i = 1; i < n; ++i) {  // insertion sort: constexpr in C++17
+        const NameEntry e = out[i];
+        size_t j = i;
+        for (; j > 0 && e.name < out[j - 1].name; --j) {
+            out[j] = out[j - 1];
+        }
+        out[j] = e;
+    }
+    return out;
+}
+
+template <size_t Count>
+constexpr bool NamesUnique(const std::array<NameEntry, Count>& names)
+{
+    for (size_t i = 1; i < Count; ++i) {
+        if (names[i].name == names[i - 1].name) return false;
+    }
+    return true;
+}
+
+inline constexpr auto kKeyNames = SortedNames<CountNames(kKeys)>(kKeys);
+inline constexpr auto kPadNames = SortedNames<CountNames(kPads)>(kPads);
+static_assert(NamesUnique(kKeyNames), "duplicate key name in kKeys");
+static_assert(NamesUnique(kPadNames), "duplicate pad name in kPads");
+
+// Code for `name`, -1 if unknown.
+template <size_t Count>
+constexpr int Find(const std::array<NameEntry, Count>& names, std::string_view name)
+{
+    size_t lo = 0;
+    size_t hi = Count;
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (names[mid].name < name) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo < Count && names[lo].name == name ? names[lo].code : -1;
+}
+
+// VK -> portable name (nullptr = none).
+constexpr std::array<const char*, 256> BuildKeyNameByVk()
+{
+    std::array<const char*, 256> out{};
+    for (const KeyRow& row : kKeys) {
+        if (row.name && row.vk >= 0 && row.vk < 256) out[row.vk] = row.name;
+    }
+    return out;
+}
+
+inline constexpr auto kKeyNameByVk = BuildKeyNameByVk();
+
+static_assert(Find(kKeyNames, "Key_A") == 'A' && Find(kKeyNames, "VK_PGDWN") == VK_NEXT &&
+              Find(kKeyNames, "Pad_A") == -1, "key name index");
+
+// FNV-1a over every row of both tables (codes and spellings). The profile
+// cache stores codes already parsed from bind names and mixes this into its
+// schema hash, so any edit to the tables invalidates old caches.
+constexpr uint64_t HashTables()
+{
+    uint64_t h = 14695981039346656037ull;
+    auto mix_int = [&h](int v) {
+        for (int i = 0; i < 4; ++i) {
+            h ^= static_cast<uint8_t>(static_cast<uint32_t>(v) >> (8 * i));
+            h *= 1099511628211ull;
+        }
+    };
+    auto mix_str = [&h](const char* s) {
+        for (; s && *s; ++s) {
+            h ^= static_cast<uint8_t>(*s);
+            h *= 1099511628211ull;
+        }
+        h ^= 0xff;  // terminator, so nullptr and "" differ from adjacent text
+        h *= 1099511628211ull;
+    };
+    for (const KeyRow& row : kKeys) {
+        mix_int(row.vk);
+        mix_str(row.name);
+        mix_str(row.legacy);
+        mix_int(row.ev);
+    }
+    for (const PadRow& row : kPads) {
+        mix_int(row.bits);
+        mix_str(row.name);
+        mix_str(row.legacy);
+    }
+    return h;
+}
+
+inline constexpr uint64_t kTablesHash = HashTables();
+
+#ifdef __linux__
+constexpr std::array<int, 256> BuildVkToEv()
+{
+    std::array<int, 256> out{};  // 0 = no single-code mapping
+    for (const KeyRow& row : kKeys) {
+        if (row.ev > 0 && row.vk >= 0 && row.vk < 256) out[row.vk] = row.ev;
+    }
+    return out;
+}
+
+constexpr std::array<int, KEY_CNT> BuildEvToVk()
+{
+    std::array<int, KEY_CNT> out{};  // 0 = no VK; the first row for a code wins
+    for (const KeyRow& row : kKeys) {
+        if (row.ev > 0 && row.ev < KEY_CNT && out[row.ev] == 0) out[row.ev] = row.vk;
+    }
+    return out;
+}
+
+inline constexpr auto kVkToEv = BuildVkToEv();
+inline constexpr auto kEvToVk = BuildEvToVk();
+
+static_assert(kVkToEv['Q'] == KEY_Q && kEvToVk[KEY_LEFTSHIFT] == VK_LSHIFT &&
+              kEvToVk[BTN_EXTRA] == VK_XBUTTON2, "VK <-> evdev translation");
+#endif  // __linux__
+
+}  // namespace vrto3d::keys::table
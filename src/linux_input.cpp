@@ -20,13 +20,20 @@
 // The driver runs inside vrserver while the game window has focus, so input
 // must be read globally: one reader thread epolls every usable
 // /dev/input/event* device (plus an inotify watch on /dev/input for
-// hotplug) and folds events into a shared snapshot that the API functions
-// read under a mutex. Requires membership in the `input` group.
+// hotplug) and folds events into shared state under a mutex. The
+// level-triggered getters (IsKeyDown, GetGamepadState, GetMouseState) never
+// take that mutex: the reader thread republishes the merged key bitset,
+// gamepad and cursor through atomics as it applies events. Requires
+// membership in the `input` group.
 
 #ifdef __linux__
 
+#include "vrto3dlib/input_latency.hpp"
 #include "vrto3dlib/input_state.h"
 #include "vrto3dlib/key_codes.h"
+#include "vrto3dlib/trace.hpp"
+#include "input_ring.h"
+#include "key_table.h"
 
 #include <algorithm>
 #include <array>
@@ -36,6 +43,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <ctime>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -45,7 +53,9 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <linux/input.h>
+#include <poll.h>
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/inotify.h>
 #include <sys/ioctl.h>
 #include <unistd.h>
@@ -76,111 +86,6 @@ bool TestBit(const unsigned long* bits, unsigned int bit)
     return (bits[bit / kLongBits] >> (bit % kLongBits)) & 1ul;
 }
 
-// Evdev letter-key codes indexed by (letter - 'A'). KEY_A..KEY_Z are laid
-// out by physical QWERTY position, not alphabetically, so an explicit table
-// is required for the VK <-> evdev translation and keyboard classification.
-constexpr int kLetterKeys[26] = {
-    KEY_A, KEY_B, KEY_C, KEY_D, KEY_E, KEY_F, KEY_G, KEY_H, KEY_I,
-    KEY_J, KEY_K, KEY_L, KEY_M, KEY_N, KEY_O, KEY_P, KEY_Q, KEY_R,
-    KEY_S, KEY_T, KEY_U, KEY_V, KEY_W, KEY_X, KEY_Y, KEY_Z,
-};
-
-//-----------------------------------------------------------------------------
-// Purpose: VK <-> evdev translation tables, built once
-//-----------------------------------------------------------------------------
-struct VkTables {
-    int vk_to_ev[256] = {};      // 0 = no single-code mapping
-    int ev_to_vk[KEY_CNT] = {};  // 0 = no VK
-
-    void Map(int vk, int ev)
-    {
-        if (vk >= 0 && vk < 256) {
-            vk_to_ev[vk] = ev;
-        }
-        if (ev > 0 && ev < KEY_CNT && ev_to_vk[ev] == 0) {
-            ev_to_vk[ev] = vk;
-        }
-    }
-
-    VkTables()
-    {
-        constexpr int digit_keys[10] = {
-            KEY_0, KEY_1, KEY_2, KEY_3, KEY_4,
-            KEY_5, KEY_6, KEY_7, KEY_8, KEY_9,
-        };
-        constexpr int fn_keys[24] = {
-            KEY_F1,  KEY_F2,  KEY_F3,  KEY_F4,  KEY_F5,  KEY_F6,
-            KEY_F7,  KEY_F8,  KEY_F9,  KEY_F10, KEY_F11, KEY_F12,
-            KEY_F13, KEY_F14, KEY_F15, KEY_F16, KEY_F17, KEY_F18,
-            KEY_F19, KEY_F20, KEY_F21, KEY_F22, KEY_F23, KEY_F24,
-        };
-        constexpr int kp_keys[10] = {
-            KEY_KP0, KEY_KP1, KEY_KP2, KEY_KP3, KEY_KP4,
-            KEY_KP5, KEY_KP6, KEY_KP7, KEY_KP8, KEY_KP9,
-        };
-        for (int i = 0; i < 26; ++i) Map('A' + i, kLetterKeys[i]);
-        for (int i = 0; i < 10; ++i) Map('0' + i, digit_keys[i]);
-        for (int i = 0; i < 24; ++i) Map(VK_F1 + i, fn_keys[i]);
-        for (int i = 0; i < 10; ++i) Map(VK_NUMPAD0 + i, kp_keys[i]);
-        Map(VK_MULTIPLY, KEY_KPASTERISK);
-        Map(VK_ADD, KEY_KPPLUS);
-        Map(VK_SUBTRACT, KEY_KPMINUS);
-        Map(VK_DECIMAL, KEY_KPDOT);
-        Map(VK_DIVIDE, KEY_KPSLASH);
-        Map(VK_BACK, KEY_BACKSPACE);
-        Map(VK_TAB, KEY_TAB);
-        Map(VK_RETURN, KEY_ENTER);
-        Map(VK_PAUSE, KEY_PAUSE);
-        Map(VK_CAPITAL, KEY_CAPSLOCK);
-        Map(VK_ESCAPE, KEY_ESC);
-        Map(VK_SPACE, KEY_SPACE);
-        Map(VK_PRIOR, KEY_PAGEUP);
-        Map(VK_NEXT, KEY_PAGEDOWN);
-        Map(VK_END, KEY_END);
-        Map(VK_HOME, KEY_HOME);
-        Map(VK_LEFT, KEY_LEFT);
-        Map(VK_UP, KEY_UP);
-        Map(VK_RIGHT, KEY_RIGHT);
-        Map(VK_DOWN, KEY_DOWN);
-        Map(VK_SNAPSHOT, KEY_SYSRQ);  // PrintScreen
-        Map(VK_INSERT, KEY_INSERT);
-        Map(VK_DELETE, KEY_DELETE);
-        // Sided modifiers; generic VK_SHIFT/CONTROL/MENU check both sides
-        // in IsKeyDown, and the reverse table reports the sided VK.
-        Map(VK_LSHIFT, KEY_LEFTSHIFT);
-        Map(VK_RSHIFT, KEY_RIGHTSHIFT);
-        Map(VK_LCONTROL, KEY_LEFTCTRL);
-        Map(VK_RCONTROL, KEY_RIGHTCTRL);
-        Map(VK_LMENU, KEY_LEFTALT);
-        Map(VK_RMENU, KEY_RIGHTALT);
-        Map(VK_LWIN, KEY_LEFTMETA);
-        Map(VK_RWIN, KEY_RIGHTMETA);
-        Map(VK_OEM_MINUS, KEY_MINUS);
-        Map(VK_OEM_PLUS, KEY_EQUAL);
-        Map(VK_OEM_4, KEY_LEFTBRACE);
-        Map(VK_OEM_6, KEY_RIGHTBRACE);
-        Map(VK_OEM_1, KEY_SEMICOLON);
-        Map(VK_OEM_2, KEY_SLASH);
-        Map(VK_OEM_3, KEY_GRAVE);
-        Map(VK_OEM_5, KEY_BACKSLASH);
-        Map(VK_OEM_7, KEY_APOSTROPHE);
-        Map(VK_OEM_COMMA, KEY_COMMA);
-        Map(VK_OEM_PERIOD, KEY_DOT);
-        // Mouse buttons are EV_KEY codes too.
-        Map(VK_LBUTTON, BTN_LEFT);
-        Map(VK_RBUTTON, BTN_RIGHT);
-        Map(VK_MBUTTON, BTN_MIDDLE);
-        Map(VK_XBUTTON1, BTN_SIDE);
-        Map(VK_XBUTTON2, BTN_EXTRA);
-    }
-};
-
-const VkTables& Tables()
-{
-    static const VkTables tables;
-    return tables;
-}
-
 //-----------------------------------------------------------------------------
 // Purpose: xpad-convention gamepad button -> XINPUT_GAMEPAD_* bit
 //-----------------------------------------------------------------------------
@@ -241,12 +146,24 @@ struct Device {
     bool is_keyboard = false;
     bool is_mouse = false;
     bool is_gamepad = false;
+    bool kernel_clock = false;  // EVIOCSCLOCKID(CLOCK_MONOTONIC) took
+    bool syn_dropped = false;   // kernel buffer overran: skip to SYN_REPORT, resync
+    uint32_t classes = 0;       // DeviceClass bits as probed, before allow/deny
     std::bitset<KEY_CNT> keys;  // per-device, so removal releases held keys
     GamepadState pad;           // valid when is_gamepad
+    int pad_slot = -1;          // GetPadState() slot, -1 = none free at connect
+    uint64_t pad_ns = 0;        // newest pad event of this device
+    std::string name;           // EVIOCGNAME
     std::array<AxisRange, ABS_CNT> abs{};
-};
 
-constexpr int kMaxKeyEvents = 256;
+    // Motion not applied yet (InputOptions::coalesce_motion).
+    int32_t rel_x = 0;
+    int32_t rel_y = 0;
+    int32_t rel_wheel = 0;
+    uint64_t abs_dirty = 0;     // bit per ABS code; ABS_CNT == 64
+    std::array<int32_t, ABS_CNT> abs_pending{};
+};
+static_assert(ABS_CNT <= 64, "abs_dirty needs one bit per ABS code");
 
 struct Shared {
     std::mutex mutex;
@@ -264,14 +181,19 @@ struct Shared {
     int32_t mouse_y = 0;
     int32_t region_w = 0;
     int32_t region_h = 0;
-    int32_t wheel = 0;
 
-    // Edge-event ring buffer for the OSD input pump.
-    KeyEvent events[kMaxKeyEvents];
-    int ev_tail = 0;
-    int ev_count = 0;
+    // Timestamps (InputClockNs): the event being applied, the newest key or
+    // pad-button edge, and the newest pad / mouse event.
+    uint64_t event_ns = 0;
+    uint64_t edge_ns = 0;
+    uint64_t pad_ns = 0;
+    uint64_t mouse_ns = 0;
+    uint32_t pad_edge_buttons = 0;  // XInputButtons() view at the last edge
+    // Per slot: packed state last pushed into pub.pad_slots.
+    std::array<std::array<uint64_t, 2>, kMaxPads> pad_slot_last{};
 
-    std::string typed;  // pending UTF-8 text
+    // Edge events and typed UTF-8 for the OSD input pump (lock-free).
+    detail::EdgeQueues queues;
 
     // xkbcommon (null when init failed: typed text silently disabled).
     xkb_context* xkb_ctx = nullptr;
@@ -281,6 +203,76 @@ struct Shared {
 
 Shared g;
 
+//-----------------------------------------------------------------------------
+// Purpose: Lock-free view read by the level-triggered getters. Written only
+//          with g.mutex held, so there is a single writer at any time.
+//-----------------------------------------------------------------------------
+constexpr size_t kPressedWords = (KEY_CNT + 63) / 64;
+
+struct Published {
+    // Mirror of g.pressed; a single key test is one relaxed word load.
+    std::array<std::atomic<uint64_t>, kPressedWords> pressed{};
+
+    std::atomic<uint64_t> mouse_xy{0};  // x in the low half, y in the high half
+    std::atomic<int32_t> wheel{0};      // detents since last GetMouseState
+
+    // Multi-word state is published under one seqlock so Snapshot() sees the
+    // VK bitset, pad and cursor from a single point in the event stream.
+    detail::SeqLock seq;
+    std::array<std::atomic<uint64_t>, 4> vk{};  // VK-indexed, incl. generic modifiers
+    std::atomic<uint64_t> pad_buttons{0};  // connected | wButtons<<8 | LT<<24 | RT<<32
+    std::atomic<uint64_t> pad_sticks{0};   // LX | LY<<16 | RX<<32 | RY<<48
+    std::atomic<uint64_t> edge_ns{0};
+    std::atomic<uint64_t> pad_ns{0};
+    std::atomic<uint64_t> mouse_ns{0};
+
+    // Per-slot pad reports; the merged pad_* words above derive from them.
+    std::array<PadHistory, kMaxPads> pad_slots;
+    std::atomic<uint32_t> pad_slot_mask{0};
+};
+
+Published pub;
+
+void SetVkBit(int vk, bool down)
+{
+    const uint64_t bit = 1ull << (vk % 64);
+    if (down) {
+        pub.vk[vk / 64].fetch_or(bit, std::memory_order_relaxed);
+    } else {
+        pub.vk[vk / 64].fetch_and(~bit, std::memory_order_relaxed);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Mirror a merged key change into the VK bitset, keeping the
+//          generic VK_SHIFT/CONTROL/MENU bits equal to "either side down"
+//-----------------------------------------------------------------------------
+void PublishVkLocked(uint16_t code)
+{
+    const int vk = keys::table::kEvToVk[code];
+    if (vk <= 0 || vk >= 256) {
+        return;
+    }
+    g.edge_ns = g.event_ns;
+    pub.seq.Begin();
+    pub.edge_ns.store(g.edge_ns, std::memory_order_relaxed);
+    SetVkBit(vk, g.pressed[code]);
+    switch (vk) {
+        case VK_LSHIFT: case VK_RSHIFT:
+            SetVkBit(VK_SHIFT, g.pressed[KEY_LEFTSHIFT] || g.pressed[KEY_RIGHTSHIFT]);
+            break;
+        case VK_LCONTROL: case VK_RCONTROL:
+            SetVkBit(VK_CONTROL, g.pressed[KEY_LEFTCTRL] || g.pressed[KEY_RIGHTCTRL]);
+            break;
+        case VK_LMENU: case VK_RMENU:
+            SetVkBit(VK_MENU, g.pressed[KEY_LEFTALT] || g.pressed[KEY_RIGHTALT]);
+            break;
+        default:
+            break;
+    }
+    pub.seq.End();
+}
+
 std::mutex g_lifecycle_mutex;
 bool g_started = false;
 std::thread g_thread;
@@ -289,21 +281,25 @@ std::atomic<bool> g_have_keyboard{false};
 
 int g_epoll_fd = -1;
 int g_inotify_fd = -1;
+int g_wake_fd = -1;     // eventfd: Stop() wakes the reader immediately
+
+// InputOptions, read by the reader thread and the device probe.
+std::atomic<bool> g_coalesce_motion{true};
+std::atomic<int32_t> g_max_rate_hz{0};
+std::atomic<uint32_t> g_allow_classes{kDeviceAll};
+std::atomic<uint32_t> g_deny_classes{kDeviceTouchpad | kDeviceSensor};
 
 //-----------------------------------------------------------------------------
-// Purpose: Push an edge event, dropping the oldest when the ring is full
+// Purpose: Push an edge event; counted as dropped when the OSD falls behind
 //-----------------------------------------------------------------------------
 void PushEventLocked(uint16_t code, bool down)
 {
-    if (g.ev_count == kMaxKeyEvents) {
-        g.ev_tail = (g.ev_tail + 1) % kMaxKeyEvents;
-        --g.ev_count;
-    }
-    KeyEvent& e = g.events[(g.ev_tail + g.ev_count) % kMaxKeyEvents];
-    e.vk = Tables().ev_to_vk[code];
+    KeyEvent e;
+    e.vk = keys::table::kEvToVk[code];
     e.evdev_code = code;
     e.down = down;
-    ++g.ev_count;
+    e.time_ns = g.event_ns;
+    g.queues.PushEvent(e);
 }
 
 //-----------------------------------------------------------------------------
@@ -325,9 +321,7 @@ void AppendTypedLocked(uint16_t code)
     if (n == 1 && (static_cast<unsigned char>(buf[0]) < 0x20 || buf[0] == 0x7F)) {
         return;
     }
-    if (g.typed.size() < 4096) {
-        g.typed.append(buf, n);
-    }
+    g.queues.PushText(buf, static_cast<size_t>(n));
 }
 
 //-----------------------------------------------------------------------------
@@ -370,6 +364,8 @@ void HandleKeyLocked(Device& dev, uint16_t code, int32_t value, bool emit)
         dev.keys[code] = true;
         if (g.key_count[code]++ == 0) {
             g.pressed[code] = true;
+            pub.pressed[code / 64].fetch_or(1ull << (code % 64), std::memory_order_release);
+            PublishVkLocked(code);
             if (emit) {
                 PushEventLocked(code, true);
             }
@@ -387,6 +383,8 @@ void HandleKeyLocked(Device& dev, uint16_t code, int32_t value, bool emit)
         dev.keys[code] = false;
         if (g.key_count[code] > 0 && --g.key_count[code] == 0) {
             g.pressed[code] = false;
+            pub.pressed[code / 64].fetch_and(~(1ull << (code % 64)), std::memory_order_release);
+            PublishVkLocked(code);
             if (emit) {
                 PushEventLocked(code, false);
             }
@@ -407,7 +405,7 @@ void HandleRelLocked(uint16_t code, int32_t value)
             g.mouse_y = std::clamp(g.mouse_y + value, 0, std::max(0, g.region_h - 1));
             break;
         case REL_WHEEL:
-            g.wheel += value;
+            pub.wheel.fetch_add(value, std::memory_order_relaxed);
             break;
         default:
             break;
@@ -461,8 +459,133 @@ void HandleAbsLocked(Device& dev, uint16_t code, int32_t value)
     }
 }
 
+void PublishMouseLocked()
+{
+    const uint64_t xy = static_cast<uint32_t>(g.mouse_x) |
+                        (static_cast<uint64_t>(static_cast<uint32_t>(g.mouse_y)) << 32);
+    pub.seq.Begin();
+    pub.mouse_xy.store(xy, std::memory_order_relaxed);
+    pub.mouse_ns.store(g.mouse_ns, std::memory_order_relaxed);
+    pub.seq.End();
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Push each pad slot's state into its history when it changed; an
+//          emptied slot gets one disconnected report
+//-----------------------------------------------------------------------------
+void PublishPadSlotsLocked()
+{
+    uint32_t mask = 0;
+    for (int slot = 0; slot < kMaxPads; ++slot) {
+        const Device* owner = nullptr;
+        for (const Device& dev : g.devices) {
+            if (dev.is_gamepad && dev.pad_slot == slot) {
+                owner = &dev;
+                break;
+            }
+        }
+        GamepadState state;
+        if (owner) {
+            state = owner->pad;
+            state.connected = true;
+            state.time_ns = owner->pad_ns ? owner->pad_ns : g.event_ns;
+            mask |= 1u << slot;
+        } else {
+            state.time_ns = g.event_ns;
+        }
+        const std::array<uint64_t, 2> packed = {
+            detail::PackPadButtons(state), detail::PackPadSticks(state)};
+        if (packed != g.pad_slot_last[slot]) {
+            g.pad_slot_last[slot] = packed;
+            pub.pad_slots[slot].Push(state);
+        }
+    }
+    pub.pad_slot_mask.store(mask, std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Re-merge all gamepads and publish the result. Merging on the
+//          writer side keeps GetGamepadState() to two loads.
+//-----------------------------------------------------------------------------
+void PublishPadLocked()
+{
+    PublishPadSlotsLocked();
+
+    GamepadState merged;
+    const auto max_magnitude = [](int16_t& dst, int16_t v) {
+        if (std::abs(static_cast<int>(v)) > std::abs(static_cast<int>(dst))) {
+            dst = v;
+        }
+    };
+    for (const Device& dev : g.devices) {
+        if (!dev.is_gamepad) {
+            continue;
+        }
+        merged.connected = true;
+        merged.wButtons |= dev.pad.wButtons;
+        merged.bLeftTrigger = std::max(merged.bLeftTrigger, dev.pad.bLeftTrigger);
+        merged.bRightTrigger = std::max(merged.bRightTrigger, dev.pad.bRightTrigger);
+        max_magnitude(merged.sThumbLX, dev.pad.sThumbLX);
+        max_magnitude(merged.sThumbLY, dev.pad.sThumbLY);
+        max_magnitude(merged.sThumbRX, dev.pad.sThumbRX);
+        max_magnitude(merged.sThumbRY, dev.pad.sThumbRY);
+    }
+
+    // A change in what hotkeys can see (buttons, triggers past the
+    // threshold) is an input edge; stick motion is not.
+    uint32_t edge_buttons = merged.wButtons;
+    if (merged.bLeftTrigger > XINPUT_GAMEPAD_TRIGGER_THRESHOLD)
+        edge_buttons |= XINPUT_GAMEPAD_LEFT_TRIGGER;
+    if (merged.bRightTrigger > XINPUT_GAMEPAD_TRIGGER_THRESHOLD)
+        edge_buttons |= XINPUT_GAMEPAD_RIGHT_TRIGGER;
+    if (edge_buttons != g.pad_edge_buttons) {
+        g.pad_edge_buttons = edge_buttons;
+        g.edge_ns = g.event_ns;
+    }
+
+    const uint64_t buttons = detail::PackPadButtons(merged);
+    const uint64_t sticks = detail::PackPadSticks(merged);
+
+    pub.seq.Begin();
+    pub.pad_buttons.store(buttons, std::memory_order_relaxed);
+    pub.pad_sticks.store(sticks, std::memory_order_relaxed);
+    pub.pad_ns.store(g.pad_ns, std::memory_order_relaxed);
+    pub.edge_ns.store(g.edge_ns, std::memory_order_relaxed);
+    pub.seq.End();
+}
+
+bool PressedBit(int code)
+{
+    return (pub.pressed[code / 64].load(std::memory_order_acquire) >> (code % 64)) & 1u;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Kernel time of an event, or the read time when the device kept
+//          its default CLOCK_REALTIME stamps
+//-----------------------------------------------------------------------------
+uint64_t EventTimeNs(const Device& dev, const struct input_event& e)
+{
+    if (!dev.kernel_clock) {
+        return InputClockNs();
+    }
+#ifdef input_event_sec
+    return static_cast<uint64_t>(e.input_event_sec) * 1000000000ull +
+           static_cast<uint64_t>(e.input_event_usec) * 1000ull;
+#else
+    return static_cast<uint64_t>(e.time.tv_sec) * 1000000000ull +
+           static_cast<uint64_t>(e.time.tv_usec) * 1000ull;
+#endif
+}
+
 void ApplyEventLocked(Device& dev, const struct input_event& e, bool emit)
 {
+    g.event_ns = EventTimeNs(dev, e);
+    if (dev.is_gamepad && (e.type == EV_KEY || e.type == EV_ABS)) {
+        g.pad_ns = dev.pad_ns = g.event_ns;
+    }
+    if (dev.is_mouse && (e.type == EV_KEY || e.type == EV_REL)) {
+        g.mouse_ns = g.event_ns;
+    }
     switch (e.type) {
         case EV_KEY:
             HandleKeyLocked(dev, e.code, e.value, emit);
@@ -482,11 +605,107 @@ void ApplyEventLocked(Device& dev, const struct input_event& e, bool emit)
     }
 }
 
+//-----------------------------------------------------------------------------
+// Purpose: Apply coalesced motion: one HandleRel/HandleAbs per axis with the
+//          summed delta / final position. Summing before the clamp differs
+//          from per-event clamping only while pinned against a region edge.
+//-----------------------------------------------------------------------------
+void FlushMotionLocked(Device& dev)
+{
+    if (dev.rel_x != 0) {
+        HandleRelLocked(REL_X, dev.rel_x);
+    }
+    if (dev.rel_y != 0) {
+        HandleRelLocked(REL_Y, dev.rel_y);
+    }
+    if (dev.rel_wheel != 0) {
+        HandleRelLocked(REL_WHEEL, dev.rel_wheel);
+    }
+    dev.rel_x = dev.rel_y = dev.rel_wheel = 0;
+    for (uint64_t bits = dev.abs_dirty; bits != 0; bits &= bits - 1) {
+        const int code = __builtin_ctzll(bits);
+        HandleAbsLocked(dev, static_cast<uint16_t>(code), dev.abs_pending[code]);
+    }
+    dev.abs_dirty = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Re-read key and axis state after SYN_DROPPED; the lost events may
+//          have included releases. Differences are applied as edges.
+//-----------------------------------------------------------------------------
+void ResyncDeviceLocked(Device& dev)
+{
+    dev.rel_x = dev.rel_y = dev.rel_wheel = 0;  // partial motion is meaningless
+    dev.abs_dirty = 0;
+    g.event_ns = InputClockNs();
+
+    unsigned long key_state[BitWords(KEY_CNT)] = {};
+    if (ioctl(dev.fd, EVIOCGKEY(sizeof(key_state)), key_state) >= 0) {
+        for (int code = 0; code < KEY_CNT; ++code) {
+            const bool down = TestBit(key_state, code);
+            // Pad buttons live in dev.pad.wButtons, not dev.keys.
+            if (down != dev.keys[code] || (dev.is_gamepad && PadButtonBit(code))) {
+                HandleKeyLocked(dev, static_cast<uint16_t>(code), down ? 1 : 0, true);
+            }
+        }
+    }
+    for (int axis = 0; dev.is_gamepad && axis < ABS_CNT; ++axis) {
+        struct input_absinfo info {};
+        if (dev.abs[axis].valid && ioctl(dev.fd, EVIOCGABS(axis), &info) == 0) {
+            HandleAbsLocked(dev, static_cast<uint16_t>(axis), info.value);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Route one event read from the device. With coalescing on, motion
+//          is accumulated and flushed before any key event (so a click lands
+//          where the cursor was) and at the end of the drained batch.
+//-----------------------------------------------------------------------------
+void QueueEventLocked(Device& dev, const struct input_event& e, bool coalesce)
+{
+    if (e.type == EV_SYN) {
+        if (e.code == SYN_DROPPED) {
+            dev.syn_dropped = true;
+        } else if (e.code == SYN_REPORT && dev.syn_dropped) {
+            dev.syn_dropped = false;
+            ResyncDeviceLocked(dev);
+        }
+        return;
+    }
+    if (dev.syn_dropped) {
+        return;  // the rest of this report is incomplete
+    }
+    if (coalesce) {
+        if (e.type == EV_REL && dev.is_mouse) {
+            g.event_ns = g.mouse_ns = EventTimeNs(dev, e);
+            switch (e.code) {
+                case REL_X:     dev.rel_x += e.value; break;
+                case REL_Y:     dev.rel_y += e.value; break;
+                case REL_WHEEL: dev.rel_wheel += e.value; break;
+                default: break;
+            }
+            return;
+        }
+        if (e.type == EV_ABS && dev.is_gamepad && e.code < ABS_CNT) {
+            g.event_ns = g.pad_ns = dev.pad_ns = EventTimeNs(dev, e);
+            dev.abs_pending[e.code] = e.value;
+            dev.abs_dirty |= 1ull << e.code;
+            return;
+        }
+        if (e.type == EV_KEY) {
+            FlushMotionLocked(dev);
+        }
+    }
+    ApplyEventLocked(dev, e, true);
+}
+
 //-----------------------------------------------------------------------------
 // Purpose: Close a device, releasing any keys it still holds
 //-----------------------------------------------------------------------------
 void CloseDeviceLocked(Device& dev)
 {
+    g.event_ns = InputClockNs();  // synthesized releases happen now
     for (int code = 0; code < KEY_CNT; ++code) {
         if (dev.keys[code]) {
             HandleKeyLocked(dev, static_cast<uint16_t>(code), 0, true);
@@ -513,8 +732,12 @@ void RemoveDeviceLocked(int fd)
     for (size_t i = 0; i < g.devices.size(); ++i) {
         if (g.devices[i].fd == fd) {
             INPUT_LOG("removed %s", g.devices[i].path.c_str());
+            const bool was_gamepad = g.devices[i].is_gamepad;
             CloseDeviceLocked(g.devices[i]);
             g.devices.erase(g.devices.begin() + i);
+            if (was_gamepad) {
+                PublishPadLocked();
+            }
             break;
         }
     }
@@ -533,13 +756,15 @@ bool PathOpenLocked(const std::string& path)
 
 //-----------------------------------------------------------------------------
 // Purpose: Open + classify one /dev/input/event* node. A device may be
-//          keyboard, mouse and gamepad at once; skip it if it is none.
+//          keyboard, mouse and gamepad at once; returns false if it is none.
+//          Touches only `dev` and the fd, so it runs without g.mutex: the
+//          ioctls are the slow part of a hotplug.
 //-----------------------------------------------------------------------------
-void TryOpenDeviceLocked(const std::string& path)
+bool ProbeDevice(const std::string& path, Device& dev, std::bitset<KEY_CNT>& held)
 {
     const int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
     if (fd < 0) {
-        return;  // usually EACCES until udev applies the input-group ACL
+        return false;  // usually EACCES until udev applies the input-group ACL
     }
 
     unsigned long ev_bits[BitWords(EV_CNT)] = {};
@@ -547,7 +772,7 @@ void TryOpenDeviceLocked(const std::string& path)
     unsigned long rel_bits[BitWords(REL_CNT)] = {};
     if (ioctl(fd, EVIOCGBIT(0, sizeof(ev_bits)), ev_bits) < 0) {
         close(fd);
-        return;
+        return false;
     }
     const bool has_key = TestBit(ev_bits, EV_KEY);
     const bool has_rel = TestBit(ev_bits, EV_REL);
@@ -558,21 +783,51 @@ void TryOpenDeviceLocked(const std::string& path)
         ioctl(fd, EVIOCGBIT(EV_REL, sizeof(rel_bits)), rel_bits);
     }
 
-    Device dev;
     dev.fd = fd;
     dev.path = path;
 
+    // evdev stamps CLOCK_REALTIME by default; the monotonic clock survives
+    // NTP steps and matches InputClockNs().
+    int clock_id = CLOCK_MONOTONIC;
+    dev.kernel_clock = ioctl(fd, EVIOCSCLOCKID, &clock_id) == 0;
+
     dev.is_keyboard = has_key;
     for (int i = 0; dev.is_keyboard && i < 26; ++i) {
-        dev.is_keyboard = TestBit(key_bits, kLetterKeys[i]);
+        dev.is_keyboard = TestBit(key_bits, keys::table::kVkToEv['A' + i]);
     }
     dev.is_mouse = has_rel && TestBit(rel_bits, REL_X) &&
                    has_key && TestBit(key_bits, BTN_LEFT);
     dev.is_gamepad = has_key && TestBit(key_bits, BTN_SOUTH);
 
+    unsigned long prop_bits[BitWords(INPUT_PROP_CNT)] = {};
+    unsigned long abs_bits[BitWords(ABS_CNT)] = {};
+    ioctl(fd, EVIOCGPROP(sizeof(prop_bits)), prop_bits);
+    if (TestBit(ev_bits, EV_ABS)) {
+        ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(abs_bits)), abs_bits);
+    }
+    const bool is_touchpad = TestBit(prop_bits, INPUT_PROP_BUTTONPAD) ||
+                             (TestBit(prop_bits, INPUT_PROP_POINTER) &&
+                              TestBit(abs_bits, ABS_MT_POSITION_X));
+    const bool is_sensor = TestBit(prop_bits, INPUT_PROP_ACCELEROMETER);
+    dev.classes = (dev.is_keyboard ? kDeviceKeyboard : 0u) |
+                  (dev.is_mouse ? kDeviceMouse : 0u) |
+                  (dev.is_gamepad ? kDeviceGamepad : 0u) |
+                  (is_touchpad ? kDeviceTouchpad : 0u) |
+                  (is_sensor ? kDeviceSensor : 0u);
+
+    // Deny drops the node outright; allow narrows the roles it is used for.
+    const uint32_t allow = g_allow_classes.load(std::memory_order_relaxed);
+    if (dev.classes & g_deny_classes.load(std::memory_order_relaxed)) {
+        dev.is_keyboard = dev.is_mouse = dev.is_gamepad = false;
+    }
+    dev.is_keyboard = dev.is_keyboard && (allow & kDeviceKeyboard);
+    dev.is_mouse = dev.is_mouse && (allow & kDeviceMouse);
+    dev.is_gamepad = dev.is_gamepad && (allow & kDeviceGamepad);
+
     if (!dev.is_keyboard && !dev.is_mouse && !dev.is_gamepad) {
         close(fd);
-        return;
+        dev.fd = -1;
+        return false;
     }
 
     if (dev.is_gamepad) {
@@ -585,62 +840,133 @@ void TryOpenDeviceLocked(const std::string& path)
             struct input_absinfo info {};
             if (ioctl(fd, EVIOCGABS(axis), &info) == 0) {
                 dev.abs[axis] = {info.minimum, info.maximum, true};
-                HandleAbsLocked(dev, static_cast<uint16_t>(axis), info.value);
+                HandleAbsLocked(dev, static_cast<uint16_t>(axis), info.value);  // dev-local
             }
         }
     }
 
-    // Sync keys already held at open so state and xkb modifiers start right.
+    // Keys already held at open; replayed under the lock by AddDeviceLocked
+    // so the merged state and xkb modifiers start right.
     unsigned long key_state[BitWords(KEY_CNT)] = {};
+    held.reset();
     if (ioctl(fd, EVIOCGKEY(sizeof(key_state)), key_state) >= 0) {
         for (int code = 0; code < KEY_CNT; ++code) {
             if (TestBit(key_state, code)) {
-                HandleKeyLocked(dev, static_cast<uint16_t>(code), 1, false);
+                held[code] = true;
             }
         }
     }
 
-    if (g_epoll_fd >= 0) {
-        struct epoll_event ev {};
-        ev.events = EPOLLIN;
-        ev.data.fd = fd;
-        if (epoll_ctl(g_epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
-            close(fd);
-            return;
-        }
-    }
-
     char name[128] = "?";
     ioctl(fd, EVIOCGNAME(sizeof(name)), name);
+    dev.name = name;
     INPUT_LOG("opened %s (%s)%s%s%s", path.c_str(), name,
               dev.is_keyboard ? " keyboard" : "",
               dev.is_mouse ? " mouse" : "",
               dev.is_gamepad ? " gamepad" : "");
+    return true;
+}
 
+//-----------------------------------------------------------------------------
+// Purpose: Publish a probed device: replay held keys, register with epoll
+//-----------------------------------------------------------------------------
+void AddDeviceLocked(Device&& dev, const std::bitset<KEY_CNT>& held)
+{
+    if (PathOpenLocked(dev.path)) {
+        close(dev.fd);  // lost a race with another probe of the same node
+        return;
+    }
+    g.event_ns = InputClockNs();
+    for (int code = 0; code < KEY_CNT; ++code) {
+        if (held[code]) {
+            HandleKeyLocked(dev, static_cast<uint16_t>(code), 1, false);
+        }
+    }
+
+    if (g_epoll_fd >= 0) {
+        struct epoll_event ev {};
+        ev.events = EPOLLIN;
+        ev.data.fd = dev.fd;
+        if (epoll_ctl(g_epoll_fd, EPOLL_CTL_ADD, dev.fd, &ev) < 0) {
+            // Undo the replay so no key stays latched without a device.
+            for (int code = 0; code < KEY_CNT; ++code) {
+                if (dev.keys[code]) {
+                    HandleKeyLocked(dev, static_cast<uint16_t>(code), 0, false);
+                }
+            }
+            close(dev.fd);
+            return;
+        }
+    }
+
+    const bool is_gamepad = dev.is_gamepad;
+    if (is_gamepad) {
+        uint32_t used = 0;
+        for (const Device& d : g.devices) {
+            if (d.pad_slot >= 0) used |= 1u << d.pad_slot;
+        }
+        for (int slot = 0; slot < kMaxPads && dev.pad_slot < 0; ++slot) {
+            if (!(used & (1u << slot))) dev.pad_slot = slot;
+        }
+        dev.pad_ns = g.event_ns;
+    }
     g.devices.push_back(std::move(dev));
+    if (is_gamepad) {
+        PublishPadLocked();
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Probe one node if it is not open yet. g.mutex is held only for
+//          the open-check and the final publish.
+//-----------------------------------------------------------------------------
+void TryOpenDevice(const std::string& path)
+{
+    {
+        std::lock_guard<std::mutex> lock(g.mutex);
+        if (PathOpenLocked(path)) {
+            return;
+        }
+    }
+
+    Device dev;
+    std::bitset<KEY_CNT> held;
+    if (!ProbeDevice(path, dev, held)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(g.mutex);
+    AddDeviceLocked(std::move(dev), held);
+    UpdateHaveKeyboardLocked();
+}
+
+bool IsEventNodeName(const char* name)
+{
+    return std::strncmp(name, "event", 5) == 0;
 }
 
 //-----------------------------------------------------------------------------
-// Purpose: Scan /dev/input for nodes not yet open. Removals are handled by
-//          read errors / EPOLLHUP on the device fd, not here.
+// Purpose: Scan /dev/input for nodes not yet open. Used at start-up and after
+//          an inotify queue overflow; normal hotplug probes only the node
+//          named in the event. Removals are handled by read errors /
+//          EPOLLHUP on the device fd, not here.
 //-----------------------------------------------------------------------------
-void RescanLocked()
+void Rescan()
 {
     DIR* dir = opendir("/dev/input");
     if (!dir) {
         return;
     }
+    std::vector<std::string> paths;
     while (const struct dirent* entry = readdir(dir)) {
-        if (std::strncmp(entry->d_name, "event", 5) != 0) {
-            continue;
-        }
-        const std::string path = std::string("/dev/input/") + entry->d_name;
-        if (!PathOpenLocked(path)) {
-            TryOpenDeviceLocked(path);
+        if (IsEventNodeName(entry->d_name)) {
+            paths.push_back(std::string("/dev/input/") + entry->d_name);
         }
     }
     closedir(dir);
-    UpdateHaveKeyboardLocked();
+    for (const std::string& path : paths) {
+        TryOpenDevice(path);
+    }
 }
 
 Device* FindDeviceLocked(int fd)
@@ -662,6 +988,7 @@ void HandleDeviceReadable(int fd, uint32_t epoll_flags)
     }
 
     bool dead = (epoll_flags & (EPOLLHUP | EPOLLERR)) != 0;
+    const bool coalesce = g_coalesce_motion.load(std::memory_order_relaxed);
     struct input_event buf[64];
     while (!dead) {
         const ssize_t n = read(fd, buf, sizeof(buf));
@@ -680,42 +1007,109 @@ void HandleDeviceReadable(int fd, uint32_t epoll_flags)
         }
         const int count = static_cast<int>(n / sizeof(struct input_event));
         for (int i = 0; i < count; ++i) {
-            ApplyEventLocked(*dev, buf[i], true);
+            QueueEventLocked(*dev, buf[i], coalesce);
         }
     }
+    FlushMotionLocked(*dev);
+
+    // Keys publish as they change; cursor and pad once per drained batch.
+    if (dev->is_mouse) {
+        PublishMouseLocked();
+    }
+    if (dev->is_gamepad) {
+        PublishPadLocked();
+    }
 
     if (dead) {
         RemoveDeviceLocked(fd);
     }
 }
 
-void DrainInotify()
+//-----------------------------------------------------------------------------
+// Purpose: Collect the eventN nodes named by pending inotify events. Returns
+//          true when the kernel queue overflowed and a full rescan is needed.
+//-----------------------------------------------------------------------------
+bool DrainInotify(std::vector<std::string>& nodes)
 {
-    // Contents don't matter — any activity in /dev/input triggers a rescan.
-    char buf[4096];
-    while (read(g_inotify_fd, buf, sizeof(buf)) > 0) {
+    alignas(struct inotify_event) char buf[4096];
+    bool overflow = false;
+    for (;;) {
+        const ssize_t n = read(g_inotify_fd, buf, sizeof(buf));
+        if (n <= 0) {
+            break;
+        }
+        for (ssize_t off = 0; off < n;) {
+            const auto* ev = reinterpret_cast<const struct inotify_event*>(buf + off);
+            off += sizeof(struct inotify_event) + ev->len;
+            if (ev->mask & IN_Q_OVERFLOW) {
+                overflow = true;
+                continue;
+            }
+            // IN_DELETE needs nothing: the device fd reports the removal.
+            if (ev->len == 0 || !(ev->mask & (IN_CREATE | IN_ATTRIB)) ||
+                !IsEventNodeName(ev->name)) {
+                continue;
+            }
+            std::string path = std::string("/dev/input/") + ev->name;
+            if (std::find(nodes.begin(), nodes.end(), path) == nodes.end()) {
+                nodes.push_back(std::move(path));
+            }
+        }
+    }
+    return overflow;
+}
+
+void DrainWakeFd()
+{
+    uint64_t value = 0;
+    while (read(g_wake_fd, &value, sizeof(value)) > 0) {
     }
 }
 
 //-----------------------------------------------------------------------------
-// Purpose: Reader thread: epoll over device fds + inotify, with a debounced
-//          rescan (IN_ATTRIB fires when udev grants group access post-CREATE)
+// Purpose: Reader thread: epoll over device fds + inotify + the Stop() wakeup
+//          eventfd, with a debounced probe of hotplugged nodes (IN_ATTRIB
+//          fires when udev grants group access post-CREATE)
 //-----------------------------------------------------------------------------
 void ReaderThread()
 {
     using Clock = std::chrono::steady_clock;
     constexpr auto kRescanDebounce = std::chrono::milliseconds(500);
 
-    bool rescan_pending = false;
+    std::vector<std::string> pending_nodes;
+    bool full_rescan = false;
     Clock::time_point rescan_at{};
+    Clock::time_point next_wake{};
 
     while (g_running.load(std::memory_order_relaxed)) {
-        // Cap the wait so Stop() is honored promptly without a wakeup fd.
-        int timeout_ms = 250;
-        if (rescan_pending) {
+        // Rate cap: hold off until the next slot, still waking for Stop().
+        const int32_t rate_hz = g_max_rate_hz.load(std::memory_order_relaxed);
+        if (rate_hz > 0) {
+            const auto now = Clock::now();
+            if (now < next_wake) {
+                const auto wait_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                    next_wake - now).count();
+                if (g_wake_fd >= 0) {
+                    struct pollfd pfd {g_wake_fd, POLLIN, 0};
+                    const struct timespec ts {static_cast<time_t>(wait_us / 1000000),
+                                              static_cast<long>(wait_us % 1000000) * 1000};
+                    ppoll(&pfd, 1, &ts, nullptr);
+                } else {
+                    std::this_thread::sleep_for(std::chrono::microseconds(wait_us));
+                }
+                continue;  // re-check g_running
+            }
+            next_wake = now + std::chrono::microseconds(1000000 / rate_hz);
+        }
+
+        // Sleep until input, hotplug, Stop(), or the debounce deadline. Without
+        // the eventfd, fall back to a capped wait so Stop() is still honored.
+        int timeout_ms = g_wake_fd >= 0 ? -1 : 250;
+        if (full_rescan || !pending_nodes.empty()) {
             const auto remain = std::chrono::duration_cast<std::chrono::milliseconds>(
                 rescan_at - Clock::now()).count();
-            timeout_ms = remain <= 0 ? 0 : std::min<int>(250, static_cast<int>(remain));
+            const int debounce_ms = remain <= 0 ? 0 : static_cast<int>(remain);
+            timeout_ms = timeout_ms < 0 ? debounce_ms : std::min(timeout_ms, debounce_ms);
         }
 
         struct epoll_event events[16];
@@ -728,18 +1122,31 @@ void ReaderThread()
             break;
         }
         for (int i = 0; i < n; ++i) {
-            if (events[i].data.fd == g_inotify_fd) {
-                DrainInotify();
-                rescan_pending = true;
-                rescan_at = Clock::now() + kRescanDebounce;
+            const int fd = events[i].data.fd;
+            if (fd == g_wake_fd) {
+                DrainWakeFd();
+            } else if (fd == g_inotify_fd) {
+                const size_t before = pending_nodes.size();
+                if (DrainInotify(pending_nodes)) {
+                    full_rescan = true;
+                }
+                if (full_rescan || pending_nodes.size() != before) {
+                    rescan_at = Clock::now() + kRescanDebounce;
+                }
             } else {
-                HandleDeviceReadable(events[i].data.fd, events[i].events);
+                HandleDeviceReadable(fd, events[i].events);
             }
         }
-        if (rescan_pending && Clock::now() >= rescan_at) {
-            std::lock_guard<std::mutex> lock(g.mutex);
-            RescanLocked();
-            rescan_pending = false;
+        if ((full_rescan || !pending_nodes.empty()) && Clock::now() >= rescan_at) {
+            if (full_rescan) {
+                Rescan();
+            } else {
+                for (const std::string& path : pending_nodes) {
+                    TryOpenDevice(path);
+                }
+            }
+            pending_nodes.clear();
+            full_rescan = false;
         }
     }
 }
@@ -820,9 +1227,19 @@ bool Start()
             INPUT_LOG("inotify unavailable: device hotplug disabled");
         }
 
+        g_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (g_wake_fd >= 0) {
+            struct epoll_event ev {};
+            ev.events = EPOLLIN;
+            ev.data.fd = g_wake_fd;
+            epoll_ctl(g_epoll_fd, EPOLL_CTL_ADD, g_wake_fd, &ev);
+        } else {
+            INPUT_LOG("eventfd failed: %s", std::strerror(errno));
+        }
+
         InitXkbLocked();
-        RescanLocked();
     }
+    Rescan();  // takes g.mutex per device, outside the probe ioctls
 
     g_running.store(true, std::memory_order_relaxed);
     g_thread = std::thread(ReaderThread);
@@ -843,6 +1260,10 @@ void Stop()
     }
 
     g_running.store(false, std::memory_order_relaxed);
+    if (g_wake_fd >= 0) {
+        const uint64_t one = 1;
+        (void)!write(g_wake_fd, &one, sizeof(one));
+    }
     if (g_thread.joinable()) {
         g_thread.join();
     }
@@ -856,15 +1277,28 @@ void Stop()
     g.devices.clear();
     g.key_count.fill(0);
     g.pressed.reset();
-    g.ev_tail = 0;
-    g.ev_count = 0;
-    g.typed.clear();
-    g.wheel = 0;
+    // g.queues stays as is: the OSD pump may be draining it right now, and
+    // the edges queued before the stop are still real.
+    for (auto& word : pub.pressed) {
+        word.store(0, std::memory_order_relaxed);
+    }
+    pub.wheel.store(0, std::memory_order_relaxed);
+    pub.seq.Begin();
+    for (auto& word : pub.vk) {
+        word.store(0, std::memory_order_relaxed);
+    }
+    pub.seq.End();
+    g.event_ns = InputClockNs();
+    PublishPadLocked();  // no devices left: publishes a disconnected pad
 
     if (g_inotify_fd >= 0) {
         close(g_inotify_fd);
         g_inotify_fd = -1;
     }
+    if (g_wake_fd >= 0) {
+        close(g_wake_fd);
+        g_wake_fd = -1;
+    }
     if (g_epoll_fd >= 0) {
         close(g_epoll_fd);
         g_epoll_fd = -1;
@@ -875,6 +1309,15 @@ void Stop()
     g_started = false;
 }
 
+void Configure(const InputOptions& options)
+{
+    g_coalesce_motion.store(options.coalesce_motion, std::memory_order_relaxed);
+    g_max_rate_hz.store(std::clamp<int32_t>(options.max_rate_hz, 0, 1000000),
+                        std::memory_order_relaxed);
+    g_allow_classes.store(options.allow_classes, std::memory_order_relaxed);
+    g_deny_classes.store(options.deny_classes, std::memory_order_relaxed);
+}
+
 bool PermissionOk()
 {
     return g_have_keyboard.load(std::memory_order_relaxed);
@@ -882,20 +1325,19 @@ bool PermissionOk()
 
 bool IsKeyDown(int vk)
 {
-    std::lock_guard<std::mutex> lock(g.mutex);
     switch (vk) {
         case VK_SHIFT:
-            return g.pressed[KEY_LEFTSHIFT] || g.pressed[KEY_RIGHTSHIFT];
+            return PressedBit(KEY_LEFTSHIFT) || PressedBit(KEY_RIGHTSHIFT);
         case VK_CONTROL:
-            return g.pressed[KEY_LEFTCTRL] || g.pressed[KEY_RIGHTCTRL];
+            return PressedBit(KEY_LEFTCTRL) || PressedBit(KEY_RIGHTCTRL);
         case VK_MENU:
-            return g.pressed[KEY_LEFTALT] || g.pressed[KEY_RIGHTALT];
+            return PressedBit(KEY_LEFTALT) || PressedBit(KEY_RIGHTALT);
         default: {
             if (vk < 0 || vk >= 256) {
                 return false;
             }
-            const int code = Tables().vk_to_ev[vk];
-            return code != 0 && g.pressed[code];
+            const int code = keys::table::kVkToEv[vk];
+            return code != 0 && PressedBit(code);
         }
     }
 }
@@ -907,42 +1349,106 @@ bool IsCtrlDown()
 
 GamepadState GetGamepadState()
 {
-    std::lock_guard<std::mutex> lock(g.mutex);
-    GamepadState merged;
-    const auto max_magnitude = [](int16_t& dst, int16_t v) {
-        if (std::abs(static_cast<int>(v)) > std::abs(static_cast<int>(dst))) {
-            dst = v;
+    VRTO3D_TRACE_ZONE("input.GetGamepadState");
+    uint64_t buttons = 0;
+    uint64_t sticks = 0;
+    uint64_t pad_ns = 0;
+    pub.seq.Read([&] {
+        buttons = pub.pad_buttons.load(std::memory_order_relaxed);
+        sticks = pub.pad_sticks.load(std::memory_order_relaxed);
+        pad_ns = pub.pad_ns.load(std::memory_order_relaxed);
+    });
+    return detail::UnpackPad(buttons, sticks, pad_ns);
+}
+
+void Snapshot(InputFrame& out)
+{
+    VRTO3D_TRACE_ZONE("input.Snapshot");
+    uint64_t vk[4];
+    uint64_t buttons = 0;
+    uint64_t sticks = 0;
+    uint64_t xy = 0;
+    uint64_t edge_ns = 0;
+    uint64_t pad_ns = 0;
+    uint64_t mouse_ns = 0;
+    pub.seq.Read([&] {
+        for (size_t i = 0; i < 4; ++i) {
+            vk[i] = pub.vk[i].load(std::memory_order_relaxed);
         }
-    };
+        buttons = pub.pad_buttons.load(std::memory_order_relaxed);
+        sticks = pub.pad_sticks.load(std::memory_order_relaxed);
+        xy = pub.mouse_xy.load(std::memory_order_relaxed);
+        edge_ns = pub.edge_ns.load(std::memory_order_relaxed);
+        pad_ns = pub.pad_ns.load(std::memory_order_relaxed);
+        mouse_ns = pub.mouse_ns.load(std::memory_order_relaxed);
+    });
+
+    detail::ExpandVkWords(vk, out.keys);
+    out.pad = detail::UnpackPad(buttons, sticks, pad_ns);
+    out.mouse = MouseState{};
+    out.mouse.x = static_cast<int32_t>(static_cast<uint32_t>(xy));
+    out.mouse.y = static_cast<int32_t>(static_cast<uint32_t>(xy >> 32));
+    out.mouse.left = out.keys[VK_LBUTTON];
+    out.mouse.right = out.keys[VK_RBUTTON];
+    out.mouse.middle = out.keys[VK_MBUTTON];
+    out.mouse.x1 = out.keys[VK_XBUTTON1];
+    out.mouse.x2 = out.keys[VK_XBUTTON2];
+    out.mouse.time_ns = mouse_ns;
+    out.edge_time_ns = edge_ns;
+    out.pending_key_events = static_cast<int>(g.queues.events.Size());
+}
+
+uint32_t GetConnectedPads()
+{
+    return pub.pad_slot_mask.load(std::memory_order_relaxed);
+}
+
+GamepadState GetPadState(int slot)
+{
+    return slot >= 0 && slot < kMaxPads ? pub.pad_slots[slot].Latest() : GamepadState{};
+}
+
+std::string GetPadName(int slot)
+{
+    std::lock_guard<std::mutex> lock(g.mutex);
     for (const Device& dev : g.devices) {
-        if (!dev.is_gamepad) {
-            continue;
+        if (dev.is_gamepad && dev.pad_slot == slot) {
+            return dev.name;
         }
-        merged.connected = true;
-        merged.wButtons |= dev.pad.wButtons;
-        merged.bLeftTrigger = std::max(merged.bLeftTrigger, dev.pad.bLeftTrigger);
-        merged.bRightTrigger = std::max(merged.bRightTrigger, dev.pad.bRightTrigger);
-        max_magnitude(merged.sThumbLX, dev.pad.sThumbLX);
-        max_magnitude(merged.sThumbLY, dev.pad.sThumbLY);
-        max_magnitude(merged.sThumbRX, dev.pad.sThumbRX);
-        max_magnitude(merged.sThumbRY, dev.pad.sThumbRY);
     }
-    return merged;
+    return std::string();
+}
+
+GamepadState SamplePad(int slot, uint64_t t_ns)
+{
+    VRTO3D_TRACE_ZONE("input.SamplePad");
+    return slot >= 0 && slot < kMaxPads ? pub.pad_slots[slot].At(t_ns) : GamepadState{};
+}
+
+uint64_t PadReportIntervalNs(int slot)
+{
+    return slot >= 0 && slot < kMaxPads ? pub.pad_slots[slot].IntervalNs() : 0;
+}
+
+int GetPadHistory(int slot, GamepadState* out, int max_samples)
+{
+    return slot >= 0 && slot < kMaxPads ? pub.pad_slots[slot].Copy(out, max_samples) : 0;
 }
 
 MouseState GetMouseState()
 {
-    std::lock_guard<std::mutex> lock(g.mutex);
+    VRTO3D_TRACE_ZONE("input.GetMouseState");
     MouseState ms;
-    ms.x = g.mouse_x;
-    ms.y = g.mouse_y;
-    ms.wheel = g.wheel;
-    g.wheel = 0;  // accumulated detents since last call
-    ms.left = g.pressed[BTN_LEFT];
-    ms.right = g.pressed[BTN_RIGHT];
-    ms.middle = g.pressed[BTN_MIDDLE];
-    ms.x1 = g.pressed[BTN_SIDE];
-    ms.x2 = g.pressed[BTN_EXTRA];
+    const uint64_t xy = pub.mouse_xy.load(std::memory_order_relaxed);
+    ms.x = static_cast<int32_t>(static_cast<uint32_t>(xy));
+    ms.y = static_cast<int32_t>(static_cast<uint32_t>(xy >> 32));
+    ms.wheel = pub.wheel.exchange(0, std::memory_order_relaxed);  // detents since last call
+    ms.left = PressedBit(BTN_LEFT);
+    ms.right = PressedBit(BTN_RIGHT);
+    ms.middle = PressedBit(BTN_MIDDLE);
+    ms.x1 = PressedBit(BTN_SIDE);
+    ms.x2 = PressedBit(BTN_EXTRA);
+    ms.time_ns = pub.mouse_ns.load(std::memory_order_relaxed);
     return ms;
 }
 
@@ -964,6 +1470,7 @@ void SetMouseRegion(int32_t width, int32_t height)
         g.mouse_x = std::clamp<int32_t>(g.mouse_x, 0, width - 1);
         g.mouse_y = std::clamp<int32_t>(g.mouse_y, 0, height - 1);
     }
+    PublishMouseLocked();
 }
 
 void WarpMouse(int32_t x, int32_t y)
@@ -971,39 +1478,23 @@ void WarpMouse(int32_t x, int32_t y)
     std::lock_guard<std::mutex> lock(g.mutex);
     g.mouse_x = std::clamp<int32_t>(x, 0, std::max<int32_t>(0, g.region_w - 1));
     g.mouse_y = std::clamp<int32_t>(y, 0, std::max<int32_t>(0, g.region_h - 1));
+    PublishMouseLocked();
 }
 
 int DrainKeyEvents(KeyEvent* out, int max_events)
 {
-    if (!out || max_events <= 0) {
-        return 0;
-    }
-    std::lock_guard<std::mutex> lock(g.mutex);
-    const int n = std::min(max_events, g.ev_count);
-    for (int i = 0; i < n; ++i) {
-        out[i] = g.events[g.ev_tail];
-        g.ev_tail = (g.ev_tail + 1) % kMaxKeyEvents;
-    }
-    g.ev_count -= n;
-    return n;
+    VRTO3D_TRACE_ZONE("input.DrainKeyEvents");
+    return g.queues.DrainEvents(out, max_events);
 }
 
 int DrainTypedUtf8(char* out, int out_size)
 {
-    if (!out || out_size <= 0) {
-        return 0;
-    }
-    std::lock_guard<std::mutex> lock(g.mutex);
-    size_t n = std::min(g.typed.size(), static_cast<size_t>(out_size - 1));
-    // Never split a UTF-8 sequence: back up past continuation bytes.
-    while (n > 0 && n < g.typed.size() &&
-           (static_cast<unsigned char>(g.typed[n]) & 0xC0) == 0x80) {
-        --n;
-    }
-    std::memcpy(out, g.typed.data(), n);
-    out[n] = '\0';
-    g.typed.erase(0, n);
-    return static_cast<int>(n);
+    return g.queues.DrainText(out, out_size);
+}
+
+InputStats GetInputStats()
+{
+    return g.queues.Stats();
 }
 
 }  // namespace vrto3d::input
@@ -15,10 +15,18 @@
  * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
  */
 #include "vrto3dlib/overlay_mgr.h"
+#include "vrto3dlib/win32_helper.hpp"  // Utf8ToWide
+#include "vrto3dlib/trace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
 #include <objidl.h>
 #include <gdiplus.h>
 #pragma comment (lib, "Gdiplus.lib")
+#pragma comment (lib, "Msimg32.lib")  // AlphaBlend
 
 using namespace Gdiplus;
 
@@ -26,13 +34,171 @@ static ULONG_PTR g_gdiplusToken = 0;
 
 
 //-----------------------------------------------------------------------------
-// Purpose: Initialize GDI library
+// Purpose: Retained overlay state. The font objects are created once by
+//          InitGDIPlus(); each recently drawn (text, height) keeps its
+//          antialiased rasterization in a premultiplied 32-bit DIB, so a
+//          repeat draw is one AlphaBlend onto the window DC instead of a
+//          GDI+ text layout and render.
+//-----------------------------------------------------------------------------
+namespace {
+
+constexpr int kOriginX = 50;           // text origin: (kOriginX, height - kOriginUp)
+constexpr int kOriginUp = 70;
+constexpr size_t kCachedStrings = 4;   // status text flips between a few strings
+
+struct RenderedText {
+    std::string text;
+    int height = 0;
+    HDC dc = nullptr;                  // memory DC with `bitmap` selected
+    HBITMAP bitmap = nullptr;
+    HGDIOBJ old_bitmap = nullptr;
+    int width_px = 0;
+    int height_px = 0;
+
+    void Release()
+    {
+        if (dc) {
+            SelectObject(dc, old_bitmap);
+            DeleteDC(dc);
+        }
+        if (bitmap) DeleteObject(bitmap);
+        *this = RenderedText{};
+    }
+};
+
+struct OverlayResources {
+    std::unique_ptr<FontFamily> family;
+    std::unique_ptr<Font> font;
+    std::unique_ptr<SolidBrush> brush;
+    RenderedText cache[kCachedStrings];  // most recently used first
+    std::mutex mutex;
+};
+
+// Deliberately leaked: the GDI+ objects may only be destroyed while GDI+ is
+// up, so ShutdownGDIPlus() is the one place they are freed. A host that never
+// calls it must not have them deleted by static destruction after GDI+ (or
+// the process) has already torn down.
+OverlayResources& Resources()
+{
+    static OverlayResources* res = new OverlayResources;
+    return *res;
+}
+
+// Rasterize `text` onto a transparent bitmap sized to its layout box.
+bool RenderText(OverlayResources& res, const std::string& text, int height, RenderedText& out)
+{
+    const std::wstring wtext = Utf8ToWide(text);
+
+    RectF bounds;
+    {
+        HDC screen = GetDC(nullptr);
+        Graphics measure(screen);
+        measure.SetTextRenderingHint(TextRenderingHintAntiAlias);
+        measure.MeasureString(wtext.c_str(), -1, res.font.get(), PointF(0, 0), &bounds);
+        ReleaseDC(nullptr, screen);
+    }
+    const int w = (std::max)(1, static_cast<int>(std::ceil(bounds.Width)));
+    const int h = (std::max)(1, static_cast<int>(std::ceil(bounds.Height)));
+
+    BITMAPINFO bmi = {};
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = w;
+    bmi.bmiHeader.biHeight = -h;      // top-down, same row order as GDI+
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+    void* bits = nullptr;
+    HBITMAP bitmap = CreateDIBSection(nullptr, &bmi, DIB_RGB_COLORS, &bits, nullptr, 0);
+    if (!bitmap) return false;
+    HDC dc = CreateCompatibleDC(nullptr);
+    if (!dc) {
+        DeleteObject(bitmap);
+        return false;
+    }
+
+    {
+        Bitmap target(w, h, w * 4, PixelFormat32bppPARGB, static_cast<BYTE*>(bits));
+        Graphics graphics(&target);
+        graphics.Clear(Color(0, 0, 0, 0));
+        graphics.SetTextRenderingHint(TextRenderingHintAntiAlias);
+        graphics.DrawString(wtext.c_str(), -1, res.font.get(), PointF(0, 0), res.brush.get());
+        graphics.Flush(FlushIntentionSync);
+    }
+
+    out.text = text;
+    out.height = height;
+    out.dc = dc;
+    out.bitmap = bitmap;
+    out.old_bitmap = SelectObject(dc, bitmap);
+    out.width_px = w;
+    out.height_px = h;
+    return true;
+}
+
+// Cached rasterization of (text, height), moved to the front; nullptr if it
+// could not be rendered.
+const RenderedText* FindOrRender(OverlayResources& res, const std::string& text, int height)
+{
+    size_t hit = kCachedStrings;
+    for (size_t i = 0; i < kCachedStrings; ++i) {
+        if (res.cache[i].dc && res.cache[i].height == height && res.cache[i].text == text) {
+            hit = i;
+            break;
+        }
+    }
+    if (hit == kCachedStrings) {
+        VRTO3D_TRACE_COUNT("overlay.renders", 1);
+        hit = kCachedStrings - 1;  // evict the least recently used
+        res.cache[hit].Release();
+        if (!RenderText(res, text, height, res.cache[hit])) return nullptr;
+    }
+    for (size_t i = hit; i > 0; --i) {
+        std::swap(res.cache[i], res.cache[i - 1]);
+    }
+    return &res.cache[0];
+}
+
+}  // namespace
+
+
+//-----------------------------------------------------------------------------
+// Purpose: Initialize GDI library and the overlay font resources
 //-----------------------------------------------------------------------------
 void InitGDIPlus() {
     if (g_gdiplusToken != 0) return;  // Already initialized
 
     GdiplusStartupInput gdiplusStartupInput;
-    GdiplusStartup(&g_gdiplusToken, &gdiplusStartupInput, nullptr);
+    if (GdiplusStartup(&g_gdiplusToken, &gdiplusStartupInput, nullptr) != Ok) {
+        g_gdiplusToken = 0;
+        return;
+    }
+
+    OverlayResources& res = Resources();
+    std::lock_guard<std::mutex> lock(res.mutex);
+    res.family = std::make_unique<FontFamily>(L"Segoe UI");
+    res.font = std::make_unique<Font>(res.family.get(), 30.0f, FontStyleRegular, UnitPixel);
+    res.brush = std::make_unique<SolidBrush>(Color(255, 0, 255, 0));  // Bright green
+}
+
+
+//-----------------------------------------------------------------------------
+// Purpose: Release the cached bitmaps and font resources, then GDI+ itself
+//-----------------------------------------------------------------------------
+void ShutdownGDIPlus() {
+    if (g_gdiplusToken == 0) return;
+
+    {
+        OverlayResources& res = Resources();
+        std::lock_guard<std::mutex> lock(res.mutex);
+        for (auto& entry : res.cache) {
+            entry.Release();
+        }
+        res.brush.reset();
+        res.font.reset();
+        res.family.reset();
+    }
+    GdiplusShutdown(g_gdiplusToken);
+    g_gdiplusToken = 0;
 }
 
 
@@ -40,21 +206,21 @@ void InitGDIPlus() {
 // Purpose: Draw text in the lower left corner of the VR window
 //-----------------------------------------------------------------------------
 void DrawOverlayText(HWND hwnd, const std::string& text, int height) {
+    VRTO3D_TRACE_ZONE("overlay.DrawOverlayText");
     if (!g_gdiplusToken) return;
 
+    OverlayResources& res = Resources();
+    std::lock_guard<std::mutex> lock(res.mutex);
+    if (!res.font) return;
+    const RenderedText* rendered = FindOrRender(res, text, height);
+    if (!rendered) return;
+
     HDC hdc = GetDC(hwnd);
     if (!hdc) return;
 
-    Graphics graphics(hdc);
-    graphics.SetTextRenderingHint(TextRenderingHintAntiAlias);
-
-    FontFamily fontFamily(L"Segoe UI");
-    Font font(&fontFamily, 30, FontStyleRegular, UnitPixel);
-    SolidBrush brush(Color(255, 0, 255, 0));  // Bright green
-
-    std::wstring wtext(text.begin(), text.end());
-
-    graphics.DrawString(wtext.c_str(), -1, &font, PointF(50, height - 70), &brush);
+    const BLENDFUNCTION blend = { AC_SRC_OVER, 0, 255, AC_SRC_ALPHA };
+    AlphaBlend(hdc, kOriginX, height - kOriginUp, rendered->width_px, rendered->height_px,
+               rendered->dc, 0, 0, rendered->width_px, rendered->height_px, blend);
 
     ReleaseDC(hwnd, hdc);
 }
@@ -0,0 +1,386 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "vrto3dlib/process_watch.h"
+#include "vrto3dlib/debug_log.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include "vrto3dlib/linux_helper.hpp"  // OpenPidFd
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+
+
+ProcessWatch& ProcessWatch::Instance()
+{
+    static ProcessWatch watch;
+    return watch;
+}
+
+
+#ifndef _WIN32
+
+struct ProcessWatch::Entry {
+    uint32_t pid = 0;
+    int fd = -1;  // pidfd, or -1: probed with kill(pid, 0) each wake
+    ExitFn on_exit;
+    bool started = false;            // Fire() is running on_exit
+    std::thread::id firing_thread;
+};
+
+namespace {
+
+// Wake at least this often while some entry has no pidfd (pre-5.3 kernels).
+constexpr int kProbeMs = 250;
+
+bool ProcessGone(uint32_t pid)
+{
+    return kill((pid_t)pid, 0) != 0 && errno == ESRCH;
+}
+
+}  // namespace
+
+
+ProcessWatch::ProcessWatch()
+{
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        LOG() << "ProcessWatch: eventfd failed: " << std::strerror(errno);
+    }
+}
+
+
+ProcessWatch::~ProcessWatch()
+{
+    // Last resort only; see Stop(). The fds stay open for the detached thread.
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    Wake();
+    if (thread_.joinable()) thread_.detach();
+}
+
+
+void ProcessWatch::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    Wake();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& kv : entries_) {
+        if (kv.second->fd >= 0) close(kv.second->fd);
+    }
+    entries_.clear();
+    firing_.clear();
+    for (int fd : retired_fds_) close(fd);
+    retired_fds_.clear();
+    stop_ = false;
+}
+
+
+void ProcessWatch::Wake()
+{
+    if (wake_fd_ < 0) return;
+    const uint64_t one = 1;
+    [[maybe_unused]] ssize_t n = write(wake_fd_, &one, sizeof(one));
+}
+
+
+bool ProcessWatch::Watch(uint32_t pid, ExitFn on_exit)
+{
+    if (pid == 0 || wake_fd_ < 0) return false;
+
+    auto entry = std::make_shared<Entry>();
+    entry->pid = pid;
+    entry->on_exit = std::move(on_exit);
+    entry->fd = OpenPidFd(pid);
+    if (entry->fd < 0) {
+        if (errno == ESRCH || ProcessGone(pid)) {
+            entry->on_exit(pid);
+            return true;
+        }
+        if (errno != ENOSYS) {
+            LOG() << "ProcessWatch: pidfd_open(" << pid << ") failed: " << std::strerror(errno)
+                  << "; probing instead";
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& slot = entries_[pid];
+        if (slot && slot->fd >= 0) retired_fds_.push_back(slot->fd);
+        slot = std::move(entry);
+        if (!thread_.joinable()) {
+            thread_ = std::thread(&ProcessWatch::Run, this);
+        }
+    }
+    Wake();
+    return true;
+}
+
+
+void ProcessWatch::Unwatch(uint32_t pid)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = entries_.find(pid);
+        if (it != entries_.end()) {
+            if (it->second->fd >= 0) retired_fds_.push_back(it->second->fd);
+            entries_.erase(it);
+        }
+        WaitCallbacks(lock, pid);
+    }
+    Wake();
+}
+
+
+//-----------------------------------------------------------------------------
+// Purpose: Watch thread: poll the eventfd plus every pidfd; an entry whose
+//          pidfd turns readable (or whose probe finds it gone) moves from
+//          entries_ to firing_ and its callback runs outside the lock
+//-----------------------------------------------------------------------------
+void ProcessWatch::Run()
+{
+    std::vector<struct pollfd> fds;
+    std::vector<std::shared_ptr<Entry>> polled;
+    std::vector<std::shared_ptr<Entry>> fired;
+    for (;;) {
+        bool probing = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stop_) return;
+            for (int fd : retired_fds_) close(fd);
+            retired_fds_.clear();
+
+            fds.assign(1, {wake_fd_, POLLIN, 0});
+            polled.clear();
+            for (auto& kv : entries_) {
+                if (kv.second->fd >= 0) {
+                    fds.push_back({kv.second->fd, POLLIN, 0});
+                    polled.push_back(kv.second);
+                } else {
+                    probing = true;
+                }
+            }
+        }
+
+        if (poll(fds.data(), fds.size(), probing ? kProbeMs : -1) < 0 && errno != EINTR) {
+            LOG() << "ProcessWatch: poll failed: " << std::strerror(errno);
+            return;
+        }
+        if (fds[0].revents) {
+            uint64_t drained = 0;
+            [[maybe_unused]] ssize_t n = read(wake_fd_, &drained, sizeof(drained));
+        }
+
+        fired.clear();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto take = [&](const std::shared_ptr<Entry>& e) {
+                auto it = entries_.find(e->pid);
+                if (it == entries_.end() || it->second != e) return;  // unwatched meanwhile
+                if (e->fd >= 0) retired_fds_.push_back(e->fd);
+                entries_.erase(it);
+                firing_.push_back(e);
+                fired.push_back(e);
+            };
+            for (size_t i = 0; i < polled.size(); ++i) {
+                if (fds[i + 1].revents) take(polled[i]);
+            }
+            if (probing) {
+                std::vector<std::shared_ptr<Entry>> probed;
+                for (auto& kv : entries_) {
+                    if (kv.second->fd < 0 && ProcessGone(kv.first)) probed.push_back(kv.second);
+                }
+                for (auto& e : probed) take(e);
+            }
+        }
+        for (auto& e : fired) {
+            Fire(e);
+        }
+    }
+}
+
+#else  // _WIN32
+
+struct ProcessWatch::Entry {
+    ProcessWatch* owner = nullptr;
+    uint32_t pid = 0;
+    HANDLE process = nullptr;
+    HANDLE wait = nullptr;
+    ExitFn on_exit;
+    bool started = false;            // Fire() is running on_exit
+    std::thread::id firing_thread;
+};
+
+ProcessWatch::ProcessWatch() = default;
+
+
+ProcessWatch::~ProcessWatch()
+{
+    // Last resort only; see Stop(). Cancels the waits without waiting for
+    // callbacks already under way.
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& kv : entries_) {
+        if (kv.second->wait) UnregisterWait(kv.second->wait);
+    }
+}
+
+
+void ProcessWatch::Stop()
+{
+    std::vector<uint32_t> pids;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& kv : entries_) pids.push_back(kv.first);
+    }
+    for (uint32_t pid : pids) Unwatch(pid);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    WaitCallbacks(lock, 0);
+}
+
+
+bool ProcessWatch::Watch(uint32_t pid, ExitFn on_exit)
+{
+    if (pid == 0) return false;
+    Unwatch(pid);
+
+    HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, pid);
+    if (!process) {
+        if (GetLastError() == ERROR_INVALID_PARAMETER) {  // no such pid
+            on_exit(pid);
+            return true;
+        }
+        LOG() << "ProcessWatch: OpenProcess(" << pid << ") failed (err=" << GetLastError() << ")";
+        return false;
+    }
+
+    auto entry = std::make_shared<Entry>();
+    entry->owner = this;
+    entry->pid = pid;
+    entry->process = process;
+    entry->on_exit = std::move(on_exit);
+
+    // Held across the registration: a wait that fires at once blocks in
+    // OnSignaled() until entry->wait has been stored.
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!RegisterWaitForSingleObject(&entry->wait, process, &ProcessWatch::OnSignaled, entry.get(),
+                                     INFINITE, WT_EXECUTEONLYONCE)) {
+        LOG() << "ProcessWatch: RegisterWaitForSingleObject failed (err=" << GetLastError() << ")";
+        CloseHandle(process);
+        return false;
+    }
+    entries_[pid] = std::move(entry);
+    return true;
+}
+
+
+void ProcessWatch::Unwatch(uint32_t pid)
+{
+    std::shared_ptr<Entry> entry;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = entries_.find(pid);
+        if (it != entries_.end()) {
+            entry = std::move(it->second);
+            entries_.erase(it);
+        }
+        WaitCallbacks(lock, pid);
+    }
+    if (!entry) return;
+    // Waits out an OnSignaled() already entered; it finds the entry unmapped
+    // and leaves cleanup to us.
+    if (entry->wait) UnregisterWaitEx(entry->wait, INVALID_HANDLE_VALUE);
+    CloseHandle(entry->process);
+}
+
+
+//-----------------------------------------------------------------------------
+// Purpose: Pool callback. Whoever unmaps the entry owns its cleanup: here,
+//          unless Unwatch() got there first (it then waits for us to return).
+//          The callback itself runs via firing_, which Unwatch() waits on
+//-----------------------------------------------------------------------------
+void CALLBACK ProcessWatch::OnSignaled(void* context, unsigned char /*timed_out*/)
+{
+    auto* raw = static_cast<Entry*>(context);
+    ProcessWatch* self = raw->owner;
+    std::shared_ptr<Entry> entry;
+    {
+        std::lock_guard<std::mutex> lock(self->mutex_);
+        auto it = self->entries_.find(raw->pid);
+        if (it == self->entries_.end() || it->second.get() != raw) return;
+        entry = std::move(it->second);
+        self->entries_.erase(it);
+        self->firing_.push_back(entry);
+    }
+    self->Fire(entry);
+    UnregisterWait(entry->wait);  // the non-blocking form is the one allowed here
+    CloseHandle(entry->process);
+}
+
+#endif
+
+
+void ProcessWatch::Fire(const std::shared_ptr<Entry>& e)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (std::find(firing_.begin(), firing_.end(), e) == firing_.end()) return;  // unwatched
+        e->started = true;
+        e->firing_thread = std::this_thread::get_id();
+    }
+    e->on_exit(e->pid);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        firing_.erase(std::remove(firing_.begin(), firing_.end(), e), firing_.end());
+    }
+    fired_cv_.notify_all();
+}
+
+
+void ProcessWatch::WaitCallbacks(std::unique_lock<std::mutex>& lock, uint32_t pid)
+{
+    auto matches = [pid](const std::shared_ptr<Entry>& e) { return pid == 0 || e->pid == pid; };
+    firing_.erase(std::remove_if(firing_.begin(), firing_.end(), [&](const std::shared_ptr<Entry>& e) {
+        return matches(e) && !e->started;
+    }), firing_.end());
+
+    const std::thread::id self = std::this_thread::get_id();
+    fired_cv_.wait(lock, [&] {
+        return std::none_of(firing_.begin(), firing_.end(), [&](const std::shared_ptr<Entry>& e) {
+            return matches(e) && e->firing_thread != self;
+        });
+    });
+}
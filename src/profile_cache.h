@@ -0,0 +1,347 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+// Internal to json_manager.cpp: the binary compiled-profile cache. Each JSON
+// file in vrto3dFolder may have "<file>.<kind>.cache" next to it holding the
+// StereoDisplayDriverConfiguration fields that loader produced. The header
+// keys it by the source file's size and mtime plus a schema hash; any
+// mismatch (or a short/corrupt payload) means "parse the JSON".
+//
+// The loaders describe their fields once as a visitor over an IO object:
+//   io("name", field)      always present
+//   io.Opt("name", field)  JSON-guarded: only assigned when the key exists
+//   io.Count("name", n)    row count that sizes the following vectors
+// Writer serializes, Reader deserializes, SchemaHasher hashes names and
+// types so adding, removing, or retyping a field invalidates old caches.
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace vrto3d::profile_cache {
+
+constexpr uint32_t kMagic = 0x43443356;  // "V3DC"
+// Bump when the encoding itself changes (the field set is covered by the
+// schema hash).
+constexpr uint32_t kVersion = 1;
+
+constexpr uint64_t kFnvBasis = 14695981039346656037ull;
+
+constexpr uint64_t Fnv1a(const char* s, size_t n, uint64_t h = kFnvBasis)
+{
+    for (size_t i = 0; i < n; ++i) {
+        h ^= static_cast<unsigned char>(s[i]);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+inline uint64_t Fnv1a(const std::string& s, uint64_t h = kFnvBasis)
+{
+    return Fnv1a(s.data(), s.size(), h);
+}
+
+struct FileStamp {
+    bool ok = false;
+    uint64_t size = 0;
+    int64_t mtime = 0;  // filesystem clock ticks
+};
+
+inline FileStamp StatFile(const std::string& path)
+{
+    FileStamp st;
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    if (ec) return st;
+    const auto mtime = std::filesystem::last_write_time(path, ec);
+    if (ec) return st;
+    st.ok = true;
+    st.size = static_cast<uint64_t>(size);
+    st.mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+    return st;
+}
+
+struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t schema;
+    uint64_t size;
+    int64_t mtime;
+};
+
+//-----------------------------------------------------------------------------
+// Purpose: Serialize a visitor's fields. Opt() presence comes from the JSON
+//          the fields were just loaded from.
+//-----------------------------------------------------------------------------
+class Writer {
+public:
+    static constexpr bool kDecoding = false;
+
+    explicit Writer(const nlohmann::json& source) : source_(source) {}
+
+    template <typename T>
+    void operator()(const char*, const T& v) { Put(v); }
+
+    template <typename T>
+    void Opt(const char* key, const T& v)
+    {
+        bool present = source_.contains(key);
+        if constexpr (std::is_array_v<T>) {
+            present = present && source_[key].is_array() &&
+                      source_[key].size() >= std::extent_v<T>;
+        }
+        Put(present);
+        if (present) Put(v);
+    }
+
+    void Count(const char*, size_t& n) { Put(static_cast<uint32_t>(n)); }
+
+    const std::string& Bytes() const { return buf_; }
+
+private:
+    template <typename T>
+    void Put(const T& v)
+    {
+        if constexpr (std::is_enum_v<T>) {
+            Put(static_cast<std::underlying_type_t<T>>(v));
+        } else if constexpr (std::is_array_v<T>) {
+            for (const auto& e : v) Put(e);
+        } else {
+            static_assert(std::is_arithmetic_v<T>, "unsupported cache field type");
+            buf_.append(reinterpret_cast<const char*>(&v), sizeof(T));
+        }
+    }
+    void Put(const std::string& s)
+    {
+        Put(static_cast<uint32_t>(s.size()));
+        buf_.append(s);
+    }
+    template <typename T>
+    void Put(const std::vector<T>& v)
+    {
+        Put(static_cast<uint32_t>(v.size()));
+        for (const auto& e : v) Put(e);
+    }
+
+    const nlohmann::json& source_;
+    std::string buf_;
+};
+
+//-----------------------------------------------------------------------------
+// Purpose: Deserialize into a visitor's fields. Any overrun latches !Ok();
+//          the caller decodes into a scratch copy and discards it then.
+//-----------------------------------------------------------------------------
+class Reader {
+public:
+    static constexpr bool kDecoding = true;
+
+    Reader(const char* data, size_t size) : p_(data), end_(data + size) {}
+
+    template <typename T>
+    void operator()(const char*, T& v) { Get(v); }
+
+    template <typename T>
+    void Opt(const char*, T& v)
+    {
+        bool present = false;
+        Get(present);
+        if (present) Get(v);
+    }
+
+    void Count(const char*, size_t& n)
+    {
+        uint32_t count = 0;
+        Get(count);
+        // Every row is at least one byte; reject counts the payload can't hold.
+        if (count > Remaining()) ok_ = false;
+        n = ok_ ? count : 0;
+    }
+
+    bool Ok() const { return ok_; }
+    bool Done() const { return ok_ && p_ == end_; }
+
+private:
+    size_t Remaining() const { return static_cast<size_t>(end_ - p_); }
+
+    bool Take(void* out, size_t n)
+    {
+        if (!ok_ || Remaining() < n) {
+            ok_ = false;
+            return false;
+        }
+        std::memcpy(out, p_, n);
+        p_ += n;
+        return true;
+    }
+
+    template <typename T>
+    void Get(T& v)
+    {
+        if constexpr (std::is_same_v<T, bool>) {
+            uint8_t b = 0;
+            Take(&b, 1);
+            v = b != 0;
+        } else if constexpr (std::is_enum_v<T>) {
+            std::underlying_type_t<T> raw{};
+            Get(raw);
+            v = static_cast<T>(raw);
+        } else if constexpr (std::is_array_v<T>) {
+            for (auto& e : v) Get(e);
+        } else {
+            static_assert(std::is_arithmetic_v<T>, "unsupported cache field type");
+            Take(&v, sizeof(T));
+        }
+    }
+    void Get(std::string& s)
+    {
+        uint32_t n = 0;
+        Get(n);
+        if (!ok_ || Remaining() < n) {
+            ok_ = false;
+            return;
+        }
+        s.assign(p_, n);
+        p_ += n;
+    }
+    template <typename T>
+    void Get(std::vector<T>& v)
+    {
+        uint32_t n = 0;
+        Get(n);
+        if (!ok_ || Remaining() < n) {
+            ok_ = false;
+            return;
+        }
+        v.resize(n);
+        for (auto& e : v) Get(e);
+    }
+
+    const char* p_;
+    const char* end_;
+    bool ok_ = true;
+};
+
+//-----------------------------------------------------------------------------
+// Purpose: Hash a visitor's field names and types (not values).
+//-----------------------------------------------------------------------------
+class SchemaHasher {
+public:
+    static constexpr bool kDecoding = false;
+
+    explicit SchemaHasher(const char* kind)
+        : hash_(Fnv1a(kind, std::strlen(kind))) {}
+
+    template <typename T>
+    void operator()(const char* name, const T&) { Mix(name, Tag<T>()); }
+
+    template <typename T>
+    void Opt(const char* name, const T&) { Mix(name, 'o' * 1000 + Tag<T>()); }
+
+    void Count(const char* name, size_t&) { Mix(name, 'n'); }
+
+    uint64_t Hash() const { return hash_; }
+
+private:
+    template <typename T>
+    static constexpr uint32_t Tag()
+    {
+        if constexpr (std::is_same_v<T, std::string>) {
+            return 's';
+        } else if constexpr (std::is_same_v<T, std::vector<std::string>>) {
+            return 'S';
+        } else if constexpr (std::is_same_v<T, std::vector<float>>) {
+            return 'F';
+        } else if constexpr (std::is_array_v<T>) {
+            return 100 * static_cast<uint32_t>(std::extent_v<T>) + Tag<std::remove_extent_t<T>>();
+        } else if constexpr (std::is_enum_v<T>) {
+            return 'e' + static_cast<uint32_t>(sizeof(T));
+        } else {
+            return static_cast<uint32_t>(sizeof(T)) * 4 +
+                   (std::is_floating_point_v<T> ? 1 : std::is_signed_v<T> ? 2 : 0);
+        }
+    }
+
+    void Mix(const char* name, uint32_t tag)
+    {
+        hash_ = Fnv1a(name, std::strlen(name) + 1, hash_);
+        hash_ = Fnv1a(reinterpret_cast<const char*>(&tag), sizeof(tag), hash_);
+    }
+
+    uint64_t hash_;
+};
+
+// Payload of `cachePath` if its header matches `schema` and `stamp`.
+inline bool Load(const std::string& cachePath, uint64_t schema, const FileStamp& stamp,
+                 std::string& payload)
+{
+    if (!stamp.ok) return false;
+    std::ifstream in(cachePath, std::ios::binary);
+    if (!in.is_open()) return false;
+    Header h{};
+    if (!in.read(reinterpret_cast<char*>(&h), sizeof(h))) return false;
+    if (h.magic != kMagic || h.version != kVersion || h.schema != schema ||
+        h.size != stamp.size || h.mtime != stamp.mtime) {
+        return false;
+    }
+    payload.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// Header check only (no payload read).
+inline bool IsCurrent(const std::string& cachePath, uint64_t schema, const FileStamp& stamp)
+{
+    if (!stamp.ok) return false;
+    std::ifstream in(cachePath, std::ios::binary);
+    Header h{};
+    return in.read(reinterpret_cast<char*>(&h), sizeof(h)) &&
+           h.magic == kMagic && h.version == kVersion && h.schema == schema &&
+           h.size == stamp.size && h.mtime == stamp.mtime;
+}
+
+// Write-to-temp then rename, so a reader never sees a torn cache. Failure
+// only costs the next load a JSON parse.
+inline bool Store(const std::string& cachePath, uint64_t schema, const FileStamp& stamp,
+                  const std::string& payload)
+{
+    if (!stamp.ok) return false;
+    const std::string tmp = cachePath + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        const Header h{kMagic, kVersion, schema, stamp.size, stamp.mtime};
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        out.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+        if (!out) return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, cachePath, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace vrto3d::profile_cache
@@ -0,0 +1,111 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+// Internal to json_manager.cpp: what JsonManager knows about each *.json in
+// vrto3dFolder, keyed by file name (the app key / exe name profiles are
+// saved under). An entry holds the file's size/mtime stamp and, once it has
+// been loaded, the encoded profile-cache payload (profile_cache.h), so a
+// game switch back to a known profile decodes from memory.
+//
+// Built once by a folder scan when the watcher starts; the watcher's events
+// then keep it current. While that holds, a name with no entry is a profile
+// that doesn't exist and a lookup needs no I/O. Names marked stale (written
+// by us, or not yet reported by the watcher) are stat'ed before use.
+
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "profile_cache.h"
+
+namespace vrto3d {
+
+class ProfileIndex {
+public:
+    struct Entry {
+        profile_cache::FileStamp stamp;
+        std::string payload;  // profile-pass cache payload for `stamp`; empty = not loaded
+    };
+
+    // Scan `folder`; afterwards missing names count as known-missing.
+    void Build(const std::string& folder)
+    {
+        entries_.clear();
+        stale_.clear();
+        std::error_code ec;
+        for (const auto& de : std::filesystem::directory_iterator(folder, ec)) {
+            const std::string name = de.path().filename().string();
+            if (IsProfileName(name)) Refresh(folder, name);
+        }
+        complete_ = true;
+    }
+
+    bool Complete() const { return complete_; }
+    bool IsStale(const std::string& name) const { return stale_.count(name) != 0; }
+
+    // nullptr: no such profile (only meaningful when Complete() and not stale).
+    Entry* Find(const std::string& name)
+    {
+        auto it = entries_.find(name);
+        return it == entries_.end() ? nullptr : &it->second;
+    }
+
+    // Re-stat one file (a watcher event, or a stale name about to be used).
+    // The payload survives only if the stamp is unchanged.
+    Entry* Refresh(const std::string& folder, const std::string& name)
+    {
+        const profile_cache::FileStamp st = profile_cache::StatFile(folder + "/" + name);
+        stale_.erase(name);
+        if (!st.ok) {
+            entries_.erase(name);
+            return nullptr;
+        }
+        Entry& e = entries_[name];
+        if (e.stamp.size != st.size || e.stamp.mtime != st.mtime || !e.stamp.ok) {
+            e.payload.clear();
+        }
+        e.stamp = st;
+        return &e;
+    }
+
+    // We are about to change `name` on disk.
+    void MarkStale(const std::string& name) { stale_.insert(name); }
+
+    void SetPayload(const std::string& name, const profile_cache::FileStamp& stamp,
+                    std::string payload)
+    {
+        if (!stamp.ok) return;
+        Entry& e = entries_[name];
+        e.stamp = stamp;
+        e.payload = std::move(payload);
+    }
+
+    static bool IsProfileName(const std::string& name)
+    {
+        return name.size() > 5 && name.compare(name.size() - 5, 5, ".json") == 0;
+    }
+
+private:
+    std::unordered_map<std::string, Entry> entries_;
+    std::unordered_set<std::string> stale_;
+    bool complete_ = false;
+};
+
+}  // namespace vrto3d
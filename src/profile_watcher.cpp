@@ -0,0 +1,271 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "profile_watcher.h"
+#include "profile_index.h"
+#include "vrto3dlib/debug_log.hpp"
+
+#include <filesystem>
+#include <system_error>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+
+ProfileWatcher::ProfileWatcher(std::string folder, std::chrono::milliseconds settle)
+    : folder_(std::move(folder)), settle_(settle)
+{
+}
+
+
+ProfileWatcher::~ProfileWatcher()
+{
+    Stop();
+}
+
+
+void ProfileWatcher::Note(const std::string& name)
+{
+    if (!vrto3d::ProfileIndex::IsProfileName(name)) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    changed_[name] = std::chrono::steady_clock::now();
+}
+
+
+//-----------------------------------------------------------------------------
+// Purpose: Events were lost: treat every profile in the folder as changed
+//-----------------------------------------------------------------------------
+void ProfileWatcher::NoteAll()
+{
+    LOG() << "ProfileWatcher: change queue overflowed; rescanning " << folder_;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(folder_, ec)) {
+        Note(entry.path().filename().string());
+    }
+}
+
+
+std::vector<std::string> ProfileWatcher::TakeSettled()
+{
+    std::vector<std::string> names;
+    const auto cutoff = std::chrono::steady_clock::now() - settle_;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = changed_.begin(); it != changed_.end();) {
+        if (it->second <= cutoff) {
+            names.push_back(it->first);
+            it = changed_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return names;
+}
+
+
+bool ProfileWatcher::Pending(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return changed_.count(name) != 0;
+}
+
+
+#ifndef _WIN32
+
+bool ProfileWatcher::Start()
+{
+    if (Running()) return true;
+    Stop();  // reap a thread that exited on error
+
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd_ < 0) {
+        LOG() << "ProfileWatcher: inotify_init1 failed: " << std::strerror(errno);
+        return false;
+    }
+    // CLOSE_WRITE: edited in place; MOVED_TO: atomic replace (ours, most
+    // editors); DELETE/MOVED_FROM: profile removed.
+    if (inotify_add_watch(inotify_fd_, folder_.c_str(),
+                          IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE) < 0) {
+        LOG() << "ProfileWatcher: cannot watch " << folder_ << ": " << std::strerror(errno);
+        close(inotify_fd_);
+        inotify_fd_ = -1;
+        return false;
+    }
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        LOG() << "ProfileWatcher: eventfd failed: " << std::strerror(errno);
+        close(inotify_fd_);
+        inotify_fd_ = -1;
+        return false;
+    }
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread([this] {
+        Run();
+        running_.store(false, std::memory_order_release);
+    });
+    return true;
+}
+
+
+void ProfileWatcher::Stop()
+{
+    if (thread_.joinable()) {
+        const uint64_t one = 1;
+        [[maybe_unused]] ssize_t n = write(wake_fd_, &one, sizeof(one));
+        thread_.join();
+    }
+    if (inotify_fd_ >= 0) {
+        close(inotify_fd_);
+        inotify_fd_ = -1;
+    }
+    if (wake_fd_ >= 0) {
+        close(wake_fd_);
+        wake_fd_ = -1;
+    }
+}
+
+
+void ProfileWatcher::Run()
+{
+    alignas(struct inotify_event) char buf[4096];
+    struct pollfd fds[2] = {
+        {inotify_fd_, POLLIN, 0},
+        {wake_fd_, POLLIN, 0},
+    };
+    for (;;) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            LOG() << "ProfileWatcher: poll failed: " << std::strerror(errno);
+            return;
+        }
+        if (fds[1].revents) return;
+        if (!(fds[0].revents & POLLIN)) continue;
+
+        for (;;) {
+            const ssize_t len = read(inotify_fd_, buf, sizeof(buf));
+            if (len <= 0) break;  // EAGAIN: drained
+            for (ssize_t off = 0; off < len;) {
+                const auto* ev = reinterpret_cast<const struct inotify_event*>(buf + off);
+                if (ev->mask & IN_Q_OVERFLOW) {
+                    NoteAll();
+                } else if (ev->len > 0) {
+                    Note(ev->name);
+                }
+                off += static_cast<ssize_t>(sizeof(struct inotify_event) + ev->len);
+            }
+        }
+    }
+}
+
+#else  // _WIN32
+
+bool ProfileWatcher::Start()
+{
+    if (Running()) return true;
+    Stop();  // reap a thread that exited on error
+
+    const std::wstring wfolder = std::filesystem::path(folder_).wstring();
+    dir_ = CreateFileW(wfolder.c_str(), FILE_LIST_DIRECTORY,
+                       FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                       OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (dir_ == INVALID_HANDLE_VALUE) {
+        LOG() << "ProfileWatcher: cannot open " << folder_ << " (error " << GetLastError() << ")";
+        return false;
+    }
+    stop_event_ = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!stop_event_) {
+        CloseHandle(dir_);
+        dir_ = INVALID_HANDLE_VALUE;
+        return false;
+    }
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread([this] {
+        Run();
+        running_.store(false, std::memory_order_release);
+    });
+    return true;
+}
+
+
+void ProfileWatcher::Stop()
+{
+    if (thread_.joinable()) {
+        SetEvent(stop_event_);
+        thread_.join();
+    }
+    if (dir_ != INVALID_HANDLE_VALUE) {
+        CloseHandle(dir_);
+        dir_ = INVALID_HANDLE_VALUE;
+    }
+    if (stop_event_) {
+        CloseHandle(stop_event_);
+        stop_event_ = nullptr;
+    }
+}
+
+
+void ProfileWatcher::Run()
+{
+    alignas(DWORD) BYTE buf[16 * 1024];
+    OVERLAPPED ov{};
+    ov.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!ov.hEvent) return;
+    const HANDLE waits[2] = {ov.hEvent, stop_event_};
+
+    for (;;) {
+        ResetEvent(ov.hEvent);
+        if (!ReadDirectoryChangesW(dir_, buf, sizeof(buf), FALSE,
+                                   FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE,
+                                   nullptr, &ov, nullptr)) {
+            LOG() << "ProfileWatcher: ReadDirectoryChangesW failed (error " << GetLastError() << ")";
+            break;
+        }
+        if (WaitForMultipleObjects(2, waits, FALSE, INFINITE) != WAIT_OBJECT_0) {
+            CancelIoEx(dir_, &ov);
+            DWORD ignored = 0;
+            GetOverlappedResult(dir_, &ov, &ignored, TRUE);
+            break;
+        }
+        DWORD bytes = 0;
+        if (!GetOverlappedResult(dir_, &ov, &bytes, FALSE)) break;
+        if (bytes == 0) {  // buffer overflowed: the changes are lost
+            NoteAll();
+            continue;
+        }
+        for (DWORD off = 0;;) {
+            const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(buf + off);
+            const std::wstring name(info->FileName, info->FileNameLength / sizeof(WCHAR));
+            // Every action (including the old name of a rename) reports the
+            // name; the consumer finds out by reloading whether it still exists.
+            try {
+                Note(std::filesystem::path(name).string());
+            } catch (const std::system_error&) {
+                // Not representable in the ANSI code page: not a file we open.
+            }
+            if (info->NextEntryOffset == 0) break;
+            off += info->NextEntryOffset;
+        }
+    }
+    CloseHandle(ov.hEvent);
+}
+
+#endif
@@ -0,0 +1,87 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+// Internal to JsonManager: reports which *.json files in vrto3dFolder changed,
+// using inotify on Linux and ReadDirectoryChangesW on Windows. A background
+// thread records each event's file name with a timestamp; TakeSettled() hands
+// out names that have been quiet for the settle window, so an editor's
+// truncate-then-write (or our own temp-file + rename) reports once.
+//
+// If the OS drops events (queue overflow), every *.json in the folder is
+// reported as changed. If the watch itself fails, the thread exits and
+// Running() turns false; nothing is reported from then on.
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+class ProfileWatcher {
+public:
+    explicit ProfileWatcher(std::string folder,
+                            std::chrono::milliseconds settle = std::chrono::milliseconds(150));
+    ~ProfileWatcher();
+
+    ProfileWatcher(const ProfileWatcher&) = delete;
+    ProfileWatcher& operator=(const ProfileWatcher&) = delete;
+
+    // Open the watch and start the thread. False if the folder can't be
+    // watched (nothing is reported then). Re-arms a watch whose thread died.
+    bool Start();
+    void Stop();
+
+    // True while the thread is watching: false before Start(), after Stop(),
+    // and once a poll/ReadDirectoryChangesW failure ended the thread.
+    bool Running() const { return running_.load(std::memory_order_acquire); }
+
+    // File names (relative to the folder) changed and settled since the
+    // last call.
+    std::vector<std::string> TakeSettled();
+
+    // True while `name` has an event not yet handed out by TakeSettled().
+    bool Pending(const std::string& name);
+
+private:
+    void Run();
+    void Note(const std::string& name);
+    void NoteAll();
+
+    const std::string folder_;
+    const std::chrono::milliseconds settle_;
+
+    std::mutex mutex_;
+    std::map<std::string, std::chrono::steady_clock::time_point> changed_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+
+#ifdef _WIN32
+    HANDLE dir_ = INVALID_HANDLE_VALUE;
+    HANDLE stop_event_ = nullptr;
+#else
+    int inotify_fd_ = -1;
+    int wake_fd_ = -1;  // eventfd: Stop() wakes the thread immediately
+#endif
+};
@@ -0,0 +1,289 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "vrto3dlib/trace.hpp"
+
+#ifdef VRTO3D_TRACE
+
+#include "vrto3dlib/debug_log.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vrto3d::trace {
+
+namespace {
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadRing>> rings;
+    Site* sites = nullptr;
+    uint64_t period_begin_ns = input::InputClockNs();
+};
+
+Registry& Reg()
+{
+    static Registry* reg = new Registry;  // outlives every thread_local ring user
+    return *reg;
+}
+
+// Copy of one ring's valid events, oldest first.
+void CopyRing(const ThreadRing& ring, std::vector<Event>& out)
+{
+    constexpr uint64_t n = ThreadRing::kRingEvents;
+    const uint64_t h1 = ring.head.load(std::memory_order_acquire);
+    const uint64_t first = h1 > n ? h1 - n : 0;
+    const size_t base = out.size();
+    for (uint64_t i = first; i < h1; ++i) {
+        out.push_back(ring.events[i & (n - 1)]);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t h2 = ring.head.load(std::memory_order_relaxed);
+    // Slots below h2 - n were overwritten while we copied.
+    const uint64_t valid = h2 > n ? h2 - n : 0;
+    if (valid > first) {
+        const size_t torn = static_cast<size_t>((std::min)(valid, h1) - first);
+        out.erase(out.begin() + base, out.begin() + base + torn);
+    }
+}
+
+void AppendEscaped(std::string& out, const char* s)
+{
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') out += '\\';
+        out += *s;
+    }
+}
+
+struct SummaryThread {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stop = false;
+    std::thread thread;
+
+    ~SummaryThread()
+    {
+        if (thread.joinable()) thread.detach();
+    }
+};
+
+SummaryThread& Summary()
+{
+    static SummaryThread summary;
+    return summary;
+}
+
+}  // namespace
+
+
+ThreadRing* RegisterThread()
+{
+    Registry& reg = Reg();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.rings.push_back(std::make_unique<ThreadRing>());
+    ThreadRing* ring = reg.rings.back().get();
+    ring->tid = static_cast<uint32_t>(reg.rings.size());
+    return ring;
+}
+
+
+Site::Site(const char* site_name, EventKind site_kind) : name(site_name), kind(site_kind)
+{
+    Registry& reg = Reg();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    next = reg.sites;
+    reg.sites = this;
+}
+
+
+std::string ChromeTraceJson()
+{
+    std::vector<std::pair<uint32_t, std::vector<Event>>> threads;
+    {
+        Registry& reg = Reg();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        threads.reserve(reg.rings.size());
+        for (const auto& ring : reg.rings) {
+            threads.emplace_back(ring->tid, std::vector<Event>{});
+            CopyRing(*ring, threads.back().second);
+        }
+    }
+
+    std::string out = "{\"traceEvents\":[";
+    bool first = true;
+    char num[96];
+    for (const auto& [tid, events] : threads) {
+        for (const Event& e : events) {
+            out += first ? "\n" : ",\n";
+            first = false;
+            out += "{\"name\":\"";
+            AppendEscaped(out, e.name);
+            if (e.kind == EventKind::Zone) {
+                std::snprintf(num, sizeof(num), "\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f",
+                              e.ts_ns / 1000.0, e.value / 1000.0);
+                out += num;
+            } else {
+                std::snprintf(num, sizeof(num), "\",\"ph\":\"C\",\"ts\":%.3f,\"args\":{\"value\":%lld}",
+                              e.ts_ns / 1000.0, static_cast<long long>(e.value));
+                out += num;
+            }
+            std::snprintf(num, sizeof(num), ",\"pid\":1,\"tid\":%u}", tid);
+            out += num;
+        }
+    }
+    out += "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return out;
+}
+
+
+bool WriteChromeTrace(const std::string& path)
+{
+    const std::string json = ChromeTraceJson();
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        LOG_WARN() << "Trace: cannot write " << path;
+        return false;
+    }
+    out.write(json.data(), static_cast<std::streamsize>(json.size()));
+    return static_cast<bool>(out);
+}
+
+
+//-----------------------------------------------------------------------------
+// Purpose: Per-name totals since the last summary. Sites sharing a name (the
+//          same macro inlined into several templates) are merged.
+//-----------------------------------------------------------------------------
+void LogSummary()
+{
+    struct Row {
+        const char* name;
+        EventKind kind;
+        uint64_t calls = 0, total_ns = 0, max_ns = 0, set_ns = 0;
+        int64_t value = 0, delta = 0;
+    };
+    std::vector<Row> rows;
+    uint64_t period_ns = 0;
+    {
+        Registry& reg = Reg();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        const uint64_t now = input::InputClockNs();
+        period_ns = now - reg.period_begin_ns;
+        reg.period_begin_ns = now;
+        for (Site* s = reg.sites; s; s = s->next) {
+            const uint64_t calls = s->calls.exchange(0, std::memory_order_relaxed);
+            const uint64_t total = s->total_ns.exchange(0, std::memory_order_relaxed);
+            const uint64_t max = s->max_ns.exchange(0, std::memory_order_relaxed);
+            const int64_t value = s->value.load(std::memory_order_relaxed);
+            const int64_t delta = value - s->reported;
+            s->reported = value;
+            auto it = std::find_if(rows.begin(), rows.end(), [s](const Row& r) {
+                return r.kind == s->kind && std::strcmp(r.name, s->name) == 0;
+            });
+            if (it == rows.end()) {
+                rows.push_back(Row{s->name, s->kind});
+                it = rows.end() - 1;
+            }
+            it->calls += calls;
+            it->total_ns += total;
+            it->max_ns = (std::max)(it->max_ns, max);
+            if (s->kind != EventKind::Gauge) {
+                it->value += value;
+                it->delta += delta;
+            } else {
+                // Gauges do not add up: report the site set most recently,
+                // with its own change since the last summary.
+                const uint64_t set_ns = s->set_ns.load(std::memory_order_relaxed);
+                if (set_ns >= it->set_ns) {
+                    it->set_ns = set_ns;
+                    it->value = value;
+                    it->delta = delta;
+                }
+            }
+        }
+    }
+    std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+        if (a.kind != b.kind) return a.kind < b.kind;
+        return a.total_ns != b.total_ns ? a.total_ns > b.total_ns : std::strcmp(a.name, b.name) < 0;
+    });
+
+    char line[256];
+    LOG() << "Trace summary over " << period_ns / 1000000 << " ms:";
+    for (const Row& r : rows) {
+        if (r.calls == 0) continue;
+        if (r.kind == EventKind::Zone) {
+            std::snprintf(line, sizeof(line), "  %-36s %8llu calls  avg %9.1f us  max %9.1f us  total %8.2f ms",
+                          r.name, static_cast<unsigned long long>(r.calls),
+                          r.total_ns / 1000.0 / r.calls, r.max_ns / 1000.0, r.total_ns / 1e6);
+        } else {
+            std::snprintf(line, sizeof(line), "  %-36s %8lld (%+lld)",
+                          r.name, static_cast<long long>(r.value), static_cast<long long>(r.delta));
+        }
+        LOG() << line;
+    }
+}
+
+
+void StartSummary(std::chrono::milliseconds period)
+{
+    SummaryThread& s = Summary();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (s.thread.joinable()) return;
+    s.stop = false;
+    s.thread = std::thread([&s, period] {
+        std::unique_lock<std::mutex> wake(s.mutex);
+        while (!s.cv.wait_for(wake, period, [&s] { return s.stop; })) {
+            wake.unlock();
+            LogSummary();
+            wake.lock();
+        }
+    });
+}
+
+
+void StopSummary()
+{
+    SummaryThread& s = Summary();
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (!s.thread.joinable()) return;
+        s.stop = true;
+    }
+    s.cv.notify_all();
+    s.thread.join();
+}
+
+}  // namespace vrto3d::trace
+
+#else  // !VRTO3D_TRACE
+
+namespace vrto3d::trace {
+
+std::string ChromeTraceJson() { return "{\"traceEvents\":[]}\n"; }
+bool WriteChromeTrace(const std::string&) { return false; }
+void LogSummary() {}
+void StartSummary(std::chrono::milliseconds) {}
+void StopSummary() {}
+
+}  // namespace vrto3d::trace
+
+#endif  // VRTO3D_TRACE
@@ -0,0 +1,643 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Windows Raw Input backend for vrto3dlib/input_state.h.
+//
+// Same shape as linux_input.cpp: one input thread owns a hidden
+// message-only window registered for keyboard and mouse Raw Input with
+// RIDEV_INPUTSINK (delivered while the game has focus), drains WM_INPUT in
+// batches with GetRawInputBuffer, and folds them into shared state under a
+// mutex. The getters never take that mutex: the VK bitset and cursor are
+// republished through atomics / a seqlock, and edges and typed text go
+// through the SPSC rings in input_ring.h. Gamepads come from the XInput
+// poller in win32_helper.hpp.
+//
+// Raw Input registration is per process and per usage: a later
+// RegisterRawInputDevices for keyboard/mouse elsewhere in vrserver takes the
+// stream away from this window (and Stop() removes ours).
+
+#ifdef _WIN32
+
+#include "vrto3dlib/win32_helper.hpp"   // windows.h, XInputPoller
+#include "vrto3dlib/input_latency.hpp"
+#include "vrto3dlib/input_state.h"
+#include "vrto3dlib/key_codes.h"
+#include "vrto3dlib/trace.hpp"
+#include "input_ring.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vrto3d::input {
+
+namespace {
+
+constexpr wchar_t kWindowClass[] = L"VRto3DRawInputSink";
+constexpr UINT kRawBufferBytes = 64 * 1024;
+
+struct Shared {
+    std::mutex mutex;
+
+    // Per-side VK state; the generic VK_SHIFT/CONTROL/MENU bits are derived.
+    std::bitset<256> down;
+    bool caps_lock = false;  // toggles tracked here: GetKeyState() only
+    bool num_lock = false;   // follows the input queue of the focused thread
+
+    // Virtual mouse cursor, clamped to the SetMouseRegion box.
+    int32_t mouse_x = 0;
+    int32_t mouse_y = 0;
+    int32_t region_w = 0;
+    int32_t region_h = 0;
+    int32_t wheel_remainder = 0;  // high-resolution wheels send < WHEEL_DELTA
+
+    // Timestamps (InputClockNs). Raw Input carries no event time, so these
+    // are taken when the batch is read.
+    uint64_t event_ns = 0;
+    uint64_t edge_ns = 0;
+    uint64_t mouse_ns = 0;
+
+    detail::EdgeQueues queues;
+};
+
+Shared g;
+
+//-----------------------------------------------------------------------------
+// Purpose: Lock-free view read by the getters. Written only with g.mutex
+//          held, so there is a single writer at any time.
+//-----------------------------------------------------------------------------
+struct Published {
+    std::atomic<uint64_t> mouse_xy{0};  // x in the low half, y in the high half
+    std::atomic<int32_t> wheel{0};      // detents since last GetMouseState
+
+    detail::SeqLock seq;
+    std::array<std::atomic<uint64_t>, 4> vk{};  // VK-indexed, incl. generic modifiers
+    std::atomic<uint64_t> edge_ns{0};
+    std::atomic<uint64_t> mouse_ns{0};
+};
+
+Published pub;
+
+std::mutex g_lifecycle_mutex;
+bool g_started = false;
+std::thread g_thread;
+// Written by the input thread, read by Stop() on the caller's thread.
+std::atomic<HWND> g_hwnd{nullptr};
+std::atomic<bool> g_registered{false};
+
+void SetVkBit(int vk, bool down)
+{
+    const uint64_t bit = 1ull << (vk % 64);
+    if (down) {
+        pub.vk[vk / 64].fetch_or(bit, std::memory_order_relaxed);
+    } else {
+        pub.vk[vk / 64].fetch_and(~bit, std::memory_order_relaxed);
+    }
+}
+
+bool VkBit(int vk)
+{
+    return (pub.vk[vk / 64].load(std::memory_order_acquire) >> (vk % 64)) & 1u;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Mirror a key change into the VK bitset, keeping the generic
+//          VK_SHIFT/CONTROL/MENU bits equal to "either side down"
+//-----------------------------------------------------------------------------
+void PublishVkLocked(int vk)
+{
+    g.edge_ns = g.event_ns;
+    pub.seq.Begin();
+    pub.edge_ns.store(g.edge_ns, std::memory_order_relaxed);
+    SetVkBit(vk, g.down[vk]);
+    switch (vk) {
+        case VK_LSHIFT: case VK_RSHIFT:
+            SetVkBit(VK_SHIFT, g.down[VK_LSHIFT] || g.down[VK_RSHIFT]);
+            break;
+        case VK_LCONTROL: case VK_RCONTROL:
+            SetVkBit(VK_CONTROL, g.down[VK_LCONTROL] || g.down[VK_RCONTROL]);
+            break;
+        case VK_LMENU: case VK_RMENU:
+            SetVkBit(VK_MENU, g.down[VK_LMENU] || g.down[VK_RMENU]);
+            break;
+        default:
+            break;
+    }
+    pub.seq.End();
+}
+
+void PublishMouseLocked()
+{
+    const uint64_t xy = static_cast<uint32_t>(g.mouse_x) |
+                        (static_cast<uint64_t>(static_cast<uint32_t>(g.mouse_y)) << 32);
+    pub.seq.Begin();
+    pub.mouse_xy.store(xy, std::memory_order_relaxed);
+    pub.mouse_ns.store(g.mouse_ns, std::memory_order_relaxed);
+    pub.seq.End();
+}
+
+void PushEventLocked(int vk, bool down)
+{
+    KeyEvent e;
+    e.vk = vk;
+    e.down = down;
+    e.time_ns = g.event_ns;
+    g.queues.PushEvent(e);
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Translate a key press into UTF-8 with the foreground layout. This
+//          thread's ToUnicodeEx dead-key state is private to it, so
+//          composition works without disturbing the game's own input queue.
+//-----------------------------------------------------------------------------
+void AppendTypedLocked(int vk, UINT scan)
+{
+    BYTE state[256] = {};
+    for (int i = 0; i < 256; ++i) {
+        state[i] = g.down[i] ? 0x80 : 0;
+    }
+    state[VK_SHIFT] = (g.down[VK_LSHIFT] || g.down[VK_RSHIFT]) ? 0x80 : 0;
+    state[VK_CONTROL] = (g.down[VK_LCONTROL] || g.down[VK_RCONTROL]) ? 0x80 : 0;
+    state[VK_MENU] = (g.down[VK_LMENU] || g.down[VK_RMENU]) ? 0x80 : 0;
+    state[VK_CAPITAL] |= g.caps_lock ? 0x01 : 0;
+    state[VK_NUMLOCK] |= g.num_lock ? 0x01 : 0;
+
+    const HWND fg = GetForegroundWindow();
+    const HKL layout = GetKeyboardLayout(fg ? GetWindowThreadProcessId(fg, nullptr) : 0);
+
+    wchar_t wide[8];
+    const int n = ToUnicodeEx(static_cast<UINT>(vk), scan, state, wide, 8, 0, layout);
+    if (n <= 0) {
+        return;  // no character, or a dead key waiting for the next press
+    }
+    // Skip C0 control characters (Enter/Escape/Backspace map to those);
+    // the OSD handles them as key events, not text.
+    if (n == 1 && (wide[0] < 0x20 || wide[0] == 0x7F)) {
+        return;
+    }
+    char utf8[32];
+    const int len = WideCharToMultiByte(CP_UTF8, 0, wide, n, utf8, sizeof(utf8), nullptr, nullptr);
+    if (len > 0) {
+        g.queues.PushText(utf8, static_cast<size_t>(len));
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Press/release of one side-specific VK (keyboard or mouse button)
+//-----------------------------------------------------------------------------
+void SetKeyLocked(int vk, bool down)
+{
+    if (g.down[vk] == down) {
+        return;
+    }
+    g.down[vk] = down;
+    PublishVkLocked(vk);
+    PushEventLocked(vk, down);
+}
+
+void HandleKeyboardLocked(const RAWKEYBOARD& kb)
+{
+    int vk = kb.VKey;
+    const bool e0 = (kb.Flags & RI_KEY_E0) != 0;
+    const bool down = (kb.Flags & RI_KEY_BREAK) == 0;
+    if (vk <= 0 || vk >= 255) {
+        return;  // 255: filler half of the E1 (Pause) sequence
+    }
+    // Raw Input reports the generic modifier VKs; resolve the side.
+    switch (vk) {
+        case VK_SHIFT:
+            if (e0) {
+                return;  // fake shift the keyboard wraps around NumLock'd nav keys
+            }
+            vk = static_cast<int>(MapVirtualKeyW(kb.MakeCode, MAPVK_VSC_TO_VK_EX));
+            if (vk != VK_LSHIFT && vk != VK_RSHIFT) {
+                vk = VK_LSHIFT;
+            }
+            break;
+        case VK_CONTROL:
+            vk = e0 ? VK_RCONTROL : VK_LCONTROL;
+            break;
+        case VK_MENU:
+            vk = e0 ? VK_RMENU : VK_LMENU;
+            break;
+        default:
+            break;
+    }
+
+    if (down) {
+        if (!g.down[vk]) {
+            if (vk == VK_CAPITAL) g.caps_lock = !g.caps_lock;
+            if (vk == VK_NUMLOCK) g.num_lock = !g.num_lock;
+        }
+        // Autorepeat: no state change, but repeats do generate characters.
+        const UINT scan = kb.MakeCode | (e0 ? 0xE000u : 0u);
+        SetKeyLocked(vk, true);
+        AppendTypedLocked(vk, scan);
+    } else {
+        SetKeyLocked(vk, false);
+    }
+}
+
+void HandleMouseLocked(const RAWMOUSE& m)
+{
+    struct ButtonFlags { USHORT down, up; int vk; };
+    static constexpr ButtonFlags kButtons[] = {
+        { RI_MOUSE_LEFT_BUTTON_DOWN,   RI_MOUSE_LEFT_BUTTON_UP,   VK_LBUTTON },
+        { RI_MOUSE_RIGHT_BUTTON_DOWN,  RI_MOUSE_RIGHT_BUTTON_UP,  VK_RBUTTON },
+        { RI_MOUSE_MIDDLE_BUTTON_DOWN, RI_MOUSE_MIDDLE_BUTTON_UP, VK_MBUTTON },
+        { RI_MOUSE_BUTTON_4_DOWN,      RI_MOUSE_BUTTON_4_UP,      VK_XBUTTON1 },
+        { RI_MOUSE_BUTTON_5_DOWN,      RI_MOUSE_BUTTON_5_UP,      VK_XBUTTON2 },
+    };
+
+    bool moved = false;
+    if (m.usFlags & MOUSE_MOVE_ABSOLUTE) {
+        // Tablets / remote desktop: 0..65535 across the screen, mapped onto
+        // the region like the relative cursor.
+        g.mouse_x = MulDiv(m.lLastX, (std::max<int32_t>)(0, g.region_w - 1), 65535);
+        g.mouse_y = MulDiv(m.lLastY, (std::max<int32_t>)(0, g.region_h - 1), 65535);
+        moved = true;
+    } else if (m.lLastX != 0 || m.lLastY != 0) {
+        g.mouse_x = std::clamp<int32_t>(g.mouse_x + static_cast<int32_t>(m.lLastX), 0,
+                                        (std::max<int32_t>)(0, g.region_w - 1));
+        g.mouse_y = std::clamp<int32_t>(g.mouse_y + static_cast<int32_t>(m.lLastY), 0,
+                                        (std::max<int32_t>)(0, g.region_h - 1));
+        moved = true;
+    }
+
+    const USHORT flags = m.usButtonFlags;
+    for (const ButtonFlags& b : kButtons) {
+        if (flags & (b.down | b.up)) {
+            SetKeyLocked(b.vk, (flags & b.down) != 0);
+        }
+    }
+    if (flags & RI_MOUSE_WHEEL) {
+        g.wheel_remainder += static_cast<SHORT>(m.usButtonData);
+        const int32_t detents = g.wheel_remainder / WHEEL_DELTA;
+        g.wheel_remainder -= detents * WHEEL_DELTA;
+        if (detents != 0) {
+            pub.wheel.fetch_add(detents, std::memory_order_relaxed);
+        }
+    }
+
+    // A button-only packet leaves the position alone but is still mouse
+    // activity, so publish its timestamp too.
+    if (moved || (flags != 0)) {
+        g.mouse_ns = g.event_ns;
+        PublishMouseLocked();
+    }
+}
+
+void HandleRawInputLocked(const RAWINPUT& ri)
+{
+    switch (ri.header.dwType) {
+        case RIM_TYPEKEYBOARD:
+            HandleKeyboardLocked(ri.data.keyboard);
+            break;
+        case RIM_TYPEMOUSE:
+            HandleMouseLocked(ri.data.mouse);
+            break;
+        default:
+            break;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: WM_INPUT: apply this message, then drain everything else queued
+//          with GetRawInputBuffer under the same lock
+//-----------------------------------------------------------------------------
+void HandleWmInput(HRAWINPUT handle)
+{
+    // 8-byte aligned, as GetRawInputBuffer requires.
+    static std::vector<uint64_t> buffer(kRawBufferBytes / sizeof(uint64_t));
+    RAWINPUT* raw = reinterpret_cast<RAWINPUT*>(buffer.data());
+
+    std::lock_guard<std::mutex> lock(g.mutex);
+    g.event_ns = InputClockNs();
+
+    UINT size = kRawBufferBytes;
+    if (GetRawInputData(handle, RID_INPUT, raw, &size, sizeof(RAWINPUTHEADER)) != static_cast<UINT>(-1)) {
+        HandleRawInputLocked(*raw);
+    }
+
+    for (;;) {
+        UINT bytes = kRawBufferBytes;
+        const UINT count = GetRawInputBuffer(raw, &bytes, sizeof(RAWINPUTHEADER));
+        if (count == 0 || count == static_cast<UINT>(-1)) {
+            break;
+        }
+        const RAWINPUT* it = raw;
+        for (UINT i = 0; i < count; ++i) {
+            HandleRawInputLocked(*it);
+            it = NEXTRAWINPUTBLOCK(it);
+        }
+    }
+}
+
+LRESULT CALLBACK SinkWndProc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
+{
+    switch (msg) {
+        case WM_INPUT:
+            HandleWmInput(reinterpret_cast<HRAWINPUT>(lparam));
+            break;  // DefWindowProc still runs for RIM_INPUT cleanup
+        case WM_CLOSE:
+            DestroyWindow(hwnd);
+            return 0;
+        case WM_DESTROY:
+            PostQuitMessage(0);
+            return 0;
+        default:
+            break;
+    }
+    return DefWindowProcW(hwnd, msg, wparam, lparam);
+}
+
+bool RegisterDevices(HWND hwnd, bool remove)
+{
+    RAWINPUTDEVICE rid[2] = {};
+    rid[0].usUsagePage = 0x01;  // generic desktop
+    rid[0].usUsage = 0x06;      // keyboard
+    rid[1].usUsagePage = 0x01;
+    rid[1].usUsage = 0x02;      // mouse
+    for (RAWINPUTDEVICE& d : rid) {
+        d.dwFlags = remove ? RIDEV_REMOVE : RIDEV_INPUTSINK;
+        d.hwndTarget = remove ? nullptr : hwnd;
+    }
+    return RegisterRawInputDevices(rid, 2, sizeof(RAWINPUTDEVICE)) != FALSE;
+}
+
+//-----------------------------------------------------------------------------
+// Purpose: Input thread: owns the sink window and pumps its messages
+//-----------------------------------------------------------------------------
+void InputThread(std::promise<bool> ready)
+{
+    const HINSTANCE instance = GetModuleHandleW(nullptr);
+    WNDCLASSEXW wc = {};
+    wc.cbSize = sizeof(wc);
+    wc.lpfnWndProc = SinkWndProc;
+    wc.hInstance = instance;
+    wc.lpszClassName = kWindowClass;
+    RegisterClassExW(&wc);  // fails harmlessly if a previous Start() registered it
+
+    const HWND hwnd = CreateWindowExW(0, kWindowClass, L"", 0, 0, 0, 0, 0,
+                                      HWND_MESSAGE, nullptr, instance, nullptr);
+    if (!hwnd) {
+        LOG() << "input: CreateWindowEx(HWND_MESSAGE) failed: " << GetLastError();
+        ready.set_value(false);
+        return;
+    }
+    if (!RegisterDevices(hwnd, false)) {
+        LOG() << "input: RegisterRawInputDevices failed: " << GetLastError();
+        DestroyWindow(hwnd);
+        ready.set_value(false);
+        return;
+    }
+    g_hwnd.store(hwnd, std::memory_order_release);
+    g_registered.store(true, std::memory_order_relaxed);
+    ready.set_value(true);
+
+    MSG msg;
+    while (GetMessageW(&msg, nullptr, 0, 0) > 0) {
+        TranslateMessage(&msg);
+        DispatchMessageW(&msg);
+    }
+    RegisterDevices(nullptr, true);
+    g_registered.store(false, std::memory_order_relaxed);
+    g_hwnd.store(nullptr, std::memory_order_release);
+}
+
+}  // namespace
+
+void Configure(const InputOptions& options)
+{
+    // Coalescing, rate cap and device classes are evdev concepts; Raw Input
+    // is already drained in batches and only keyboard/mouse are registered.
+    (void)options;
+}
+
+bool Start()
+{
+    std::lock_guard<std::mutex> lifecycle(g_lifecycle_mutex);
+    if (g_started) {
+        return PermissionOk();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(g.mutex);
+        g.caps_lock = (GetKeyState(VK_CAPITAL) & 1) != 0;
+        g.num_lock = (GetKeyState(VK_NUMLOCK) & 1) != 0;
+    }
+
+    std::promise<bool> ready;
+    std::future<bool> registered = ready.get_future();
+    g_thread = std::thread(InputThread, std::move(ready));
+    if (!registered.get()) {
+        g_thread.join();
+        LOG() << "input: Raw Input unavailable; hotkeys fall back to GetAsyncKeyState";
+        return false;
+    }
+    g_started = true;
+    return true;
+}
+
+void Stop()
+{
+    std::lock_guard<std::mutex> lifecycle(g_lifecycle_mutex);
+    if (!g_started) {
+        return;
+    }
+    if (const HWND hwnd = g_hwnd.load(std::memory_order_acquire)) {
+        PostMessageW(hwnd, WM_CLOSE, 0, 0);
+    }
+    if (g_thread.joinable()) {
+        g_thread.join();
+    }
+
+    std::lock_guard<std::mutex> lock(g.mutex);
+    g.down.reset();
+    g.wheel_remainder = 0;
+    // g.queues stays as is; see the Linux backend's Stop().
+    pub.wheel.store(0, std::memory_order_relaxed);
+    pub.seq.Begin();
+    for (auto& word : pub.vk) {
+        word.store(0, std::memory_order_relaxed);
+    }
+    pub.seq.End();
+    g_started = false;
+}
+
+bool PermissionOk()
+{
+    return g_registered.load(std::memory_order_relaxed);
+}
+
+bool IsKeyDown(int vk)
+{
+    return vk >= 0 && vk < 256 && VkBit(vk);
+}
+
+bool IsCtrlDown()
+{
+    return IsKeyDown(VK_CONTROL);
+}
+
+GamepadState GetGamepadState()
+{
+    VRTO3D_TRACE_ZONE("input.GetGamepadState");
+    return GetXInputGamepadState();
+}
+
+uint32_t GetConnectedPads()
+{
+    uint32_t mask = 0;
+    for (int slot = 0; slot < kMaxPads; ++slot) {
+        if (GetXInputGamepadState(static_cast<DWORD>(slot)).connected) mask |= 1u << slot;
+    }
+    return mask;
+}
+
+GamepadState GetPadState(int slot)
+{
+    return slot >= 0 && slot < kMaxPads ? GetXInputGamepadState(static_cast<DWORD>(slot))
+                                        : GamepadState{};
+}
+
+std::string GetPadName(int slot)
+{
+    // XInput exposes no product names; the slot is the player index.
+    return GetPadState(slot).connected ? "XInput " + std::to_string(slot + 1) : std::string();
+}
+
+GamepadState SamplePad(int slot, uint64_t t_ns)
+{
+    VRTO3D_TRACE_ZONE("input.SamplePad");
+    const PadHistory* history = slot >= 0 ? GetXInputPoller().History(static_cast<DWORD>(slot)) : nullptr;
+    return history ? history->At(t_ns) : GamepadState{};
+}
+
+uint64_t PadReportIntervalNs(int slot)
+{
+    const PadHistory* history = slot >= 0 ? GetXInputPoller().History(static_cast<DWORD>(slot)) : nullptr;
+    return history ? history->IntervalNs() : 0;
+}
+
+int GetPadHistory(int slot, GamepadState* out, int max_samples)
+{
+    const PadHistory* history = slot >= 0 ? GetXInputPoller().History(static_cast<DWORD>(slot)) : nullptr;
+    return history ? history->Copy(out, max_samples) : 0;
+}
+
+void Snapshot(InputFrame& out)
+{
+    VRTO3D_TRACE_ZONE("input.Snapshot");
+    uint64_t vk[4];
+    uint64_t xy = 0;
+    uint64_t edge_ns = 0;
+    uint64_t mouse_ns = 0;
+    pub.seq.Read([&] {
+        for (size_t i = 0; i < 4; ++i) {
+            vk[i] = pub.vk[i].load(std::memory_order_relaxed);
+        }
+        xy = pub.mouse_xy.load(std::memory_order_relaxed);
+        edge_ns = pub.edge_ns.load(std::memory_order_relaxed);
+        mouse_ns = pub.mouse_ns.load(std::memory_order_relaxed);
+    });
+
+    detail::ExpandVkWords(vk, out.keys);
+    out.pad = GetXInputGamepadState();
+    out.mouse = MouseState{};
+    out.mouse.x = static_cast<int32_t>(static_cast<uint32_t>(xy));
+    out.mouse.y = static_cast<int32_t>(static_cast<uint32_t>(xy >> 32));
+    out.mouse.left = out.keys[VK_LBUTTON];
+    out.mouse.right = out.keys[VK_RBUTTON];
+    out.mouse.middle = out.keys[VK_MBUTTON];
+    out.mouse.x1 = out.keys[VK_XBUTTON1];
+    out.mouse.x2 = out.keys[VK_XBUTTON2];
+    out.mouse.time_ns = mouse_ns;
+    out.edge_time_ns = edge_ns;
+    out.pending_key_events = static_cast<int>(g.queues.events.Size());
+}
+
+MouseState GetMouseState()
+{
+    VRTO3D_TRACE_ZONE("input.GetMouseState");
+    MouseState ms;
+    const uint64_t xy = pub.mouse_xy.load(std::memory_order_relaxed);
+    ms.x = static_cast<int32_t>(static_cast<uint32_t>(xy));
+    ms.y = static_cast<int32_t>(static_cast<uint32_t>(xy >> 32));
+    ms.wheel = pub.wheel.exchange(0, std::memory_order_relaxed);  // detents since last call
+    ms.left = VkBit(VK_LBUTTON);
+    ms.right = VkBit(VK_RBUTTON);
+    ms.middle = VkBit(VK_MBUTTON);
+    ms.x1 = VkBit(VK_XBUTTON1);
+    ms.x2 = VkBit(VK_XBUTTON2);
+    ms.time_ns = pub.mouse_ns.load(std::memory_order_relaxed);
+    return ms;
+}
+
+void SetMouseRegion(int32_t width, int32_t height)
+{
+    std::lock_guard<std::mutex> lock(g.mutex);
+    width = (std::max<int32_t>)(width, 1);
+    height = (std::max<int32_t>)(height, 1);
+    if (width == g.region_w && height == g.region_h) {
+        return;
+    }
+    const bool first = (g.region_w == 0);
+    g.region_w = width;
+    g.region_h = height;
+    if (first) {
+        g.mouse_x = width / 2;  // start centered
+        g.mouse_y = height / 2;
+    } else {
+        g.mouse_x = std::clamp<int32_t>(g.mouse_x, 0, width - 1);
+        g.mouse_y = std::clamp<int32_t>(g.mouse_y, 0, height - 1);
+    }
+    PublishMouseLocked();
+}
+
+void WarpMouse(int32_t x, int32_t y)
+{
+    std::lock_guard<std::mutex> lock(g.mutex);
+    g.mouse_x = std::clamp<int32_t>(x, 0, (std::max<int32_t>)(0, g.region_w - 1));
+    g.mouse_y = std::clamp<int32_t>(y, 0, (std::max<int32_t>)(0, g.region_h - 1));
+    PublishMouseLocked();
+}
+
+int DrainKeyEvents(KeyEvent* out, int max_events)
+{
+    VRTO3D_TRACE_ZONE("input.DrainKeyEvents");
+    return g.queues.DrainEvents(out, max_events);
+}
+
+int DrainTypedUtf8(char* out, int out_size)
+{
+    return g.queues.DrainText(out, out_size);
+}
+
+InputStats GetInputStats()
+{
+    return g.queues.Stats();
+}
+
+}  // namespace vrto3d::input
+
+#endif  // _WIN32
@@ -0,0 +1,105 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// DebugLog::InstallCrashHooks() must hand a crash on to the handler the host
+// installed before it (SA_SIGINFO, as Breakpad uses) and then let the signal
+// end the process. A kill -ABRT, which does not re-fault on return, has to
+// terminate it as well, and the logged lines must reach the file.
+
+#include "test_support.h"
+
+#include "vrto3dlib/linux_helper.hpp"
+#include "vrto3dlib/debug_log.hpp"
+
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+int g_marker_fd = -1;
+
+void HostHandler(int, siginfo_t* info, void*)
+{
+    const char mark = info ? 'S' : '?';
+    (void)!write(g_marker_fd, &mark, 1);
+}
+
+[[noreturn]] void Child()
+{
+    struct sigaction host {};
+    host.sa_sigaction = &HostHandler;
+    host.sa_flags = SA_SIGINFO;
+    sigemptyset(&host.sa_mask);
+    sigaction(SIGABRT, &host, nullptr);
+
+    if (!DebugLog::StartAsync()) _exit(2);
+    DebugLog::InstallCrashHooks();
+    LOG() << "before crash";
+    kill(getpid(), SIGABRT);
+    _exit(3);  // the hooks swallowed the signal
+}
+
+}  // namespace
+
+int main()
+{
+    char dir_template[] = "/tmp/vrto3d_test_log_XXXXXX";
+    const char* dir = mkdtemp(dir_template);
+    CHECK(dir != nullptr);
+    if (!dir) return vrto3d::test::TestResult();
+    const std::string steam = dir;
+    mkdir((steam + "/config").c_str(), 0700);
+    mkdir((steam + "/logs").c_str(), 0700);
+    setenv("STEAM_DIR", steam.c_str(), 1);
+
+    int marker[2];
+    CHECK(pipe(marker) == 0);
+    const pid_t pid = fork();
+    if (pid == 0) {
+        close(marker[0]);
+        g_marker_fd = marker[1];
+        Child();
+    }
+    close(marker[1]);
+
+    int status = 0;
+    CHECK(pid > 0 && waitpid(pid, &status, 0) == pid);
+    CHECK(WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT);
+
+    char mark = 0;
+    CHECK(read(marker[0], &mark, 1) == 1 && mark == 'S');
+    close(marker[0]);
+
+    std::ifstream log(steam + "/logs/vrto3d.txt");
+    std::stringstream text;
+    text << log.rdbuf();
+    CHECK(text.str().find("before crash") != std::string::npos);
+
+    std::remove((steam + "/logs/vrto3d.txt").c_str());
+    std::remove((steam + "/logs/.vrto3d.rotated").c_str());
+    rmdir((steam + "/logs").c_str());
+    rmdir((steam + "/config").c_str());
+    rmdir(dir);
+    return vrto3d::test::TestResult();
+}
@@ -0,0 +1,105 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// The compiled hotkey table must follow edits of the user_* rows: storing a
+// new preset into an existing row keeps num_user_settings unchanged, so only
+// user_settings_generation tells the evaluator its table is stale.
+
+#include "test_support.h"
+
+#include "vrto3dlib/hotkey_eval.hpp"
+
+namespace {
+
+struct Display {
+    float depth = 0.0f, conv = 0.0f, fov = 90.0f;
+    float getDepth() const { return depth; }
+    float getConv() const { return conv; }
+    float getFov() const { return fov; }
+    void setDepth(float v) { depth = v; }
+    void setConv(float v) { conv = v; }
+    void setFov(float v) { fov = v; }
+};
+
+// One SWITCH row on Numpad1 with a single preset.
+StereoDisplayDriverConfiguration MakeConfig()
+{
+    StereoDisplayDriverConfiguration cfg;
+    cfg.num_user_settings = 1;
+    cfg.user_load_key = { VK_NUMPAD1 };
+    cfg.user_load_str = { "VK_NUMPAD1" };
+    cfg.user_key_type = { SWITCH };
+    cfg.user_type_str = { "switch" };
+    cfg.user_depth = { { 0.1f } };
+    cfg.user_convergence = { { 1.0f } };
+    cfg.user_fov = { { 0.0f } };
+    cfg.user_preset_index = { 0 };
+    cfg.prev_depth = { 0.0f };
+    cfg.prev_convergence = { 0.0f };
+    cfg.prev_fov = { 0.0f };
+    cfg.was_held = { false };
+    cfg.load_xinput = { false };
+    cfg.sleep_count = { 0 };
+    cfg.sleep_count_max = 0;
+    cfg.fov = 90.0f;
+    return cfg;
+}
+
+// Release then press the row's key, one frame each.
+void Tap(StereoDisplayDriverConfiguration& cfg, vrto3d::input::InputFrame& frame, Display& display)
+{
+    frame.keys.reset(VK_NUMPAD1);
+    vrto3d::ApplyUserSettingsHotkeysImpl(cfg, frame, display);
+    frame.keys.set(VK_NUMPAD1);
+    vrto3d::ApplyUserSettingsHotkeysImpl(cfg, frame, display);
+}
+
+}  // namespace
+
+int main()
+{
+    StereoDisplayDriverConfiguration cfg = MakeConfig();
+    vrto3d::CompileHotkeyTable(cfg);
+    Display display;
+    vrto3d::input::InputFrame frame;
+
+    Tap(cfg, frame, display);
+    CHECK(display.depth == 0.1f);
+
+    // Store a preset into the row, as the driver's preset-save hotkey does.
+    cfg.user_depth[0][0] = 0.25f;
+    cfg.user_convergence[0][0] = 2.0f;
+    ++cfg.user_settings_generation;
+    Tap(cfg, frame, display);
+    CHECK(display.depth == 0.25f);
+    CHECK(display.conv == 2.0f);
+    CHECK(cfg.hotkey_table.compiled);
+    CHECK(cfg.hotkey_table.source_generation == cfg.user_settings_generation);
+
+    // A rebind is picked up the same way: the old key no longer fires.
+    cfg.user_load_key[0] = VK_NUMPAD2;
+    cfg.user_depth[0][0] = 0.5f;
+    ++cfg.user_settings_generation;
+    Tap(cfg, frame, display);
+    CHECK(display.depth == 0.25f);
+    frame.keys.reset(VK_NUMPAD1);
+    frame.keys.set(VK_NUMPAD2);
+    vrto3d::ApplyUserSettingsHotkeysImpl(cfg, frame, display);
+    CHECK(display.depth == 0.5f);
+
+    return vrto3d::test::TestResult();
+}
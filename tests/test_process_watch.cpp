@@ -0,0 +1,85 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// ProcessWatch::Unwatch() must not return while the watch's callback is
+// still running on the watch thread, and Stop() must leave the instance
+// reusable.
+
+#include "test_support.h"
+
+#include "vrto3dlib/process_watch.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+// A child that exits at once; reaped by the caller.
+pid_t SpawnExiting()
+{
+    const pid_t pid = fork();
+    if (pid == 0) _exit(0);
+    return pid;
+}
+
+template <typename Pred>
+bool WaitFor(Pred pred)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+}  // namespace
+
+int main()
+{
+    ProcessWatch watch;
+    std::atomic<bool> started{false};
+    std::atomic<bool> finished{false};
+
+    const pid_t child = SpawnExiting();
+    CHECK(child > 0);
+    CHECK(watch.Watch(static_cast<uint32_t>(child), [&](uint32_t) {
+        started = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        finished = true;
+    }));
+    CHECK(WaitFor([&] { return started.load(); }));
+
+    watch.Unwatch(static_cast<uint32_t>(child));
+    CHECK(finished.load());
+    waitpid(child, nullptr, 0);
+
+    // After Stop() a new watch starts a fresh thread and still fires.
+    watch.Stop();
+    std::atomic<int> fired{0};
+    const pid_t second = SpawnExiting();
+    CHECK(watch.Watch(static_cast<uint32_t>(second), [&](uint32_t) { ++fired; }));
+    CHECK(WaitFor([&] { return fired.load() == 1; }));
+    waitpid(second, nullptr, 0);
+    watch.Stop();
+
+    return vrto3d::test::TestResult();
+}
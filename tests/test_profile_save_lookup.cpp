@@ -0,0 +1,64 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// A profile saved through the debounced async writer must be visible to
+// HasProfile() right away, with or without the folder watch running: the
+// lookup waits out the pending write the same way LoadProfileFromJson() does.
+
+#include "test_support.h"
+
+#include "vrto3dlib/json_manager.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+#include <unistd.h>
+
+int main()
+{
+    namespace fs = std::filesystem;
+
+    char dir_template[] = "/tmp/vrto3d_test_profiles_XXXXXX";
+    const char* dir = mkdtemp(dir_template);
+    CHECK(dir != nullptr);
+    if (!dir) return vrto3d::test::TestResult();
+    fs::create_directories(fs::path(dir) / "config");
+    setenv("STEAM_DIR", dir, 1);
+
+    {
+        JsonManager json;
+        json.EnsureDefaultConfigExists();
+        StereoDisplayDriverConfiguration cfg;
+        json.LoadParamsFromJson(cfg);
+        CHECK(json.LoadProfileFromJson("default_config.json", cfg));
+
+        CHECK(!json.HasProfile("unwatched.json"));
+        json.SaveProfileToJson("unwatched.json", cfg);
+        CHECK(json.HasProfile("unwatched.json"));
+
+        CHECK(json.StartProfileWatch());
+        CHECK(!json.HasProfile("watched.json"));
+        json.SaveProfileToJson("watched.json", cfg);
+        CHECK(json.HasProfile("watched.json"));
+        CHECK(json.LoadProfileFromJson("watched.json", cfg));
+    }
+
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+    return vrto3d::test::TestResult();
+}
@@ -0,0 +1,51 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+// Minimal checks for the test executables: CHECK() reports and counts a
+// failure without stopping, TestResult() turns the count into main()'s
+// exit code.
+
+#include <cstdio>
+
+namespace vrto3d::test {
+
+inline int& Failures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+inline int TestResult()
+{
+    if (Failures() != 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", Failures());
+        return 1;
+    }
+    return 0;
+}
+
+}  // namespace vrto3d::test
+
+#define CHECK(cond)                                                              \
+    do {                                                                         \
+        if (!(cond)) {                                                           \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, \
+                         #cond);                                                 \
+            ++::vrto3d::test::Failures();                                        \
+        }                                                                        \
+    } while (0)
@@ -0,0 +1,124 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Receiver::wait_for_command() runs on its own thread so a command wakes it
+// while the frame thread is stalled. The frame thread dropping its mapping
+// (shutdown(), or cleanup() from update()/snapshot()) must not pull the
+// mapping out from under a blocked wait, and the doorbell must still wake it.
+
+#include "test_support.h"
+
+#include "vrto3dlib/uevr_receiver.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+// Creates `path` at `size` bytes and maps it; nullptr on failure.
+void* CreateBlock(const std::string& path, size_t size)
+{
+    const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) return nullptr;
+    void* view = nullptr;
+    if (ftruncate(fd, static_cast<off_t>(size)) == 0) {
+        view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (view == MAP_FAILED) view = nullptr;
+    }
+    close(fd);
+    if (view) std::memset(view, 0, size);
+    return view;
+}
+
+// What UEVR does for a depth command with the v4.3 doorbell.
+void RingCommand(UE3D_SharedData* d, uint8_t request)
+{
+    d->auto_depth_request = request;
+    ue3d_command_word(d).fetch_add(1, std::memory_order_release);
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&ue3d_command_word(d)),
+            FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+
+}  // namespace
+
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    char dir_template[] = "/tmp/vrto3d_test_cmd_XXXXXX";
+    const char* dir = mkdtemp(dir_template);
+    CHECK(dir != nullptr);
+    if (!dir) return vrto3d::test::TestResult();
+
+    const std::string base = std::string(dir) + "/UE3D_SharedData";
+    setenv("UE3D_SHM_PATH", base.c_str(), 1);
+
+    auto* d = static_cast<UE3D_SharedData*>(CreateBlock(base, sizeof(UE3D_SharedData)));
+    CHECK(d != nullptr);
+    if (!d) return vrto3d::test::TestResult();
+    d->magic = UE3D_MAGIC;
+    d->version = UE3D_VERSION;
+    d->struct_size = UE3D_STRUCT_SIZE;
+    d->flags = UE3D_FLAG_COMMAND_DOORBELL;
+
+    auto& rx = uevr::Receiver::instance();
+    CHECK(rx.init());
+    CHECK(rx.has_command_doorbell());
+
+    // The frame thread detaches while the command thread is blocked; the
+    // command rung afterwards must still wake the wait, well before timeout.
+    std::atomic<bool> woke{false};
+    std::atomic<int64_t> waited_ms{-1};
+    std::thread waiter([&] {
+        const auto start = Clock::now();
+        woke = rx.wait_for_command(5000);
+        waited_ms = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    rx.shutdown();
+    CHECK(!rx.is_connected());
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    RingCommand(d, 2);
+    waiter.join();
+    CHECK(woke);
+    CHECK(waited_ms >= 0 && waited_ms < 2000);
+
+    // A pending command keeps reporting true until acknowledged.
+    CHECK(rx.wait_for_command(0));
+
+    // Once the writer is gone, a fresh wait fails at once.
+    rx.release_command_wait();
+    d->magic = 0;
+    const auto start = Clock::now();
+    CHECK(!rx.wait_for_command(1000));
+    CHECK(Clock::now() - start < std::chrono::milliseconds(500));
+
+    munmap(d, sizeof(UE3D_SharedData));
+    unlink(base.c_str());
+    rmdir(dir);
+    return vrto3d::test::TestResult();
+}
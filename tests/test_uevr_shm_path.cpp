@@ -0,0 +1,103 @@
+/*
+ * This file is part of VRto3D.
+ *
+ * VRto3D is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * VRto3D is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with VRto3D. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// UE3D_SHM_PATH must place every UE3D block, not just the ones whose mapping
+// name extends UE3D_SHMEM_NAME: the Leia eye ring has to attach from
+// "<path>.UE3D_LeiaEyeRing" rather than falling back to the v4 file.
+
+#include "test_support.h"
+
+#include "vrto3dlib/uevr_receiver.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+// Creates `path` at `size` bytes and maps it; nullptr on failure.
+void* CreateBlock(const std::string& path, size_t size)
+{
+    const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) return nullptr;
+    void* view = nullptr;
+    if (ftruncate(fd, static_cast<off_t>(size)) == 0) {
+        view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (view == MAP_FAILED) view = nullptr;
+    }
+    close(fd);
+    if (view) std::memset(view, 0, size);
+    return view;
+}
+
+}  // namespace
+
+int main()
+{
+    char dir_template[] = "/tmp/vrto3d_test_shm_XXXXXX";
+    const char* dir = mkdtemp(dir_template);
+    CHECK(dir != nullptr);
+    if (!dir) return vrto3d::test::TestResult();
+
+    const std::string base = std::string(dir) + "/UE3D_SharedData";
+    setenv("UE3D_SHM_PATH", base.c_str(), 1);
+
+    CHECK(uevr::detail::ShmOverridePath(UE3D_SHMEM_NAME) == base);
+    CHECK(uevr::detail::ShmOverridePath(UE3D_V5_SHMEM_NAME) == base + "_v5");
+    CHECK(uevr::detail::ShmOverridePath(UE3D_LEIA_RING_NAME) == base + ".UE3D_LeiaEyeRing");
+
+    // The v4 file is present too, so a lookup that ignored the ring's own
+    // name would find a block too small to be the ring.
+    const std::string ring_path = uevr::detail::ShmOverridePath(UE3D_LEIA_RING_NAME);
+    void* v4 = CreateBlock(base, sizeof(UE3D_SharedData));
+    auto* ring = static_cast<UE3D_LeiaEyeRing*>(CreateBlock(ring_path, sizeof(UE3D_LeiaEyeRing)));
+    CHECK(v4 != nullptr);
+    CHECK(ring != nullptr);
+
+    if (ring) {
+        ring->magic = UE3D_LEIA_RING_MAGIC;
+        ring->version = UE3D_LEIA_RING_VERSION;
+        ring->struct_size = sizeof(UE3D_LeiaEyeRing);
+        ring->slot_count = UE3D_LEIA_RING_SLOTS;
+        UE3D_LeiaEyeSlot& slot = ring->slots[0];
+        slot.tracking_active = 1;
+        slot.timestamp_ns = uevr::detail::TickNs();
+        slot.left_eye_x = -31.0f;
+        slot.right_eye_x = 31.0f;
+        slot.left_eye_z = slot.right_eye_z = 600.0f;
+        ring->head = 1;
+
+        // No v4 snapshot was taken, so only the ring can supply this sample.
+        uevr::EyePose pose{};
+        const bool ok = uevr::Receiver::instance().predict_eyes(slot.timestamp_ns, pose);
+        CHECK(ok);
+        CHECK(pose.left[0] == -31.0f);
+        CHECK(pose.right[0] == 31.0f);
+        CHECK(pose.sample_ns == slot.timestamp_ns);
+    }
+
+    if (ring) munmap(ring, sizeof(UE3D_LeiaEyeRing));
+    if (v4) munmap(v4, sizeof(UE3D_SharedData));
+    unlink(ring_path.c_str());
+    unlink(base.c_str());
+    rmdir(dir);
+    return vrto3d::test::TestResult();
+}